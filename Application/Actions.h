@@ -2,140 +2,237 @@
 #include "IAction.h"
 #include "../Model/Slide.h"
 #include "../Model/IShape.h"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace Application {
 
-    class RemoveSlideAction;
-    class RemoveShapeAction;
-    class AddShapeAction;
-
     class RemoveSlideAction : public IAction {
         size_t position_;
-        std::unique_ptr<Model::Slide> removedSlide_;
 
     public:
         explicit RemoveSlideAction(size_t position) : position_(position) {
         }
 
-        std::unique_ptr<IAction> execute(Model::Presentation* presentation) override;
+        bool execute(Model::Presentation* presentation) override {
+            if (!presentation || position_ >= presentation->slideCount()) {
+                return false;
+            }
+
+            presentation->removeSlide(position_);
+            return true;
+        }
     };
 
     class AddSlideAction : public IAction {
-        std::unique_ptr<Model::Slide> slide_;
+        std::shared_ptr<Model::Slide> slide_;
         size_t position_;
         bool hasPosition_;
 
     public:
-        AddSlideAction(std::unique_ptr<Model::Slide> slide, size_t position = static_cast<size_t>(-1), bool hasPosition = false)
+        AddSlideAction(std::shared_ptr<Model::Slide> slide, size_t position = static_cast<size_t>(-1), bool hasPosition = false)
             : slide_(std::move(slide)), position_(position), hasPosition_(hasPosition) {
         }
 
-        std::unique_ptr<IAction> execute(Model::Presentation* presentation) override {
-            if (!presentation) {
-                return nullptr;
+        bool execute(Model::Presentation* presentation) override {
+            if (!presentation || !slide_) {
+                return false;
             }
 
-            size_t actualPosition = 0;
             if (hasPosition_) {
-                size_t slideCount = presentation->slideCount();
-                if (position_ > slideCount) {
-
-                    actualPosition = slideCount;
-                    presentation->addSlide(std::move(slide_), position_);
-                }
-                else {
-                    actualPosition = position_;
-                    presentation->addSlide(std::move(slide_), position_);
-                }
+                presentation->addSlide(std::move(slide_), position_);
             }
             else {
-                actualPosition = presentation->slideCount();
                 presentation->addSlide(std::move(slide_));
             }
-
-            return std::make_unique<RemoveSlideAction>(actualPosition);
+            return true;
         }
     };
 
-    inline std::unique_ptr<IAction> RemoveSlideAction::execute(Model::Presentation* presentation) {
-        if (!presentation || position_ >= presentation->slideCount()) {
-            return nullptr;
-        }
+    // Puts the slide removed from one position back at another, so it keeps
+    // its id and the ids of its shapes
+    class MoveSlideAction : public IAction {
+        size_t from_;
+        size_t to_;
 
-        Model::Slide* slidePtr = presentation->getSlide(position_);
-        removedSlide_ = slidePtr->clone();
+    public:
+        MoveSlideAction(size_t from, size_t to) : from_(from), to_(to) {
+        }
 
-        presentation->removeSlide(position_);
+        bool execute(Model::Presentation* presentation) override {
+            if (!presentation || from_ >= presentation->slideCount() || to_ >= presentation->slideCount()) {
+                return false;
+            }
 
-        return std::make_unique<AddSlideAction>(std::move(removedSlide_), position_, true);
-    }
+            presentation->addSlide(presentation->removeSlide(from_), to_);
+            return true;
+        }
+    };
 
+    // Shape edits name the shape by id, so they find it again wherever
+    // earlier edits have moved it in the z-order. Those that take a group's
+    // id act on the group as a whole.
     class RemoveShapeAction : public IAction {
-        size_t slideIndex_;
-        size_t shapeIndex_;
-        std::unique_ptr<Model::IShape> removedShape_;
+        std::uint64_t shapeId_;
 
     public:
-        RemoveShapeAction(size_t slideIndex, size_t shapeIndex)
-            : slideIndex_(slideIndex), shapeIndex_(shapeIndex) {
+        explicit RemoveShapeAction(std::uint64_t shapeId) : shapeId_(shapeId) {
         }
 
-        std::unique_ptr<IAction> execute(Model::Presentation* presentation) override;
+        bool execute(Model::Presentation* presentation) override {
+            size_t slideIndex = 0, index = 0;
+            if (!presentation) {
+                return false;
+            }
+            if (presentation->findShape(shapeId_, slideIndex, index)) {
+                presentation->getSlide(slideIndex)->removeShapeAt(index);
+                return true;
+            }
+            if (presentation->findGroup(shapeId_, slideIndex, index)) {
+                presentation->getSlide(slideIndex)->removeGroup(index);
+                return true;
+            }
+            return false;
+        }
     };
 
-    class AddShapeAction : public IAction {
-        size_t slideIndex_;
-        std::unique_ptr<Model::IShape> shape_;
-        bool toFront_;
-        size_t actualShapeIndex_;
+    class MoveShapeAction : public IAction {
+        std::uint64_t shapeId_;
+        int dx_;
+        int dy_;
 
     public:
-        AddShapeAction(size_t slideIndex, std::unique_ptr<Model::IShape> shape, bool toFront = false)
-            : slideIndex_(slideIndex), shape_(std::move(shape)), toFront_(toFront), actualShapeIndex_(0) {
+        MoveShapeAction(std::uint64_t shapeId, int dx, int dy) : shapeId_(shapeId), dx_(dx), dy_(dy) {
         }
 
-        std::unique_ptr<IAction> execute(Model::Presentation* presentation) override {
-            if (!presentation || slideIndex_ >= presentation->slideCount()) {
-                return nullptr;
+        bool execute(Model::Presentation* presentation) override {
+            size_t slideIndex = 0, index = 0;
+            if (!presentation) {
+                return false;
             }
+            if (presentation->findShape(shapeId_, slideIndex, index)) {
+                presentation->getSlide(slideIndex)->translateShape(index, dx_, dy_);
+                return true;
+            }
+            if (presentation->findGroup(shapeId_, slideIndex, index)) {
+                presentation->getSlide(slideIndex)->translateGroup(index, dx_, dy_);
+                return true;
+            }
+            return false;
+        }
+    };
 
-            Model::Slide* slide = presentation->getSlide(slideIndex_);
-            size_t originalCount = slide->shapeCount();
+    enum class Restack {
+        BRING_TO_FRONT,
+        SEND_TO_BACK,
+        RAISE,
+        LOWER
+    };
 
-            slide->addShape(std::move(shape_));
+    // Fails, leaving no history, if the shape or group is already at that
+    // end of its group, or of the slide
+    class RestackShapeAction : public IAction {
+        std::uint64_t shapeId_;
+        Restack move_;
 
-            actualShapeIndex_ = originalCount;
+    public:
+        RestackShapeAction(std::uint64_t shapeId, Restack move) : shapeId_(shapeId), move_(move) {
+        }
 
-            if (toFront_ && actualShapeIndex_ < slide->shapeCount()) {
-                slide->bringToFront(actualShapeIndex_);
-                actualShapeIndex_ = slide->shapeCount() - 1;
+        bool execute(Model::Presentation* presentation) override {
+            size_t slideIndex = 0, index = 0;
+            if (!presentation) {
+                return false;
+            }
+            if (presentation->findShape(shapeId_, slideIndex, index)) {
+                Model::Slide* slide = presentation->getSlide(slideIndex);
+                switch (move_) {
+                case Restack::BRING_TO_FRONT: return slide->bringToFront(index);
+                case Restack::SEND_TO_BACK: return slide->sendToBack(index);
+                case Restack::RAISE: return slide->raise(index);
+                case Restack::LOWER: return slide->lower(index);
+                }
             }
+            else if (presentation->findGroup(shapeId_, slideIndex, index)) {
+                Model::Slide* slide = presentation->getSlide(slideIndex);
+                switch (move_) {
+                case Restack::BRING_TO_FRONT: return slide->bringGroupToFront(index);
+                case Restack::SEND_TO_BACK: return slide->sendGroupToBack(index);
+                case Restack::RAISE: return slide->raiseGroup(index);
+                case Restack::LOWER: return slide->lowerGroup(index);
+                }
+            }
+            return false;
+        }
+    };
+
+    // Groups shapes and groups of one slide, which must share a parent
+    // group or have none
+    class GroupShapesAction : public IAction {
+        size_t slideIndex_;
+        std::vector<std::uint64_t> ids_;
 
-            return std::make_unique<RemoveShapeAction>(slideIndex_, actualShapeIndex_);
+    public:
+        GroupShapesAction(size_t slideIndex, std::vector<std::uint64_t> ids)
+            : slideIndex_(slideIndex), ids_(std::move(ids)) {
+        }
+
+        bool execute(Model::Presentation* presentation) override {
+            if (!presentation || slideIndex_ >= presentation->slideCount()) {
+                return false;
+            }
+            return presentation->getSlide(slideIndex_)->groupShapes(ids_) != 0;
         }
     };
 
-    inline std::unique_ptr<IAction> RemoveShapeAction::execute(Model::Presentation* presentation) {
-        if (!presentation || slideIndex_ >= presentation->slideCount()) {
-            return nullptr;
+    class UngroupAction : public IAction {
+        std::uint64_t groupId_;
+
+    public:
+        explicit UngroupAction(std::uint64_t groupId) : groupId_(groupId) {
         }
 
-        Model::Slide* slide = presentation->getSlide(slideIndex_);
-        if (shapeIndex_ >= slide->shapeCount()) {
-            return nullptr;
+        bool execute(Model::Presentation* presentation) override {
+            size_t slideIndex = 0, groupIndex = 0;
+            if (!presentation || !presentation->findGroup(groupId_, slideIndex, groupIndex)) {
+                return false;
+            }
+            return presentation->getSlide(slideIndex)->ungroup(groupIndex);
         }
+    };
 
-        Model::IShape* shapePtr = slide->getShapes()[shapeIndex_].get();
-        removedShape_ = shapePtr->clone();
+    class AddShapeAction : public IAction {
+        size_t slideIndex_;
+        std::unique_ptr<Model::IShape> shape_;
+        bool toFront_;
 
-        slide->removeShapeAt(shapeIndex_);
+    public:
+        AddShapeAction(size_t slideIndex, std::unique_ptr<Model::IShape> shape, bool toFront = false)
+            : slideIndex_(slideIndex), shape_(std::move(shape)), toFront_(toFront) {
+        }
 
-        return std::make_unique<AddShapeAction>(slideIndex_, std::move(removedShape_), false);
-    }
+        bool execute(Model::Presentation* presentation) override {
+            if (!presentation || slideIndex_ >= presentation->slideCount() || !shape_) {
+                return false;
+            }
+
+            Model::Slide* slide = presentation->getSlide(slideIndex_);
+            size_t index = slide->shapeCount();
+            // A group goes on top as a whole already
+            bool group = shape_->asGroup() != nullptr;
+
+            slide->addShape(std::move(shape_));
 
+            if (toFront_ && !group && index < slide->shapeCount()) {
+                slide->bringToFront(index);
+            }
+            return true;
+        }
+    };
+
+    // Applies its actions in order, all or nothing
     class CompositeAction : public IAction {
         std::vector<std::unique_ptr<IAction>> actions_;
 
@@ -144,27 +241,103 @@ namespace Application {
             actions_.push_back(std::move(action));
         }
 
-        std::unique_ptr<IAction> execute(Model::Presentation* presentation) override {
+        bool execute(Model::Presentation* presentation) override {
             if (!presentation || actions_.empty()) {
-                return nullptr;
+                return false;
             }
 
-            std::vector<std::unique_ptr<IAction>> converseActions;
             for (auto& action : actions_) {
-                std::unique_ptr<IAction> converse = action->execute(presentation);
-                if (converse) {
-                    converseActions.push_back(std::move(converse));
+                if (!action->execute(presentation)) {
+                    return false;
                 }
             }
+            return true;
+        }
+    };
 
-            auto compositeConverse = std::make_unique<CompositeAction>();
-            for (auto it = converseActions.rbegin(); it != converseActions.rend(); ++it) {
-                compositeConverse->addAction(std::move(*it));
+    // Bulk geometry edits act on one slide, or on every slide when given
+    // kAllSlides. A selection is one byte mask per slide in that range
+    // (1 = selected); no masks at all means every shape.
+    const size_t kAllSlides = static_cast<size_t>(-1);
+    typedef std::vector<std::vector<std::uint8_t>> ShapeMasks;
+
+    inline bool resolveSlideRange(const Model::Presentation* presentation, size_t slideIndex,
+        size_t& first, size_t& last) {
+        if (!presentation) return false;
+        if (slideIndex == kAllSlides) {
+            first = 0;
+            last = presentation->slideCount();
+            return true;
+        }
+        if (slideIndex >= presentation->slideCount()) return false;
+        first = slideIndex;
+        last = slideIndex + 1;
+        return true;
+    }
+
+    inline bool masksMatch(const Model::Presentation* presentation, size_t first, size_t last, const ShapeMasks& masks) {
+        if (masks.empty()) return true;
+        if (masks.size() != last - first) return false;
+        for (size_t i = first; i < last; ++i) {
+            if (masks[i - first].size() != presentation->getSlide(i)->shapeCount()) return false;
+        }
+        return true;
+    }
+
+    class TranslateShapesAction : public IAction {
+        size_t slideIndex_;
+        int dx_;
+        int dy_;
+        ShapeMasks masks_;
+
+    public:
+        TranslateShapesAction(size_t slideIndex, int dx, int dy, ShapeMasks masks = ShapeMasks())
+            : slideIndex_(slideIndex), dx_(dx), dy_(dy), masks_(std::move(masks)) {
+        }
+
+        bool execute(Model::Presentation* presentation) override {
+            size_t first = 0, last = 0;
+            if (!resolveSlideRange(presentation, slideIndex_, first, last) ||
+                !masksMatch(presentation, first, last, masks_)) {
+                return false;
+            }
+
+            for (size_t i = first; i < last; ++i) {
+                const std::uint8_t* mask = masks_.empty() ? nullptr : masks_[i - first].data();
+                presentation->getSlide(i)->translateShapes(dx_, dy_, mask);
+            }
+            return true;
+        }
+    };
+
+    class ScaleShapesAction : public IAction {
+        size_t slideIndex_;
+        double factorX_;
+        double factorY_;
+        int originX_;
+        int originY_;
+        ShapeMasks masks_;
+
+    public:
+        ScaleShapesAction(size_t slideIndex, double factorX, double factorY, int originX, int originY,
+            ShapeMasks masks = ShapeMasks())
+            : slideIndex_(slideIndex), factorX_(factorX), factorY_(factorY),
+            originX_(originX), originY_(originY), masks_(std::move(masks)) {
+        }
+
+        bool execute(Model::Presentation* presentation) override {
+            size_t first = 0, last = 0;
+            if (!resolveSlideRange(presentation, slideIndex_, first, last) ||
+                !masksMatch(presentation, first, last, masks_)) {
+                return false;
             }
 
-            return compositeConverse;
+            for (size_t i = first; i < last; ++i) {
+                const std::uint8_t* mask = masks_.empty() ? nullptr : masks_[i - first].data();
+                presentation->getSlide(i)->scaleShapes(factorX_, factorY_, originX_, originY_, mask);
+            }
+            return true;
         }
     };
 
 }
-
@@ -1,5 +1,8 @@
 #pragma once
 #include "Editor.h"
+#include "../Model/Model.h"
+#include <memory>
+#include <string>
 
 namespace Application {
 
@@ -24,6 +27,18 @@ namespace Application {
         const Editor& getEditor() const {
             return editor_;
         }
+
+        // Replacing the deck drops the undo history along with it, so the old
+        // deck's versions, and the arena they share, are freed at once
+        void createPresentation(const std::string& title) {
+            editor_.clearHistory();
+            Model::Model::getInstance().createPresentation(title);
+        }
+
+        void setPresentation(std::unique_ptr<Model::Presentation> presentation) {
+            editor_.clearHistory();
+            Model::Model::getInstance().setPresentation(std::move(presentation));
+        }
     };
 
 }
@@ -1,71 +1,111 @@
 #pragma once
 #include "IAction.h"
+#include "../Model/MemoryStats.h"
 #include "../Model/Presentation.h"
 #include <stack>
 #include <memory>
 
 namespace Application {
 
+    // Undo history as versions of the presentation. Before each action the
+    // editor takes a snapshot, which shares every slide and shape with the
+    // live deck, so a version costs only what the action goes on to change.
+    // Undo and redo swap a stored version in; no action is ever reversed.
+    //
+    // Each version is charged what the model grew by while its action ran,
+    // read from the MemoryStats totals: that is the storage the action had
+    // to copy, which the older version then holds on its own. The charge
+    // moves with the version between the stacks, so memoryUsage() is a
+    // running sum. It is an estimate: storage a version keeps only because
+    // the action dropped it, such as a removed slide, is not charged.
     class Editor {
     private:
-        std::stack<std::unique_ptr<IAction>> undoStack_;
-        std::stack<std::unique_ptr<IAction>> redoStack_;
+        typedef std::shared_ptr<const Model::Presentation> Version;
+
+        struct Entry {
+            Version version;
+            size_t bytes;
+        };
+
+        std::stack<Entry> undoStack_;
+        std::stack<Entry> redoStack_;
+        size_t historyBytes_;
+
+        // Versions of another deck are no use once it has been replaced.
+        // Application clears the history when it replaces the deck; this
+        // catches a deck swapped in through the Model directly.
+        bool belongsTo(const Version& version, const Model::Presentation* presentation) {
+            if (version->id() == presentation->id()) {
+                return true;
+            }
+            clearHistory();
+            return false;
+        }
+
+        void push(std::stack<Entry>& stack, Version version, size_t bytes) {
+            stack.push(Entry{ std::move(version), bytes });
+            historyBytes_ += bytes;
+        }
+
+        void pop(std::stack<Entry>& stack) {
+            historyBytes_ -= stack.top().bytes;
+            stack.pop();
+        }
 
     public:
+        Editor() : historyBytes_(0) {
+        }
 
-        void doAction(std::unique_ptr<IAction> action, Model::Presentation* presentation) {
+        // Returns false, leaving the deck and the history as they were, if
+        // the action fails
+        bool doAction(std::unique_ptr<IAction> action, Model::Presentation* presentation) {
             if (!action || !presentation) {
-                return;
+                return false;
             }
 
-            std::unique_ptr<IAction> converseAction = action->execute(presentation);
-
-            if (converseAction) {
-
-                while (!redoStack_.empty()) {
-                    redoStack_.pop();
-                }
+            const Model::MemoryStats& stats = Model::MemoryStats::getInstance();
+            Version before = presentation->snapshot();
+            long long modelBefore = stats.totalBytes();
+            if (!action->execute(presentation)) {
+                presentation->restore(*before);
+                return false;
+            }
+            long long grown = stats.totalBytes() - modelBefore;
 
-                undoStack_.push(std::move(converseAction));
+            if (!undoStack_.empty()) {
+                belongsTo(undoStack_.top().version, presentation);
             }
+            while (!redoStack_.empty()) {
+                pop(redoStack_);
+            }
+            push(undoStack_, std::move(before), grown > 0 ? static_cast<size_t>(grown) : 0);
+            return true;
         }
 
+        // The version undone to becomes live, and the one left behind holds
+        // what it had copied
         bool undo(Model::Presentation* presentation) {
-            if (undoStack_.empty() || !presentation) {
+            if (undoStack_.empty() || !presentation || !belongsTo(undoStack_.top().version, presentation)) {
                 return false;
             }
 
-            std::unique_ptr<IAction> undoAction = std::move(undoStack_.top());
-            undoStack_.pop();
-
-            std::unique_ptr<IAction> redoAction = undoAction->execute(presentation);
-
-            if (redoAction) {
-
-                redoStack_.push(std::move(redoAction));
-                return true;
-            }
-
-            return false;
+            size_t bytes = undoStack_.top().bytes;
+            push(redoStack_, presentation->snapshot(), bytes);
+            presentation->restore(*undoStack_.top().version);
+            pop(undoStack_);
+            return true;
         }
 
         bool redo(Model::Presentation* presentation) {
-            if (redoStack_.empty() || !presentation) {
+            if (redoStack_.empty() || !presentation || !belongsTo(redoStack_.top().version, presentation)) {
                 return false;
             }
 
-            std::unique_ptr<IAction> redoAction = std::move(redoStack_.top());
-            redoStack_.pop();
-
-            std::unique_ptr<IAction> undoAction = redoAction->execute(presentation);
-
-            if (undoAction) {
-
-                undoStack_.push(std::move(undoAction));
-                return true;
-            }
-
-            return false;
+            size_t bytes = redoStack_.top().bytes;
+            push(undoStack_, presentation->snapshot(), bytes);
+            presentation->restore(*redoStack_.top().version);
+            pop(redoStack_);
+            return true;
         }
 
         bool canUndo() const {
@@ -78,13 +118,26 @@ namespace Application {
 
         void clearHistory() {
             while (!undoStack_.empty()) {
-                undoStack_.pop();
+                pop(undoStack_);
             }
             while (!redoStack_.empty()) {
-                redoStack_.pop();
+                pop(redoStack_);
             }
         }
+
+        size_t undoCount() const {
+            return undoStack_.size();
+        }
+
+        size_t redoCount() const {
+            return redoStack_.size();
+        }
+
+        // Estimated bytes held only by the stored versions, and the entries
+        // keeping them
+        size_t memoryUsage() const {
+            return historyBytes_ + (undoStack_.size() + redoStack_.size()) * (sizeof(Entry) + sizeof(Model::Presentation));
+        }
     };
 
 }
-
@@ -4,12 +4,15 @@
 
 namespace Application {
 
+    // One edit to a presentation. The Editor keeps the version from before
+    // the edit for undo, so an action needs no inverse of its own.
     class IAction {
     public:
         virtual ~IAction() = default;
 
-        virtual std::unique_ptr<IAction> execute(Model::Presentation* presentation) = 0;
+        // False if the edit does not apply; the Editor then discards any
+        // partial change
+        virtual bool execute(Model::Presentation* presentation) = 0;
     };
 
 }
-
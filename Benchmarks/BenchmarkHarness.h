@@ -0,0 +1,61 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+namespace Benchmarks {
+
+    struct BenchmarkResult {
+        double seconds;
+        std::uint64_t primitives;
+        std::uint64_t bytes;
+    };
+
+    // Runs a case a fixed number of times and prints per-iteration throughput.
+    // The body returns the primitives and bytes it produced in one iteration.
+    class BenchmarkHarness {
+    private:
+        int iterations_;
+        size_t shapeCount_;
+
+    public:
+        BenchmarkHarness(int iterations, size_t shapeCount)
+            : iterations_(iterations < 1 ? 1 : iterations), shapeCount_(shapeCount) {
+        }
+
+        static void printHeader() {
+            std::printf("%-28s %12s %16s %14s %12s\n", "case", "ms/iter", "primitives/s", "MB/s", "ns/shape");
+        }
+
+        BenchmarkResult run(const std::string& name, const std::function<BenchmarkResult()>& body) const {
+            BenchmarkResult last = body();
+
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations_; ++i) {
+                last = body();
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            last.seconds = std::chrono::duration<double>(end - start).count() / iterations_;
+            report(name, last);
+            return last;
+        }
+
+        // Prints a row for a case timed by the caller, for work that needs
+        // untimed setup on every iteration
+        void report(const std::string& name, const BenchmarkResult& result) const {
+            double seconds = result.seconds;
+            double primitivesPerSec = seconds > 0 ? result.primitives / seconds : 0.0;
+            double megabytesPerSec = seconds > 0 ? result.bytes / seconds / (1024.0 * 1024.0) : 0.0;
+            double nsPerShape = shapeCount_ > 0 ? seconds * 1e9 / shapeCount_ : 0.0;
+
+            std::printf("%-28s %12.3f %16.0f %14.2f %12.1f\n",
+                name.c_str(), seconds * 1e3, primitivesPerSec, megabytesPerSec, nsPerShape);
+        }
+
+        int iterations() const { return iterations_; }
+    };
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "../Model/Presentation.h"
+#include "../Model/ShapeRecord.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Benchmarks {
+
+    // Builds deterministic synthetic decks so benchmark runs are comparable.
+    class DeckGenerator {
+    private:
+        std::uint32_t state_;
+
+        int next(int bound) {
+            state_ = state_ * 1664525u + 1013904223u;
+            return static_cast<int>((state_ >> 8) % static_cast<std::uint32_t>(bound));
+        }
+
+    public:
+        explicit DeckGenerator(std::uint32_t seed = 12345u) : state_(seed) {
+        }
+
+        std::unique_ptr<Model::Presentation> generate(size_t slideCount, size_t shapesPerSlide) {
+            static const char* const colors[] = { "black", "red", "blue", "green", "orange", "#336699", "gray" };
+            static const char* const fills[] = { "none", "none", "yellow", "lightblue", "#ffeecc" };
+            static const char* const labels[] = { "", "", "Revenue", "Q3 results", "Next steps & owners" };
+
+            auto presentation = std::make_unique<Model::Presentation>("Benchmark deck");
+            for (size_t i = 0; i < slideCount; ++i) {
+                auto slide = presentation->makeSlide();
+                slide->reserveShapes(shapesPerSlide);
+                for (size_t j = 0; j < shapesPerSlide; ++j) {
+                    Model::BoundingBox bounds(next(560), next(120), 10 + next(150), 10 + next(60));
+                    std::string color = colors[next(7)];
+                    std::string fill = fills[next(5)];
+                    std::string text = labels[next(5)];
+
+                    int kind = next(7);
+                    if (kind < 6) {
+                        slide->addShape(bounds, Model::ShapeRecord(static_cast<Model::ShapeKind>(kind), color, fill, text));
+                    }
+                    else {
+                        slide->addShape(bounds, Model::ShapeRecord::makeText("Body text for the slide", color));
+                    }
+                }
+                presentation->addSlide(std::move(slide));
+            }
+            return presentation;
+        }
+
+        // Decks made only of text runs: a pool of sentences of varying length
+        // placed in boxes of a few dozen sizes, as repeated labels would be.
+        std::unique_ptr<Model::Presentation> generateText(size_t slideCount, size_t runsPerSlide) {
+            static const char* const words[] = {
+                "quarterly", "revenue", "grew", "by", "twelve", "percent", "while", "operating",
+                "costs", "stayed", "flat", "across", "all", "regions", "and", "the", "pipeline",
+                "for", "next", "year", "looks", "strong", "despite", "supply", "constraints"
+            };
+            static const char* const fonts[] = { "Arial", "Times New Roman", "Courier New" };
+
+            std::vector<std::string> labels(2000);
+            for (std::string& text : labels) {
+                int wordCount = next(4) == 0 ? 3 : 4 + next(24);
+                for (int w = 0; w < wordCount; ++w) {
+                    if (w > 0) text += ' ';
+                    text += words[next(25)];
+                }
+            }
+
+            auto presentation = std::make_unique<Model::Presentation>("Text benchmark deck");
+            for (size_t i = 0; i < slideCount; ++i) {
+                auto slide = presentation->makeSlide();
+                slide->reserveShapes(runsPerSlide);
+                for (size_t j = 0; j < runsPerSlide; ++j) {
+                    const std::string& text = labels[next(static_cast<int>(labels.size()))];
+                    Model::BoundingBox bounds(next(500), next(120), 60 + 20 * next(12), 20 + 20 * next(4));
+                    slide->addShape(bounds, Model::ShapeRecord::makeText(text, "black",
+                        fonts[next(3)], 10 + next(14)));
+                }
+                presentation->addSlide(std::move(slide));
+            }
+            return presentation;
+        }
+    };
+
+}
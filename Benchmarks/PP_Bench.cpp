@@ -0,0 +1,751 @@
+#include "DeckGenerator.h"
+#include "BenchmarkHarness.h"
+#include "../Application/Actions.h"
+#include "../Application/Editor.h"
+#include "../Controller/RenderCommand.h"
+#include "../Visualization/DeckLayout.h"
+#include "../Visualization/DeckPainter.h"
+#include "../Visualization/SvgVisualization.h"
+#include "../Visualization/ThumbnailSheet.h"
+#include "../Painting/NullPainter.h"
+#include "../Painting/CountingPainter.h"
+#include "../Painting/PdfPainter.h"
+#include "../Painting/SVGPainter.h"
+#include "../Painting/TextLayout.h"
+#include "../Serialization/JsonDeserialize.h"
+#include "../Serialization/JsonSerialize.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include <new>
+#include <sstream>
+#include <string>
+
+// Every allocation in the process is counted, so suites can report the heap
+// footprint of what they build
+namespace {
+    const std::size_t kAllocationHeader = 16;
+    std::atomic<long long> liveBytes(0);
+    std::atomic<long long> liveBlocks(0);
+
+    void* alignedAllocate(std::size_t alignment, std::size_t size) {
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        return std::aligned_alloc(alignment, size);
+#endif
+    }
+
+    void alignedFree(void* block) {
+#ifdef _WIN32
+        _aligned_free(block);
+#else
+        std::free(block);
+#endif
+    }
+}
+
+void* operator new(std::size_t size) {
+    void* block = std::malloc(size + kAllocationHeader);
+    if (!block) throw std::bad_alloc();
+    *static_cast<std::size_t*>(block) = size;
+    liveBytes += static_cast<long long>(size);
+    ++liveBlocks;
+    return static_cast<char*>(block) + kAllocationHeader;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    char* block = static_cast<char*>(pointer) - kAllocationHeader;
+    liveBytes -= static_cast<long long>(*reinterpret_cast<std::size_t*>(block));
+    --liveBlocks;
+    std::free(block);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+// Memory resources allocate through the aligned forms; the header is
+// widened to the alignment so the block stays aligned
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    std::size_t header = std::max(kAllocationHeader, static_cast<std::size_t>(alignment));
+    std::size_t total = (size + header + header - 1) / header * header;
+    void* block = alignedAllocate(header, total);
+    if (!block) throw std::bad_alloc();
+    *static_cast<std::size_t*>(block) = size;
+    liveBytes += static_cast<long long>(size);
+    ++liveBlocks;
+    return static_cast<char*>(block) + header;
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept {
+    if (!pointer) return;
+    std::size_t header = std::max(kAllocationHeader, static_cast<std::size_t>(alignment));
+    char* block = static_cast<char*>(pointer) - header;
+    liveBytes -= static_cast<long long>(*reinterpret_cast<std::size_t*>(block));
+    --liveBlocks;
+    alignedFree(block);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(pointer, alignment);
+}
+
+namespace {
+
+    struct Options {
+        std::string suite = "render";
+        size_t slides = 200;
+        size_t shapes = 50;
+        int iterations = 5;
+        size_t threads = 0;
+    };
+
+    Options parseOptions(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-slides" && i + 1 < argc) {
+                options.slides = std::strtoul(argv[++i], nullptr, 10);
+            }
+            else if (arg == "-shapes" && i + 1 < argc) {
+                options.shapes = std::strtoul(argv[++i], nullptr, 10);
+            }
+            else if (arg == "-iterations" && i + 1 < argc) {
+                options.iterations = std::atoi(argv[++i]);
+            }
+            else if (arg == "-threads" && i + 1 < argc) {
+                options.threads = std::strtoul(argv[++i], nullptr, 10);
+            }
+            else if (!arg.empty() && arg[0] != '-') {
+                options.suite = arg;
+            }
+        }
+        return options;
+    }
+
+    void runRenderSuite(const Options& options) {
+        Benchmarks::DeckGenerator generator;
+        auto deck = generator.generate(options.slides, options.shapes);
+        const size_t slideCount = deck->slideCount();
+        const size_t shapeCount = slideCount * options.shapes;
+
+        std::printf("render: %zu slides x %zu shapes, %d iterations\n\n",
+            slideCount, options.shapes, options.iterations);
+
+        Benchmarks::BenchmarkHarness harness(options.iterations, shapeCount);
+        Benchmarks::BenchmarkHarness::printHeader();
+
+        const Visualization::DeckPainter deckPainter;
+        const Visualization::DeckLayout layout = Visualization::DeckLayout::compute(*deck);
+
+        Painting::CountingPainter counter;
+        counter.beginPaint();
+        deckPainter.paint(counter, layout);
+        const Painting::CountingPainter::Counts counts = counter.getCounts();
+
+        harness.run("layout pass", [&]() {
+            Visualization::DeckLayout fresh = Visualization::DeckLayout::compute(*deck);
+            return Benchmarks::BenchmarkResult{ 0, fresh.slideCount(), 0 };
+        });
+
+        harness.run("paint -> null", [&]() {
+            Painting::NullPainter painter;
+            deckPainter.paint(painter, layout);
+            return Benchmarks::BenchmarkResult{ 0, counts.primitives(), 0 };
+        });
+
+        harness.run("paint -> counting", [&]() {
+            Painting::CountingPainter painter;
+            painter.beginPaint();
+            deckPainter.paint(painter, layout);
+            return Benchmarks::BenchmarkResult{ 0, painter.getCounts().primitives(), painter.getCounts().textBytes };
+        });
+
+        harness.run("paint -> svg", [&]() {
+            Painting::SVGPainter painter(layout.canvasWidth(), layout.canvasHeight());
+            painter.beginPaint();
+            deckPainter.paint(painter, layout);
+            painter.endPaint();
+            return Benchmarks::BenchmarkResult{ 0, counts.primitives(), painter.getSVG().size() };
+        });
+
+        // One page per slide, as export_pdf writes it
+        harness.run("paint -> pdf", [&]() {
+            std::ostringstream out;
+            Painting::PdfPainter painter(out);
+            for (size_t i = 0; i < slideCount; ++i) {
+                Visualization::DeckLayout page = Visualization::DeckLayout::compute(*deck, i, i + 1);
+                painter.setPageSize(page.canvasWidth(), page.canvasHeight());
+                painter.beginPaint();
+                deckPainter.paint(painter, page);
+                painter.endPaint();
+            }
+            painter.endDocument();
+            return Benchmarks::BenchmarkResult{ 0, counts.primitives(), static_cast<std::uint64_t>(painter.bytesWritten()) };
+        });
+
+        const auto pretty = Painting::SVGPainter::Format::PRETTY;
+        const std::string serial = Controller::RenderCommand::renderSVG(*deck, 0, slideCount, pretty, 1);
+
+        harness.run("renderSVG 1 thread", [&]() {
+            std::string svg = Controller::RenderCommand::renderSVG(*deck, 0, slideCount, pretty, 1);
+            return Benchmarks::BenchmarkResult{ 0, counts.primitives(), svg.size() };
+        });
+
+        Controller::WorkerPool pool(options.threads);
+        std::string parallel;
+        harness.run("renderSVG " + std::to_string(pool.getThreadCount()) + " threads", [&]() {
+            parallel = Controller::RenderCommand::renderSVG(*deck, 0, slideCount, pretty, pool.getThreadCount());
+            return Benchmarks::BenchmarkResult{ 0, counts.primitives(), parallel.size() };
+        });
+        if (parallel != serial) {
+            std::printf("WARNING: parallel render differs from serial render\n");
+        }
+
+        harness.run("thumbnails 0.1 -> svg", [&]() {
+            Visualization::ThumbnailSheet sheet(*deck, 10, 0.1);
+            Painting::SVGPainter painter(sheet.canvasWidth(), sheet.canvasHeight(), Painting::SVGPainter::Format::MINIFIED);
+            painter.beginPaint();
+            sheet.paint(painter);
+            painter.endPaint();
+            return Benchmarks::BenchmarkResult{ 0, counts.primitives(), painter.getSVG().size() };
+        });
+
+        harness.run("SvgVisualization::visualize", [&]() {
+            Visualization::SvgVisualization visualization;
+            std::string svg = visualization.visualize(*deck);
+            return Benchmarks::BenchmarkResult{ 0, counts.primitives(), svg.size() };
+        });
+
+        std::printf("\nprimitives per render: %llu (%llu points, %llu text bytes)\n",
+            static_cast<unsigned long long>(counts.primitives()),
+            static_cast<unsigned long long>(counts.points),
+            static_cast<unsigned long long>(counts.textBytes));
+    }
+
+    void runLayoutSuite(const Options& options) {
+        Benchmarks::DeckGenerator generator;
+        auto deck = generator.generateText(options.slides, options.shapes);
+        const size_t slideCount = deck->slideCount();
+        const size_t runCount = slideCount * options.shapes;
+
+        std::printf("layout: %zu text runs (%zu slides x %zu), %d iterations\n\n",
+            runCount, slideCount, options.shapes, options.iterations);
+
+        struct Run {
+            std::string text;
+            std::string fontFamily;
+            int fontSize;
+            int width;
+            int height;
+        };
+        std::vector<Run> runs;
+        runs.reserve(runCount);
+        for (size_t i = 0; i < slideCount; ++i) {
+            const Model::Slide* slide = deck->getSlide(i);
+            for (size_t j = 0; j < slide->shapeCount(); ++j) {
+                const Model::ShapeRecord& shape = slide->getShapes()[j];
+                const Model::BoundingBox bounds = slide->shapeBounds(j);
+                runs.push_back(Run{ shape.text(), shape.fontFamily(), shape.fontSize(),
+                    bounds.getWidth() - 8, bounds.getHeight() - 8 });
+            }
+        }
+
+        Benchmarks::BenchmarkHarness harness(options.iterations, runCount);
+        Benchmarks::BenchmarkHarness::printHeader();
+        auto& layout = Painting::TextLayout::getInstance();
+
+        harness.run("compute (no cache)", [&]() {
+            std::uint64_t lines = 0, bytes = 0;
+            for (const Run& run : runs) {
+                Painting::TextBlock block = Painting::TextLayout::compute(run.text, run.fontFamily, run.fontSize, run.width, run.height);
+                lines += block.lines.size();
+                bytes += run.text.size();
+            }
+            return Benchmarks::BenchmarkResult{ 0, lines, bytes };
+        });
+
+        harness.run("cache cold", [&]() {
+            layout.clear();
+            std::uint64_t lines = 0, bytes = 0;
+            for (const Run& run : runs) {
+                lines += layout.layout(run.text, run.fontFamily, run.fontSize, run.width, run.height)->lines.size();
+                bytes += run.text.size();
+            }
+            return Benchmarks::BenchmarkResult{ 0, lines, bytes };
+        });
+
+        harness.run("cache warm", [&]() {
+            std::uint64_t lines = 0, bytes = 0;
+            for (const Run& run : runs) {
+                lines += layout.layout(run.text, run.fontFamily, run.fontSize, run.width, run.height)->lines.size();
+                bytes += run.text.size();
+            }
+            return Benchmarks::BenchmarkResult{ 0, lines, bytes };
+        });
+
+        // The first pass lays every label out; later passes replay the lines
+        // memoized on the shapes
+        harness.run("render text deck -> counting", [&]() {
+            Painting::CountingPainter painter;
+            painter.beginPaint();
+            Visualization::DeckPainter().paint(painter, Visualization::DeckLayout::compute(*deck));
+            return Benchmarks::BenchmarkResult{ 0, painter.getCounts().primitives(), painter.getCounts().textBytes };
+        });
+
+        std::printf("\ncache: %zu entries, %zu hits, %zu misses\n", layout.size(), layout.hits(), layout.misses());
+    }
+
+    // Building, copying, saving and parsing the model itself
+    void runModelSuite(const Options& options) {
+        Benchmarks::DeckGenerator warmup;
+        warmup.generate(1, options.shapes);
+
+        long long bytesBefore = liveBytes, blocksBefore = liveBlocks;
+        Benchmarks::DeckGenerator generator;
+        auto deck = generator.generate(options.slides, options.shapes);
+        long long deckBytes = liveBytes - bytesBefore, deckBlocks = liveBlocks - blocksBefore;
+
+        const size_t slideCount = deck->slideCount();
+        const size_t shapeCount = slideCount * options.shapes;
+
+        std::printf("model: %zu slides x %zu shapes, %d iterations\n\n",
+            slideCount, options.shapes, options.iterations);
+
+        Benchmarks::BenchmarkHarness harness(options.iterations, shapeCount);
+        Benchmarks::BenchmarkHarness::printHeader();
+
+        harness.run("generate deck", [&]() {
+            Benchmarks::DeckGenerator fresh;
+            auto copy = fresh.generate(options.slides, options.shapes);
+            return Benchmarks::BenchmarkResult{ 0, copy->slideCount(), 0 };
+        });
+
+        harness.run("clone slides", [&]() {
+            std::vector<std::unique_ptr<Model::Slide>> clones;
+            clones.reserve(slideCount);
+            for (size_t i = 0; i < slideCount; ++i) {
+                clones.push_back(deck->getSlide(i)->clone());
+            }
+            return Benchmarks::BenchmarkResult{ 0, clones.size(), 0 };
+        });
+
+        // A clone shares its shapes until edited; the first edit copies them
+        harness.run("clone + edit slides", [&]() {
+            std::vector<std::unique_ptr<Model::Slide>> clones;
+            clones.reserve(slideCount);
+            for (size_t i = 0; i < slideCount; ++i) {
+                clones.push_back(deck->getSlide(i)->clone());
+                clones.back()->translateShapes(1, 1);
+            }
+            return Benchmarks::BenchmarkResult{ 0, clones.size(), 0 };
+        });
+
+        std::string json;
+        harness.run("serialize json", [&]() {
+            std::ostringstream out;
+            Serialization::JsonSerialize().write(*deck, out);
+            json = out.str();
+            return Benchmarks::BenchmarkResult{ 0, 0, json.size() };
+        });
+
+        // Loading, duplicating and closing a deck, with shape arrays from
+        // the heap and from a per-presentation arena
+        for (int inArena = 0; inArena < 2; ++inArena) {
+            const std::string suffix = inArena ? " (arena)" : " (heap)";
+            auto newDeck = [&]() {
+                return std::make_unique<Model::Presentation>(deck->title(),
+                    inArena ? Model::Arena::create() : std::shared_ptr<Model::Arena>());
+            };
+            auto duplicate = [&]() {
+                auto copy = newDeck();
+                for (size_t i = 0; i < slideCount; ++i) {
+                    copy->addSlide(deck->getSlide(i)->clone(copy->arena()));
+                }
+                return copy;
+            };
+
+            harness.run("load json" + suffix, [&]() {
+                Serialization::JsonDeserialize loader;
+                auto loaded = newDeck();
+                for (const std::string& slideJson : loader.splitSlides(json)) {
+                    loaded->addSlide(loader.parseSlide(slideJson, loaded->arena()));
+                }
+                return Benchmarks::BenchmarkResult{ 0, loaded->slideCount(), json.size() };
+            });
+
+            harness.run("duplicate deck" + suffix, [&]() {
+                return Benchmarks::BenchmarkResult{ 0, duplicate()->slideCount(), 0 };
+            });
+
+            Benchmarks::BenchmarkResult teardown{ 0, slideCount, 0 };
+            for (int i = 0; i < harness.iterations(); ++i) {
+                auto copy = duplicate();
+                auto start = std::chrono::steady_clock::now();
+                copy.reset();
+                teardown.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+            teardown.seconds /= harness.iterations();
+            harness.report("teardown" + suffix, teardown);
+        }
+
+        // The layout before bounds moved into per-slide arrays: each box
+        // inside its shape record, edited one BoundingBox at a time
+        std::vector<std::vector<std::pair<Model::BoundingBox, Model::ShapeRecord>>> records(slideCount);
+        for (size_t i = 0; i < slideCount; ++i) {
+            const Model::Slide* slide = deck->getSlide(i);
+            records[i].reserve(slide->shapeCount());
+            for (size_t j = 0; j < slide->shapeCount(); ++j) {
+                records[i].emplace_back(slide->shapeBounds(j), slide->getShapes()[j]);
+            }
+        }
+        harness.run("translate (records)", [&]() {
+            for (auto& slideRecords : records) {
+                for (auto& record : slideRecords) {
+                    const Model::BoundingBox& box = record.first;
+                    record.first = Model::BoundingBox(box.getX() + 3, box.getY() - 2, box.getWidth(), box.getHeight());
+                }
+            }
+            return Benchmarks::BenchmarkResult{ 0, 0, 0 };
+        });
+        records.clear();
+
+        harness.run("translate (arrays)", [&]() {
+            for (size_t i = 0; i < slideCount; ++i) {
+                deck->getSlide(i)->translateShapes(3, -2);
+            }
+            return Benchmarks::BenchmarkResult{ 0, 0, 0 };
+        });
+
+        std::vector<std::vector<std::uint8_t>> masks(slideCount);
+        const Model::BoundingBox region(100, 0, 200, 100);
+        harness.run("region test (arrays)", [&]() {
+            std::uint64_t hits = 0;
+            for (size_t i = 0; i < slideCount; ++i) {
+                const Model::Slide* slide = deck->getSlide(i);
+                masks[i].resize(slide->shapeCount());
+                hits += slide->geometry().intersecting(region, masks[i].data());
+            }
+            return Benchmarks::BenchmarkResult{ 0, hits, 0 };
+        });
+
+        harness.run("translate region (arrays)", [&]() {
+            for (size_t i = 0; i < slideCount; ++i) {
+                deck->getSlide(i)->translateShapes(1, 1, masks[i].data());
+            }
+            return Benchmarks::BenchmarkResult{ 0, 0, 0 };
+        });
+
+        harness.run("scale (arrays)", [&]() {
+            for (size_t i = 0; i < slideCount; ++i) {
+                deck->getSlide(i)->scaleShapes(1.0, 1.0, 0, 0);
+            }
+            return Benchmarks::BenchmarkResult{ 0, 0, 0 };
+        });
+
+        harness.run("union bounds (arrays)", [&]() {
+            std::uint64_t area = 0;
+            for (size_t i = 0; i < slideCount; ++i) {
+                Model::BoundingBox bounds(0, 0, 0, 0);
+                if (deck->getSlide(i)->geometry().unionBounds(bounds)) {
+                    area += static_cast<std::uint64_t>(bounds.getWidth()) * bounds.getHeight();
+                }
+            }
+            return Benchmarks::BenchmarkResult{ 0, area > 0 ? 1u : 0u, 0 };
+        });
+
+        // Every shape looked up by id; the first pass builds the hash tables
+        const Model::Presentation& current = *deck;
+        std::vector<std::uint64_t> shapeIds;
+        shapeIds.reserve(shapeCount);
+        for (size_t i = 0; i < slideCount; ++i) {
+            const Model::Slide* slide = current.getSlide(i);
+            for (size_t j = 0; j < slide->shapeCount(); ++j) {
+                shapeIds.push_back(slide->shapeId(j));
+            }
+        }
+        harness.run("find shape by id", [&]() {
+            std::uint64_t found = 0;
+            size_t slideIndex = 0, shapeIndex = 0;
+            for (std::uint64_t id : shapeIds) {
+                found += current.findShape(id, slideIndex, shapeIndex);
+            }
+            return Benchmarks::BenchmarkResult{ 0, found, 0 };
+        });
+
+        const Visualization::DeckPainter deckPainter;
+        const Visualization::DeckLayout layout = Visualization::DeckLayout::compute(*deck);
+        harness.run("paint -> counting", [&]() {
+            Painting::CountingPainter painter;
+            painter.beginPaint();
+            deckPainter.paint(painter, layout);
+            return Benchmarks::BenchmarkResult{ 0, painter.getCounts().primitives(), painter.getCounts().textBytes };
+        });
+
+        // Each edit through the editor keeps the version before it; what that
+        // version holds beyond the live deck is what the edit copied
+        const int edits = 200;
+        Application::Editor editor;
+        long long historyBefore = liveBytes;
+        auto editStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < edits; ++i) {
+            editor.doAction(std::make_unique<Application::TranslateShapesAction>(
+                static_cast<size_t>(i) * 7919 % slideCount, 1, 0), deck.get());
+        }
+        Benchmarks::BenchmarkResult history{ std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - editStart).count() / edits, 1, 0 };
+        harness.report("edit one slide, keep undo", history);
+        long long historyBytes = liveBytes - historyBefore;
+        editor.clearHistory();
+
+        std::printf("\nheap per shape: %.1f bytes in %.2f blocks\n",
+            shapeCount > 0 ? static_cast<double>(deckBytes) / shapeCount : 0.0,
+            shapeCount > 0 ? static_cast<double>(deckBlocks) / shapeCount : 0.0);
+        std::printf("shape record: %zu bytes, plus %zu bytes of bounds\n",
+            sizeof(Model::ShapeRecord), 4 * sizeof(int));
+        std::printf("string pool: %zu strings in %zu bytes, shared by every shape\n",
+            Model::StringPool::getInstance().size(), Model::StringPool::getInstance().byteCount());
+        std::printf("undo history: %.0f bytes per single-slide edit\n", static_cast<double>(historyBytes) / edits);
+    }
+
+    // Hit tests on one slide holding every generated shape, through the
+    // spatial index and by scanning the bounds arrays
+    void runSpatialSuite(const Options& options) {
+        const size_t shapeCount = options.slides * options.shapes;
+        const int canvas = 10000;
+        const int queries = 1000;
+
+        Model::Slide slide(Model::Arena::create());
+        slide.reserveShapes(shapeCount);
+        std::uint32_t seed = 12345;
+        auto next = [&seed](int range) {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<int>((seed >> 8) % static_cast<std::uint32_t>(range));
+        };
+        for (size_t i = 0; i < shapeCount; ++i) {
+            slide.addShape(Model::BoundingBox(next(canvas), next(canvas), 5 + next(56), 5 + next(56)),
+                Model::ShapeRecord(Model::ShapeKind::RECTANGLE));
+        }
+
+        std::vector<std::pair<int, int>> points;
+        for (int i = 0; i < queries; ++i) {
+            points.push_back(std::make_pair(next(canvas), next(canvas)));
+        }
+
+        std::printf("spatial: %zu shapes on one slide, %d queries per iteration, %d iterations\n\n",
+            shapeCount, queries, options.iterations);
+
+        Benchmarks::BenchmarkHarness harness(options.iterations, shapeCount);
+        Benchmarks::BenchmarkHarness::printHeader();
+
+        harness.run("build index", [&]() {
+            slide.translateShapes(0, 0);
+            return Benchmarks::BenchmarkResult{ 0, slide.pick(0, 0) != Model::Slide::npos ? 1u : 0u, 0 };
+        });
+
+        harness.run("pick (index)", [&]() {
+            std::uint64_t hits = 0;
+            for (const auto& point : points) {
+                hits += slide.pick(point.first, point.second) != Model::Slide::npos;
+            }
+            return Benchmarks::BenchmarkResult{ 0, hits, 0 };
+        });
+
+        harness.run("pick (scan)", [&]() {
+            const Model::ShapeGeometry& geometry = slide.geometry();
+            const int* x = geometry.xs();
+            const int* y = geometry.ys();
+            const int* w = geometry.widths();
+            const int* h = geometry.heights();
+            std::uint64_t hits = 0;
+            for (const auto& point : points) {
+                for (size_t i = geometry.size(); i-- > 0;) {
+                    if (x[i] <= point.first && point.first <= x[i] + w[i] &&
+                        y[i] <= point.second && point.second <= y[i] + h[i]) {
+                        ++hits;
+                        break;
+                    }
+                }
+            }
+            return Benchmarks::BenchmarkResult{ 0, hits, 0 };
+        });
+
+        harness.run("select 200x200 (index)", [&]() {
+            std::uint64_t hits = 0;
+            for (const auto& point : points) {
+                hits += slide.select(Model::BoundingBox(point.first, point.second, 200, 200)).size();
+            }
+            return Benchmarks::BenchmarkResult{ 0, hits, 0 };
+        });
+
+        std::vector<std::uint8_t> mask(shapeCount);
+        harness.run("select 200x200 (scan)", [&]() {
+            std::uint64_t hits = 0;
+            for (const auto& point : points) {
+                hits += slide.geometry().intersecting(Model::BoundingBox(point.first, point.second, 200, 200), mask.data());
+            }
+            return Benchmarks::BenchmarkResult{ 0, hits, 0 };
+        });
+
+        // Appends and removals keep the index current without a rebuild
+        harness.run("add + remove, then pick", [&]() {
+            std::uint64_t hits = 0;
+            for (int i = 0; i < queries; ++i) {
+                slide.addShape(Model::BoundingBox(points[i].first, points[i].second, 10, 10),
+                    Model::ShapeRecord(Model::ShapeKind::RECTANGLE));
+                hits += slide.pick(points[i].first, points[i].second) == slide.shapeCount() - 1;
+                slide.removeLastShape();
+            }
+            return Benchmarks::BenchmarkResult{ 0, hits, 0 };
+        });
+
+        // Restacking relinks one shape; the arrays and the index stay put
+        harness.run("restack, then pick", [&]() {
+            std::uint64_t hits = 0;
+            for (int i = 0; i < queries; ++i) {
+                size_t index = static_cast<size_t>(next(static_cast<int>(shapeCount)));
+                switch (i % 4) {
+                case 0: slide.bringToFront(index); break;
+                case 1: slide.sendToBack(index); break;
+                case 2: slide.raise(index); break;
+                default: slide.lower(index); break;
+                }
+                hits += slide.pick(points[i].first, points[i].second) != Model::Slide::npos;
+            }
+            return Benchmarks::BenchmarkResult{ 0, hits, 0 };
+        });
+
+        harness.run("walk z-order", [&]() {
+            std::uint64_t sum = 0;
+            for (size_t i = slide.bottomShape(); i != Model::Slide::npos; i = slide.shapeAbove(i)) {
+                sum += i;
+            }
+            return Benchmarks::BenchmarkResult{ 0, sum > 0 ? shapeCount : 0u, 0 };
+        });
+    }
+
+    // Positional slide operations on decks of 1k to 10M slides. Every entry
+    // holds the same empty slide, so the numbers are the slide list's own.
+    // The vector column is the flat list this replaced, inserting at the
+    // front; it is skipped past 1M slides, where it takes minutes.
+    void runSequenceSuite(const Options&) {
+        typedef std::chrono::steady_clock Clock;
+        auto nsPer = [](Clock::time_point start, size_t count) {
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (count > 0 ? count : 1);
+        };
+
+        const size_t ops = 1000;
+        std::shared_ptr<Model::Slide> slide = std::make_shared<Model::Slide>();
+        std::uint32_t seed = 12345;
+        auto next = [&seed](size_t range) {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<size_t>(seed >> 4) % range;
+        };
+
+        std::printf("sequence: ns per operation, %zu operations per case\n\n", ops);
+        std::printf("%10s %10s %10s %10s %10s %10s %10s %12s %12s\n", "slides", "append", "insert@0",
+            "remove@0", "move", "at", "iterate", "B/version", "vector@0");
+
+        for (size_t count = 1000; count <= 10000000; count *= 10) {
+            Model::Presentation deck("sequence", nullptr);
+
+            Clock::time_point start = Clock::now();
+            for (size_t i = 0; i < count; ++i) {
+                deck.addSlide(slide);
+            }
+            double append = nsPer(start, count);
+
+            start = Clock::now();
+            for (size_t i = 0; i < ops; ++i) {
+                deck.addSlide(slide, 0);
+            }
+            double insertFront = nsPer(start, ops);
+
+            start = Clock::now();
+            for (size_t i = 0; i < ops; ++i) {
+                deck.removeSlide(0);
+            }
+            double removeFront = nsPer(start, ops);
+
+            start = Clock::now();
+            for (size_t i = 0; i < ops; ++i) {
+                std::shared_ptr<Model::Slide> moved = deck.removeSlide(next(count));
+                deck.addSlide(std::move(moved), next(count));
+            }
+            double move = nsPer(start, ops);
+
+            const Model::Presentation& current = deck;
+            std::uint64_t sum = 0;
+            start = Clock::now();
+            for (size_t i = 0; i < ops; ++i) {
+                sum += current.getSlide(next(count))->shapeCount();
+            }
+            double at = nsPer(start, ops);
+
+            start = Clock::now();
+            current.forEachSlide(0, count, [&sum](const Model::Slide& each) { sum += each.shapeCount(); });
+            double iterate = nsPer(start, count);
+
+            // What each kept version holds beyond the live deck after an
+            // edit to one slide
+            std::vector<std::shared_ptr<const Model::Presentation>> versions;
+            versions.reserve(ops);
+            long long before = liveBytes;
+            for (size_t i = 0; i < ops; ++i) {
+                versions.push_back(deck.snapshot());
+                deck.getSlide(next(count));
+            }
+            double versionBytes = static_cast<double>(liveBytes - before) / ops;
+            versions.clear();
+
+            char vectorColumn[32] = "-";
+            if (count <= 1000000) {
+                std::vector<std::shared_ptr<Model::Slide>> flat(count, slide);
+                start = Clock::now();
+                for (size_t i = 0; i < ops; ++i) {
+                    flat.insert(flat.begin(), slide);
+                }
+                std::snprintf(vectorColumn, sizeof(vectorColumn), "%.1f", nsPer(start, ops));
+            }
+
+            std::printf("%10zu %10.1f %10.1f %10.1f %10.1f %10.1f %10.2f %12.0f %12s\n", count, append,
+                insertFront, removeFront, move, at, iterate, versionBytes, vectorColumn);
+            if (sum != 0) std::printf("unexpected shapes\n");
+        }
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options = parseOptions(argc, argv);
+
+    if (options.suite == "render") {
+        runRenderSuite(options);
+    }
+    else if (options.suite == "layout") {
+        runLayoutSuite(options);
+    }
+    else if (options.suite == "model") {
+        runModelSuite(options);
+    }
+    else if (options.suite == "spatial") {
+        runSpatialSuite(options);
+    }
+    else if (options.suite == "sequence") {
+        runSequenceSuite(options);
+    }
+    else {
+        std::fprintf(stderr, "Unknown suite: %s\n", options.suite.c_str());
+        std::fprintf(stderr, "Usage: PP_Bench [render|layout|model|spatial|sequence] [-slides N] [-shapes N] [-iterations N] [-threads N]\n");
+        return 1;
+    }
+
+    return 0;
+}
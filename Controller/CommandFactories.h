@@ -172,6 +172,8 @@ namespace Controller {
             int x = 0, y = 0, width = 100, height = 50;
             std::string text = "";
             std::string color = "black";
+            std::string fontFamily = "Arial";
+            int fontSize = 14;
             size_t slideIndex = 0;
             bool toFront = false;
 
@@ -194,6 +196,14 @@ namespace Controller {
                     color = args[i + 1];
                     i++;
                 }
+                else if (args[i] == "-font" && i + 1 < args.size()) {
+                    fontFamily = args[i + 1];
+                    i++;
+                }
+                else if (args[i] == "-font_size" && i + 1 < args.size()) {
+                    fontSize = std::stoi(args[i + 1]);
+                    i++;
+                }
                 else if (args[i] == "-slide" && i + 1 < args.size()) {
                     slideIndex = std::stoul(args[i + 1]);
                     i++;
@@ -208,7 +218,7 @@ namespace Controller {
             }
 
             return std::unique_ptr<ICommand>(new AddTextCommand(
-                x, y, width, height, text, color, slideIndex, toFront));
+                x, y, width, height, text, color, fontFamily, fontSize, slideIndex, toFront));
         }
 
         std::string getCommandName() const override {
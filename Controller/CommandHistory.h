@@ -4,12 +4,16 @@
 #include <memory>
 
 namespace Controller {
+
+    // Keeps a running total of the bytes its commands hold, taken from each
+    // command as it is added, so memoryUsage() does not walk the history.
     class CommandHistory {
     private:
         std::vector<std::unique_ptr<ICommand> > history_;
         size_t currentIndex_;
+        size_t commandBytes_;
 
-        CommandHistory() : currentIndex_(0) {}
+        CommandHistory() : currentIndex_(0), commandBytes_(0) {}
         CommandHistory(const CommandHistory&);
         CommandHistory& operator=(const CommandHistory&);
 
@@ -21,12 +25,14 @@ namespace Controller {
 
         void executeCommand(std::unique_ptr<ICommand> cmd) {
             while (history_.size() > currentIndex_) {
+                commandBytes_ -= history_.back()->memoryUsage();
                 history_.pop_back();
             }
 
             cmd->execute();
 
             if (cmd->isUndoable()) {
+                commandBytes_ += cmd->memoryUsage();
                 history_.push_back(std::move(cmd));
                 currentIndex_++;
             }
@@ -64,9 +70,15 @@ namespace Controller {
             return history_.size();
         }
 
+        // The commands and the list holding them
+        size_t memoryUsage() const {
+            return commandBytes_ + history_.capacity() * sizeof(std::unique_ptr<ICommand>);
+        }
+
         void clear() {
             history_.clear();
             currentIndex_ = 0;
+            commandBytes_ = 0;
         }
     };
 
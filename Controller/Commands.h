@@ -1,5 +1,6 @@
 #pragma once
 #include "ICommand.h"
+#include "CommandHistory.h"
 #include "../Model/Model.h"
 #include "../Model/Slide.h"
 #include "../Model/Shapes.h"
@@ -24,9 +25,9 @@ namespace Controller {
         }
 
         void execute() override {
-            auto& model = Model::Model::getInstance();
             auto& view = View::ViewFacade::getInstance();
-            model.createPresentation(title_);
+            Application::Application::getInstance().createPresentation(title_);
+            CommandHistory::getInstance().clear();
             view.showSuccess("Created presentation: '" + title_ + "'");
         }
 
@@ -43,14 +44,14 @@ namespace Controller {
         }
 
         void execute() override {
-            auto& model = Model::Model::getInstance();
             auto& view = View::ViewFacade::getInstance();
 
             try {
 
                 Serialization::JsonDeserialize loader;
                 std::unique_ptr<Model::Presentation> pres = loader.load(filepath_);
-                model.setPresentation(std::move(pres));
+                Application::Application::getInstance().setPresentation(std::move(pres));
+                CommandHistory::getInstance().clear();
                 view.showSuccess("Presentation loaded from '" + filepath_ + "'");
             }
             catch (const std::exception& e) {
@@ -117,7 +118,7 @@ namespace Controller {
                 return;
             }
 
-            std::unique_ptr<Model::Slide> slide = std::make_unique<Model::Slide>();
+            std::unique_ptr<Model::Slide> slide = model.getPresentation()->makeSlide();
             std::unique_ptr<Application::IAction> action =
                 std::make_unique<Application::AddSlideAction>(std::move(slide), position_, hasPosition_);
 
@@ -132,6 +133,7 @@ namespace Controller {
         }
 
         bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
     };
 
     class RemoveSlideCommand : public ICommand {
@@ -177,8 +179,19 @@ namespace Controller {
         }
 
         bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
     };
 
+    // The id of the shape just added to a slide, which is always on top
+    inline std::string newShapeId(size_t slideIndex) {
+        const Model::Presentation& presentation = *Model::Model::getInstance().getPresentation();
+        const Model::Slide* slide = presentation.getSlide(slideIndex);
+        if (slide->shapeCount() == 0) {
+            return "#0";
+        }
+        return "#" + std::to_string(static_cast<unsigned long long>(slide->shapeId(slide->shapeCount() - 1)));
+    }
+
     class AddShapeCommand : public ICommand {
         std::string shapeType_;
         int x_, y_, width_, height_;
@@ -249,7 +262,7 @@ namespace Controller {
                 app.getEditor().doAction(std::move(action), model.getPresentation());
 
                 view.showSuccess("Added " + shapeType_ + " to slide " +
-                    std::to_string(static_cast<long long>(slideIndex_)));
+                    std::to_string(static_cast<long long>(slideIndex_)) + " as shape " + newShapeId(slideIndex_));
                 executed_ = true;
             }
         }
@@ -259,19 +272,27 @@ namespace Controller {
         }
 
         bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override {
+            return sizeof(*this) + stringBytes(shapeType_) + stringBytes(color_) + stringBytes(fillColor_) +
+                stringBytes(text_);
+        }
     };
 
     class AddTextCommand : public ICommand {
         int x_, y_, width_, height_;
         std::string text_;
         std::string color_;
+        std::string fontFamily_;
+        int fontSize_;
         size_t slideIndex_;
         bool toFront_;
         bool executed_;
 
     public:
-        AddTextCommand(int x, int y, int width, int height, std::string text, std::string color, size_t slideIndex, bool toFront = false)
-            : x_(x), y_(y), width_(width), height_(height), text_(text), color_(color), slideIndex_(slideIndex),
+        AddTextCommand(int x, int y, int width, int height, std::string text, std::string color,
+            std::string fontFamily, int fontSize, size_t slideIndex, bool toFront = false)
+            : x_(x), y_(y), width_(width), height_(height), text_(text), color_(color),
+            fontFamily_(fontFamily), fontSize_(fontSize), slideIndex_(slideIndex),
             toFront_(toFront), executed_(false) {
         }
 
@@ -293,7 +314,7 @@ namespace Controller {
             }
 
             Model::BoundingBox bounds(x_, y_, width_, height_);
-            std::unique_ptr<Model::IShape> shape = std::make_unique<Model::TextShape>(bounds, text_, color_);
+            std::unique_ptr<Model::IShape> shape = std::make_unique<Model::TextShape>(bounds, text_, color_, fontFamily_, fontSize_);
 
             if (shape.get()) {
 
@@ -303,7 +324,7 @@ namespace Controller {
                 app.getEditor().doAction(std::move(action), model.getPresentation());
 
                 view.showSuccess("Added text to slide " +
-                    std::to_string(static_cast<long long>(slideIndex_)));
+                    std::to_string(static_cast<long long>(slideIndex_)) + " as shape " + newShapeId(slideIndex_));
                 executed_ = true;
             }
         }
@@ -313,6 +334,9 @@ namespace Controller {
         }
 
         bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override {
+            return sizeof(*this) + stringBytes(text_) + stringBytes(color_) + stringBytes(fontFamily_);
+        }
     };
 
     class ShowCommand : public ICommand {
@@ -333,9 +357,18 @@ namespace Controller {
                 const Model::Slide* slide = pres->getSlide(i);
                 std::vector<std::string> shapes;
 
-                std::vector<Model::IShape*> sortedShapes = slide->getShapesByZOrder();
-                for (size_t j = 0; j < sortedShapes.size(); ++j) {
-                    shapes.push_back(sortedShapes[j]->getDescription());
+                // A group is listed where its shapes start, with them indented
+                // under it
+                for (size_t j = slide->bottomShape(); j != Model::Slide::npos; j = slide->shapeAbove(j)) {
+                    slide->forGroupsStartingAt(j, [slide, &shapes](size_t group, size_t outer) {
+                        shapes.push_back(std::string(2 * outer, ' ') + "#" +
+                            std::to_string(static_cast<unsigned long long>(slide->groupId(group))) + " Group of " +
+                            std::to_string(static_cast<long long>(slide->groupSize(group))) + " shape(s) " +
+                            slide->groupBounds(group).describe());
+                    });
+                    shapes.push_back(std::string(2 * slide->groupDepth(j), ' ') + "#" +
+                        std::to_string(static_cast<unsigned long long>(slide->shapeId(j))) + " " +
+                        slide->getShapes()[j].getDescription(slide->shapeBounds(j)));
                 }
 
                 slidesData.push_back(std::make_pair("", shapes));
@@ -389,8 +422,10 @@ namespace Controller {
                     return;
                 }
 
-                Model::Slide* sourceSlide = model.getPresentation()->getSlide(sourcePosition_);
-                std::unique_ptr<Model::Slide> clonedSlide = sourceSlide->clone();
+                // Read through the const overload, which does not copy a
+                // slide shared with the undo history
+                const Model::Presentation& current = *model.getPresentation();
+                std::unique_ptr<Model::Slide> clonedSlide = current.getSlide(sourcePosition_)->clone();
 
                 std::unique_ptr<Application::IAction> action =
                     std::make_unique<Application::AddSlideAction>(std::move(clonedSlide));
@@ -412,6 +447,7 @@ namespace Controller {
         }
 
         bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
     };
 
     class MoveSlideCommand : public ICommand {
@@ -454,17 +490,10 @@ namespace Controller {
                     adjustedToPosition = toPosition_ - 1;
                 }
 
-                Model::Slide* sourceSlide = model.getPresentation()->getSlide(fromPosition_);
-                std::unique_ptr<Model::Slide> clonedSlide = sourceSlide->clone();
-
-                auto compositeAction = std::make_unique<Application::CompositeAction>();
-
-                compositeAction->addAction(std::make_unique<Application::RemoveSlideAction>(fromPosition_));
-
-                compositeAction->addAction(
-                    std::make_unique<Application::AddSlideAction>(std::move(clonedSlide), adjustedToPosition, true));
+                std::unique_ptr<Application::IAction> action =
+                    std::make_unique<Application::MoveSlideAction>(fromPosition_, adjustedToPosition);
 
-                app.getEditor().doAction(std::move(compositeAction), model.getPresentation());
+                app.getEditor().doAction(std::move(action), model.getPresentation());
 
                 view.showSuccess("Moved slide from position " +
                     std::to_string(static_cast<long long>(fromPosition_)) + " to position " +
@@ -482,6 +511,7 @@ namespace Controller {
         }
 
         bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
     };
 
     class HelpCommand : public ICommand {
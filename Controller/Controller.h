@@ -3,6 +3,15 @@
 #include "CommandRegistry.h"
 #include "CommandFactories.h"
 #include "RenderCommand.h"
+#include "ExportHtmlCommand.h"
+#include "ExportPdfCommand.h"
+#include "RenderThumbnailsCommand.h"
+#include "WatchCommand.h"
+#include "TransformShapesCommand.h"
+#include "PickShapesCommand.h"
+#include "ShapeCommands.h"
+#include "GroupCommands.h"
+#include "StatsCommand.h"
 #include "CommandHistory.h"
 #include "../Model/Model.h"
 #include "../Viewer/View.h"
@@ -39,10 +48,28 @@ namespace Controller {
             registry.registerCommand(std::unique_ptr<ICommandFactory>(new MoveSlideFactory()));
             registry.registerCommand(std::unique_ptr<ICommandFactory>(new AddShapeFactory()));
             registry.registerCommand(std::unique_ptr<ICommandFactory>(new AddTextFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new RemoveShapeFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new MoveShapeFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new RestackShapeFactory(Application::Restack::BRING_TO_FRONT)));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new RestackShapeFactory(Application::Restack::SEND_TO_BACK)));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new RestackShapeFactory(Application::Restack::RAISE)));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new RestackShapeFactory(Application::Restack::LOWER)));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new GroupFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new UngroupFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new CloneGroupFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new TranslateShapesFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new ScaleShapesFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new PickFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new SelectFactory()));
             registry.registerCommand(std::unique_ptr<ICommandFactory>(new ShowFactory()));
             registry.registerCommand(std::unique_ptr<ICommandFactory>(new RenderFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new ExportHtmlFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new ExportPdfFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new RenderThumbnailsFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new WatchFactory()));
             registry.registerCommand(std::unique_ptr<ICommandFactory>(new UndoFactory()));
             registry.registerCommand(std::unique_ptr<ICommandFactory>(new RedoFactory()));
+            registry.registerCommand(std::unique_ptr<ICommandFactory>(new StatsFactory()));
             registry.registerCommand(std::unique_ptr<ICommandFactory>(new HelpFactory()));
             registry.registerCommand(std::unique_ptr<ICommandFactory>(new ExitFactory()));
         }
@@ -81,7 +108,10 @@ namespace Controller {
                         commandName == "help" || commandName == "show" ||
                         commandName == "exit" || commandName == "create_presentation" ||
                         commandName == "load_presentation" || commandName == "save_presentation" ||
-                        commandName == "render") {
+                        commandName == "render" || commandName == "export_html" ||
+                        commandName == "export_pdf" || commandName == "render_thumbnails" ||
+                        commandName == "watch" || commandName == "pick" ||
+                        commandName == "select" || commandName == "stats") {
 
                         command->execute();
                     }
@@ -0,0 +1,176 @@
+#pragma once
+#include "ICommand.h"
+#include "ICommandFactory.h"
+#include "PagedRenderer.h"
+#include "../Model/Model.h"
+#include "../Viewer/View.h"
+#include "../Painting/SVGPainter.h"
+#include "../Painting/TransformedPainter.h"
+#include "../Visualization/DeckLayout.h"
+#include "../Visualization/DeckPainter.h"
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Controller {
+
+    // Writes a self-contained HTML slideshow with an inline SVG per slide.
+    // The first few slides are inline; the rest sit in <template> blocks that
+    // a small script materializes as they scroll into view. Each slide is
+    // painted straight into the file stream, so the document is never held
+    // in memory.
+    class ExportHtmlCommand : public ICommand {
+        std::string outputPath_;
+        size_t eagerSlides_;
+        bool minify_;
+
+        // Space above a slide's title inside its own SVG
+        static const int kSlideTopMargin = 20;
+
+        static const char* lazyLoadScript() {
+            return
+                "<script>\n"
+                "(function () {\n"
+                "  function materialize(slide) {\n"
+                "    var template = slide.querySelector('template');\n"
+                "    if (template) slide.replaceChild(document.importNode(template.content, true), template);\n"
+                "  }\n"
+                "  var slides = document.querySelectorAll('section.slide.lazy');\n"
+                "  if (!('IntersectionObserver' in window)) {\n"
+                "    Array.prototype.forEach.call(slides, materialize);\n"
+                "    return;\n"
+                "  }\n"
+                "  var observer = new IntersectionObserver(function (entries) {\n"
+                "    entries.forEach(function (entry) {\n"
+                "      if (!entry.isIntersecting) return;\n"
+                "      observer.unobserve(entry.target);\n"
+                "      materialize(entry.target);\n"
+                "    });\n"
+                "  }, { rootMargin: '400px 0px' });\n"
+                "  Array.prototype.forEach.call(slides, function (slide) { observer.observe(slide); });\n"
+                "})();\n"
+                "</script>\n";
+        }
+
+        void writeSlide(std::ostream& out, const Model::Presentation& presentation, size_t slideIndex,
+            const Visualization::DeckPainter& deckPainter) const {
+            const Visualization::DeckLayout layout = Visualization::DeckLayout::compute(presentation, slideIndex, slideIndex + 1);
+            const int shiftY = kSlideTopMargin - Visualization::DeckLayout::kFirstSlideTop;
+            // Full frame height even for empty slides, whose frame is still drawn
+            const int height = kSlideTopMargin + Visualization::DeckLayout::kSlideTitleHeight +
+                Visualization::DeckLayout::kFrameHeight + Visualization::DeckLayout::kSlideSpacing;
+            const bool lazy = slideIndex >= eagerSlides_;
+
+            out << "<section class=\"slide" << (lazy ? " lazy" : "") << "\" id=\"slide-" << slideIndex
+                << "\" style=\"height: " << height << "px\">\n";
+            if (lazy) {
+                out << "<template>\n";
+            }
+
+            Painting::SVGPainter painter(out, layout.canvasWidth(), height,
+                minify_ ? Painting::SVGPainter::Format::MINIFIED : Painting::SVGPainter::Format::PRETTY);
+            painter.setStandalone(false);
+            painter.beginPaint();
+            Painting::TransformedPainter shifted(painter, 0, shiftY);
+            deckPainter.paintSlide(shifted, layout, slideIndex);
+            painter.endPaint();
+
+            if (lazy) {
+                out << "</template>\n";
+            }
+            out << "</section>\n";
+        }
+
+    public:
+        ExportHtmlCommand(std::string outputPath, size_t eagerSlides = 3, bool minify = false)
+            : outputPath_(outputPath), eagerSlides_(eagerSlides), minify_(minify) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded. Create one first.");
+                return;
+            }
+
+            const Model::Presentation* pres = model.getPresentation();
+
+            std::ofstream file(outputPath_.c_str(), std::ios::binary);
+            if (!file) {
+                view.showError("Cannot write to file: " + outputPath_);
+                return;
+            }
+
+            const std::string title = PagedRenderer::escapeHTML(pres->title());
+            file << "<!DOCTYPE html>\n";
+            file << "<html>\n<head>\n<meta charset=\"UTF-8\">\n";
+            file << "<title>" << title << "</title>\n";
+            file << "<style>\n";
+            file << "body { margin: 0; background: #ddd; font-family: Arial, sans-serif; }\n";
+            file << "h1 { width: " << Visualization::DeckLayout::kPageWidth << "px; margin: 20px auto; }\n";
+            file << ".slide { width: " << Visualization::DeckLayout::kPageWidth << "px; margin: 20px auto; background: white; }\n";
+            file << ".slide svg { display: block; }\n";
+            file << "</style>\n</head>\n<body>\n";
+            file << "<h1>" << title << "</h1>\n";
+
+            const Visualization::DeckPainter deckPainter;
+            for (size_t i = 0; i < pres->slideCount(); ++i) {
+                writeSlide(file, *pres, i, deckPainter);
+            }
+
+            if (pres->slideCount() > eagerSlides_) {
+                file << lazyLoadScript();
+            }
+            file << "</body>\n</html>\n";
+            file.close();
+
+            if (!file) {
+                view.showError("Failed writing file: " + outputPath_);
+                return;
+            }
+
+            view.showSuccess("Exported " + std::to_string(static_cast<long long>(pres->slideCount())) +
+                " slide(s) to '" + outputPath_ + "'");
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return false; }
+    };
+
+    class ExportHtmlFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            if (args.size() < 2 || args[1].empty() || args[1][0] == '-') {
+                throw std::runtime_error("export_html requires an output path");
+            }
+
+            size_t eagerSlides = 3;
+            bool minify = false;
+
+            for (size_t i = 2; i < args.size(); ++i) {
+                if (args[i] == "-eager" && i + 1 < args.size()) {
+                    int eager = std::stoi(args[i + 1]);
+                    if (eager < 0) {
+                        throw std::runtime_error("export_html -eager requires a count of zero or more");
+                    }
+                    eagerSlides = static_cast<size_t>(eager);
+                    ++i;
+                }
+                else if (args[i] == "-minify") {
+                    minify = true;
+                }
+            }
+
+            return std::unique_ptr<ICommand>(new ExportHtmlCommand(args[1], eagerSlides, minify));
+        }
+
+        std::string getCommandName() const override {
+            return "export_html";
+        }
+    };
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "ICommand.h"
+#include "ICommandFactory.h"
+#include "../Model/Model.h"
+#include "../Viewer/View.h"
+#include "../Painting/PdfPainter.h"
+#include "../Visualization/DeckLayout.h"
+#include "../Visualization/DeckPainter.h"
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Controller {
+
+    // Writes the presentation as a PDF with one page per slide, each laid out
+    // like render -slide.
+    class ExportPdfCommand : public ICommand {
+        std::string outputPath_;
+
+    public:
+        explicit ExportPdfCommand(std::string outputPath)
+            : outputPath_(outputPath) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded. Create one first.");
+                return;
+            }
+
+            const Model::Presentation* pres = model.getPresentation();
+
+            if (pres->slideCount() == 0) {
+                view.showError("Presentation has no slides. Add slides first.");
+                return;
+            }
+
+            std::vector<char> buffer(1 << 20);
+            std::ofstream file;
+            file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            file.open(outputPath_.c_str(), std::ios::binary);
+            if (!file) {
+                view.showError("Cannot write to file: " + outputPath_);
+                return;
+            }
+
+            const Visualization::DeckPainter deckPainter;
+            Painting::PdfPainter painter(file);
+            for (size_t i = 0; i < pres->slideCount(); ++i) {
+                const Visualization::DeckLayout layout = Visualization::DeckLayout::compute(*pres, i, i + 1);
+                painter.setPageSize(layout.canvasWidth(), layout.canvasHeight());
+                painter.beginPaint();
+                deckPainter.paint(painter, layout);
+                painter.endPaint();
+            }
+            painter.endDocument();
+            file.close();
+
+            if (!file) {
+                view.showError("Failed writing file: " + outputPath_);
+                return;
+            }
+
+            view.showSuccess("Exported " + std::to_string(static_cast<long long>(painter.pageCount())) +
+                " page(s) to '" + outputPath_ + "'");
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return false; }
+    };
+
+    class ExportPdfFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            if (args.size() < 2 || args[1].empty() || args[1][0] == '-') {
+                throw std::runtime_error("export_pdf requires an output path");
+            }
+            return std::unique_ptr<ICommand>(new ExportPdfCommand(args[1]));
+        }
+
+        std::string getCommandName() const override {
+            return "export_pdf";
+        }
+    };
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Controller {
+
+    // Waits for a single file to be saved. On Linux the file's directory is
+    // watched with inotify, so saves that replace the file through a rename
+    // are seen too; elsewhere, or if inotify is unavailable, the file's size
+    // and modification time are polled.
+    //
+    // Editors often write a file in several steps, so a change is reported
+    // only once the file has been quiet for the debounce interval.
+    class FileWatcher {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+    private:
+        struct Signature {
+            bool exists;
+            std::uintmax_t size;
+            std::filesystem::file_time_type modified;
+
+            bool operator==(const Signature& other) const {
+                return exists == other.exists && size == other.size && modified == other.modified;
+            }
+            bool operator!=(const Signature& other) const { return !(*this == other); }
+        };
+
+        std::filesystem::path path_;
+        std::chrono::milliseconds debounce_;
+        std::chrono::milliseconds pollInterval_;
+        Signature last_;
+        int inotifyFd_;
+
+        Signature signature() const {
+            std::error_code error;
+            Signature result{ false, 0, std::filesystem::file_time_type() };
+            result.size = std::filesystem::file_size(path_, error);
+            if (error) return result;
+            result.modified = std::filesystem::last_write_time(path_, error);
+            if (error) return result;
+            result.exists = true;
+            return result;
+        }
+
+#ifdef __linux__
+        void openInotify() {
+            inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (inotifyFd_ < 0) return;
+
+            std::filesystem::path directory = path_.parent_path();
+            if (directory.empty()) directory = ".";
+            const std::uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM;
+            if (inotify_add_watch(inotifyFd_, directory.c_str(), mask) < 0) {
+                close(inotifyFd_);
+                inotifyFd_ = -1;
+            }
+        }
+
+        // Waits up to timeoutMs (-1 for ever) and drains the queue; true if
+        // any event named the watched file
+        bool readEvents(int timeoutMs) {
+            pollfd descriptor{ inotifyFd_, POLLIN, 0 };
+            if (poll(&descriptor, 1, timeoutMs) <= 0) return false;
+
+            const std::string name = path_.filename().string();
+            alignas(inotify_event) char buffer[4096];
+            bool matched = false;
+            for (;;) {
+                ssize_t length = read(inotifyFd_, buffer, sizeof(buffer));
+                if (length <= 0) break;
+                for (ssize_t offset = 0; offset < length;) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    if (event->len > 0 && name == event->name) {
+                        matched = true;
+                    }
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+            }
+            return matched;
+        }
+
+        bool waitInotify(Clock::time_point& firstEvent) {
+            for (;;) {
+                if (!readEvents(-1)) continue;
+                firstEvent = Clock::now();
+
+                while (readEvents(static_cast<int>(debounce_.count()))) {
+                }
+
+                // A touch or an editor's backup dance can leave the file as it was
+                Signature current = signature();
+                if (current != last_) {
+                    last_ = current;
+                    return current.exists;
+                }
+            }
+        }
+#endif
+
+        bool waitPolling(Clock::time_point& firstEvent) {
+            for (;;) {
+                std::this_thread::sleep_for(pollInterval_);
+                Signature current = signature();
+                if (current == last_) continue;
+                firstEvent = Clock::now();
+
+                // Keep polling until the file stops changing
+                Clock::time_point quietSince = firstEvent;
+                while (Clock::now() - quietSince < debounce_) {
+                    std::this_thread::sleep_for(std::min(pollInterval_, debounce_));
+                    Signature next = signature();
+                    if (next != current) {
+                        current = next;
+                        quietSince = Clock::now();
+                    }
+                }
+
+                last_ = current;
+                return current.exists;
+            }
+        }
+
+    public:
+        FileWatcher(const std::string& path, std::chrono::milliseconds debounce,
+            std::chrono::milliseconds pollInterval = std::chrono::milliseconds(100))
+            : path_(path), debounce_(debounce), pollInterval_(pollInterval), inotifyFd_(-1) {
+            last_ = signature();
+#ifdef __linux__
+            openInotify();
+#endif
+        }
+
+        ~FileWatcher() {
+#ifdef __linux__
+            if (inotifyFd_ >= 0) {
+                close(inotifyFd_);
+            }
+#endif
+        }
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        bool usesInotify() const {
+            return inotifyFd_ >= 0;
+        }
+
+        // Blocks until the file has changed and settled. Returns false if it
+        // was deleted and not recreated within the debounce interval.
+        // firstEvent is set to when the change was first seen.
+        bool waitForChange(Clock::time_point& firstEvent) {
+#ifdef __linux__
+            if (usesInotify()) {
+                return waitInotify(firstEvent);
+            }
+#endif
+            return waitPolling(firstEvent);
+        }
+    };
+
+}
@@ -0,0 +1,234 @@
+#pragma once
+#include "ICommand.h"
+#include "ICommandFactory.h"
+#include "ShapeCommands.h"
+#include "../Model/Model.h"
+#include "../Viewer/View.h"
+#include "../Application/Application.h"
+#include "../Application/Actions.h"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Controller {
+
+    // Making and unmaking groups. Once made, a group is moved, restacked and
+    // removed by its id through the shape commands.
+
+    class GroupCommand : public ICommand {
+        std::vector<std::uint64_t> ids_;
+        bool executed_;
+
+    public:
+        explicit GroupCommand(std::vector<std::uint64_t> ids)
+            : ids_(std::move(ids)), executed_(false) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+            executed_ = false;
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded.");
+                return;
+            }
+
+            const Model::Presentation& current = *model.getPresentation();
+            size_t slideIndex = 0;
+            size_t parent = Model::Slide::npos;
+            for (size_t i = 0; i < ids_.size(); ++i) {
+                size_t at = 0, index = 0;
+                bool group = false;
+                if (!findShapeOrGroup(current, ids_[i], at, index, group)) {
+                    view.showError("No shape with id " + describeShapeId(ids_[i]));
+                    return;
+                }
+                const Model::Slide* slide = current.getSlide(at);
+                size_t around = group ? slide->parentGroup(index) : slide->groupOf(index);
+                if (i == 0) {
+                    slideIndex = at;
+                    parent = around;
+                }
+                else if (at != slideIndex) {
+                    view.showError("Shapes to group must be on the same slide");
+                    return;
+                }
+                else if (around != parent) {
+                    view.showError("Shapes to group must be in the same group, or in none");
+                    return;
+                }
+            }
+
+            std::unique_ptr<Application::IAction> action =
+                std::make_unique<Application::GroupShapesAction>(slideIndex, ids_);
+            if (!Application::Application::getInstance().getEditor().doAction(std::move(action), model.getPresentation())) {
+                view.showError("Each shape or group can be named only once");
+                return;
+            }
+
+            const Model::Slide* slide = current.getSlide(slideIndex);
+            const size_t group = slide->groupCount() - 1;
+            view.showSuccess("Grouped " + std::to_string(static_cast<long long>(ids_.size())) + " item(s) on slide " +
+                std::to_string(static_cast<long long>(slideIndex)) + " as group " + describeShapeId(slide->groupId(group)) +
+                ", " + slide->groupBounds(group).describe());
+            executed_ = true;
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this) + ids_.capacity() * sizeof(std::uint64_t); }
+    };
+
+    class UngroupCommand : public ICommand {
+        std::uint64_t groupId_;
+        bool executed_;
+
+    public:
+        explicit UngroupCommand(std::uint64_t groupId)
+            : groupId_(groupId), executed_(false) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded.");
+                executed_ = false;
+                return;
+            }
+
+            size_t slideIndex = 0, groupIndex = 0;
+            if (!model.getPresentation()->findGroup(groupId_, slideIndex, groupIndex)) {
+                view.showError("No group with id " + describeShapeId(groupId_));
+                executed_ = false;
+                return;
+            }
+
+            std::unique_ptr<Application::IAction> action = std::make_unique<Application::UngroupAction>(groupId_);
+            Application::Application::getInstance().getEditor().doAction(std::move(action), model.getPresentation());
+
+            view.showSuccess("Ungrouped group " + describeShapeId(groupId_) + " on slide " +
+                std::to_string(static_cast<long long>(slideIndex)));
+            executed_ = true;
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
+    };
+
+    // Copies a group, nested groups and all, onto the top of its slide
+    class CloneGroupCommand : public ICommand {
+        std::uint64_t groupId_;
+        int dx_, dy_;
+        bool executed_;
+
+    public:
+        CloneGroupCommand(std::uint64_t groupId, int dx, int dy)
+            : groupId_(groupId), dx_(dx), dy_(dy), executed_(false) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded.");
+                executed_ = false;
+                return;
+            }
+
+            const Model::Presentation& current = *model.getPresentation();
+            size_t slideIndex = 0, groupIndex = 0;
+            if (!current.findGroup(groupId_, slideIndex, groupIndex)) {
+                view.showError("No group with id " + describeShapeId(groupId_));
+                executed_ = false;
+                return;
+            }
+
+            std::unique_ptr<Model::GroupShape> copy = current.getSlide(slideIndex)->getGroup(groupIndex);
+            copy->translate(dx_, dy_);
+            std::unique_ptr<Application::IAction> action =
+                std::make_unique<Application::AddShapeAction>(slideIndex, std::move(copy));
+            Application::Application::getInstance().getEditor().doAction(std::move(action), model.getPresentation());
+
+            const Model::Slide* slide = current.getSlide(slideIndex);
+            const size_t group = slide->groupCount() - 1;
+            view.showSuccess("Cloned group " + describeShapeId(groupId_) + " as group " +
+                describeShapeId(slide->groupId(group)) + ", " + slide->groupBounds(group).describe());
+            executed_ = true;
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
+    };
+
+    class GroupFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            if (args.size() < 3) {
+                throw std::runtime_error("group requires at least two shape or group ids");
+            }
+            std::vector<std::uint64_t> ids;
+            for (size_t i = 1; i < args.size(); ++i) {
+                ids.push_back(parseShapeId(args[i], "group"));
+            }
+            return std::unique_ptr<ICommand>(new GroupCommand(std::move(ids)));
+        }
+
+        std::string getCommandName() const override {
+            return "group";
+        }
+    };
+
+    class UngroupFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            if (args.size() != 2) {
+                throw std::runtime_error("ungroup requires a group id");
+            }
+            return std::unique_ptr<ICommand>(new UngroupCommand(parseShapeId(args[1], "ungroup")));
+        }
+
+        std::string getCommandName() const override {
+            return "ungroup";
+        }
+    };
+
+    class CloneGroupFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            if (args.size() < 2) {
+                throw std::runtime_error("clone_group requires a group id");
+            }
+            std::uint64_t groupId = parseShapeId(args[1], "clone_group");
+            int dx = 0, dy = 0;
+
+            for (size_t i = 2; i < args.size(); ++i) {
+                if (args[i] == "-dx" && i + 1 < args.size()) {
+                    dx = std::stoi(args[i + 1]);
+                    ++i;
+                }
+                else if (args[i] == "-dy" && i + 1 < args.size()) {
+                    dy = std::stoi(args[i + 1]);
+                    ++i;
+                }
+                else {
+                    throw std::runtime_error("Unknown clone_group option: " + args[i]);
+                }
+            }
+
+            return std::unique_ptr<ICommand>(new CloneGroupCommand(groupId, dx, dy));
+        }
+
+        std::string getCommandName() const override {
+            return "clone_group";
+        }
+    };
+
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 
 namespace Controller {
 
@@ -8,6 +9,16 @@ namespace Controller {
         virtual void execute() = 0;
         virtual void undo() = 0;
         virtual bool isUndoable() const = 0;
+
+        // Bytes the command holds while CommandHistory keeps it; only
+        // undoable commands are kept
+        virtual size_t memoryUsage() const { return 0; }
+
+    protected:
+        // Heap storage behind a string, none if it fits in the object
+        static size_t stringBytes(const std::string& value) {
+            return value.capacity() > std::string().capacity() ? value.capacity() + 1 : 0;
+        }
     };
 
 }
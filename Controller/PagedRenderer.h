@@ -0,0 +1,106 @@
+#pragma once
+#include "WorkerPool.h"
+#include "../Model/Presentation.h"
+#include "../Painting/SVGPainter.h"
+#include "../Visualization/DeckLayout.h"
+#include "../Visualization/DeckPainter.h"
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Controller {
+
+    // Lays a presentation out on fixed-size pages of slidesPerPage slides and
+    // streams them as one HTML document with a section holding an inline SVG
+    // per page. Every page's layout is computed up front, so pages can be
+    // painted independently; a batch of one page per worker is painted at a
+    // time and written in order, which bounds memory by that batch.
+    class PagedRenderer {
+        size_t slidesPerPage_;
+        Painting::SVGPainter::Format format_;
+        size_t threadCount_;
+
+    public:
+        static std::string escapeHTML(const std::string& text) {
+            std::string result;
+            result.reserve(text.size());
+            for (char c : text) {
+                switch (c) {
+                case '&':  result += "&amp;"; break;
+                case '<':  result += "&lt;"; break;
+                case '>':  result += "&gt;"; break;
+                case '"':  result += "&quot;"; break;
+                default:   result += c; break;
+                }
+            }
+            return result;
+        }
+
+        PagedRenderer(size_t slidesPerPage, Painting::SVGPainter::Format format, size_t threadCount = 0)
+            : slidesPerPage_(std::max<size_t>(1, slidesPerPage)), format_(format), threadCount_(threadCount) {
+        }
+
+        std::vector<Visualization::DeckLayout> paginate(const Model::Presentation& presentation) const {
+            std::vector<Visualization::DeckLayout> pages;
+            pages.reserve((presentation.slideCount() + slidesPerPage_ - 1) / slidesPerPage_);
+            for (size_t first = 0; first < presentation.slideCount(); first += slidesPerPage_) {
+                size_t last = std::min(presentation.slideCount(), first + slidesPerPage_);
+                pages.push_back(Visualization::DeckLayout::compute(presentation, first, last));
+            }
+            return pages;
+        }
+
+        // Height of every page: a full page of slides, whatever the page holds
+        int pageHeight() const {
+            return std::max(600, 100 + static_cast<int>(slidesPerPage_) * 250);
+        }
+
+        std::string renderPage(const Visualization::DeckLayout& page, const Visualization::DeckPainter& deckPainter) const {
+            Painting::SVGPainter painter(page.canvasWidth(), pageHeight(), format_);
+            painter.setStandalone(false);
+            painter.beginPaint();
+            deckPainter.paint(painter, page);
+            painter.endPaint();
+            return painter.getSVG();
+        }
+
+        // Writes the document and returns the number of pages
+        size_t render(const Model::Presentation& presentation, std::ostream& out) const {
+            const std::vector<Visualization::DeckLayout> pages = paginate(presentation);
+            const Visualization::DeckPainter deckPainter;
+            WorkerPool pool(threadCount_);
+
+            out << "<!DOCTYPE html>\n";
+            out << "<html>\n<head>\n<meta charset=\"UTF-8\">\n";
+            out << "<title>" << escapeHTML(presentation.title()) << "</title>\n";
+            out << "<style>\n";
+            out << "body { margin: 0; background: #ddd; }\n";
+            out << ".page { width: " << Visualization::DeckLayout::kPageWidth << "px; margin: 20px auto; "
+                << "background: white; page-break-after: always; }\n";
+            out << ".page svg { display: block; }\n";
+            out << "</style>\n</head>\n<body>\n";
+
+            std::vector<std::string> batch(pool.getThreadCount());
+            for (size_t first = 0; first < pages.size(); first += batch.size()) {
+                size_t count = std::min(batch.size(), pages.size() - first);
+                pool.forEach(count, [&](size_t i, size_t) {
+                    batch[i] = renderPage(pages[first + i], deckPainter);
+                });
+
+                for (size_t i = 0; i < count; ++i) {
+                    const Visualization::DeckLayout& page = pages[first + i];
+                    out << "<section class=\"page\" id=\"page-" << (first + i + 1) << "\" data-slides=\""
+                        << page.startSlide() << "-" << (page.endSlide() - 1) << "\">\n";
+                    out << batch[i];
+                    out << "</section>\n";
+                    std::string().swap(batch[i]);
+                }
+            }
+
+            out << "</body>\n</html>\n";
+            return pages.size();
+        }
+    };
+
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include "ICommand.h"
+#include "ICommandFactory.h"
+#include "../Model/Model.h"
+#include "../Viewer/View.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Controller {
+
+    // Hit tests on one slide. Both only read the deck, so they bypass the
+    // history; the slide's spatial index answers them without scanning every
+    // shape.
+
+    inline std::string describe(const Model::Slide& slide, size_t index) {
+        return "#" + std::to_string(static_cast<unsigned long long>(slide.shapeId(index))) + " " +
+            slide.getShapes()[index].getDescription(slide.shapeBounds(index));
+    }
+
+    class PickCommand : public ICommand {
+        size_t slideIndex_;
+        int x_, y_;
+
+    public:
+        PickCommand(size_t slideIndex, int x, int y)
+            : slideIndex_(slideIndex), x_(x), y_(y) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded.");
+                return;
+            }
+
+            const Model::Presentation* pres = model.getPresentation();
+            if (slideIndex_ >= pres->slideCount()) {
+                view.showError("Slide index out of range");
+                return;
+            }
+
+            const Model::Slide* slide = pres->getSlide(slideIndex_);
+            size_t index = slide->pick(x_, y_);
+            if (index == Model::Slide::npos) {
+                view.showInfo("No shape at (" + std::to_string(x_) + ", " + std::to_string(y_) + ")");
+                return;
+            }
+
+            view.showInfo("Topmost shape at (" + std::to_string(x_) + ", " + std::to_string(y_) + "):");
+            std::vector<std::pair<size_t, std::string>> shapes;
+            shapes.push_back(std::make_pair(slide->zPosition(index), describe(*slide, index)));
+            view.showShapeList(shapes);
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return false; }
+    };
+
+    class SelectCommand : public ICommand {
+        size_t slideIndex_;
+        Model::BoundingBox region_;
+        bool inside_;
+
+    public:
+        SelectCommand(size_t slideIndex, const Model::BoundingBox& region, bool inside)
+            : slideIndex_(slideIndex), region_(region), inside_(inside) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded.");
+                return;
+            }
+
+            const Model::Presentation* pres = model.getPresentation();
+            if (slideIndex_ >= pres->slideCount()) {
+                view.showError("Slide index out of range");
+                return;
+            }
+
+            const Model::Slide* slide = pres->getSlide(slideIndex_);
+            std::vector<size_t> found = slide->select(region_, inside_);
+
+            // found is back to front, so one walk up the z-order numbers them
+            std::vector<std::pair<size_t, std::string>> shapes;
+            shapes.reserve(found.size());
+            size_t position = 0, next = 0;
+            for (size_t i = slide->bottomShape(); i != Model::Slide::npos && next < found.size();
+                i = slide->shapeAbove(i), ++position) {
+                if (i == found[next]) {
+                    shapes.push_back(std::make_pair(position, describe(*slide, i)));
+                    ++next;
+                }
+            }
+            view.showInfo("Selected " + std::to_string(static_cast<long long>(found.size())) + " shape(s) " +
+                (inside_ ? "inside" : "overlapping") + " the region " + region_.describe());
+            view.showShapeList(shapes);
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return false; }
+    };
+
+    class PickFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            size_t slideIndex = 0;
+            std::vector<int> point;
+
+            for (size_t i = 1; i < args.size(); ++i) {
+                if (args[i] == "-slide") {
+                    if (i + 1 >= args.size()) {
+                        throw std::runtime_error("pick -slide requires an index");
+                    }
+                    slideIndex = std::stoul(args[i + 1]);
+                    ++i;
+                }
+                else {
+                    point.push_back(std::stoi(args[i]));
+                }
+            }
+
+            if (point.size() != 2) {
+                throw std::runtime_error("pick requires a point: pick -slide <index> <x> <y>");
+            }
+
+            return std::unique_ptr<ICommand>(new PickCommand(slideIndex, point[0], point[1]));
+        }
+
+        std::string getCommandName() const override {
+            return "pick";
+        }
+    };
+
+    class SelectFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            size_t slideIndex = 0;
+            bool hasRegion = false, inside = false;
+            int x = 0, y = 0, width = 0, height = 0;
+
+            for (size_t i = 1; i < args.size(); ++i) {
+                if (args[i] == "-slide") {
+                    if (i + 1 >= args.size()) {
+                        throw std::runtime_error("select -slide requires an index");
+                    }
+                    slideIndex = std::stoul(args[i + 1]);
+                    ++i;
+                }
+                else if (args[i] == "-region") {
+                    if (i + 4 >= args.size()) {
+                        throw std::runtime_error("select -region requires x y width height");
+                    }
+                    x = std::stoi(args[i + 1]);
+                    y = std::stoi(args[i + 2]);
+                    width = std::stoi(args[i + 3]);
+                    height = std::stoi(args[i + 4]);
+                    hasRegion = true;
+                    i += 4;
+                }
+                else if (args[i] == "-inside") {
+                    inside = true;
+                }
+                else {
+                    throw std::runtime_error("Unknown select option: " + args[i]);
+                }
+            }
+
+            if (!hasRegion) {
+                throw std::runtime_error("select requires -region <x> <y> <width> <height>");
+            }
+
+            return std::unique_ptr<ICommand>(new SelectCommand(slideIndex, Model::BoundingBox(x, y, width, height), inside));
+        }
+
+        std::string getCommandName() const override {
+            return "select";
+        }
+    };
+
+}
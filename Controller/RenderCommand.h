@@ -1,22 +1,89 @@
 ﻿#pragma once
 #include "ICommand.h"
+#include "ICommandFactory.h"
 #include "../Model/Model.h"
 #include "../Viewer/View.h"
-#include "../Painting/SVGCanvas.h"
 #include "../Painting/SVGPainter.h"
-#include "../Painting/TransformedPainter.h"
+#include "../Visualization/DeckLayout.h"
+#include "../Visualization/DeckPainter.h"
+#include "PagedRenderer.h"
+#include "SplitRenderer.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cctype>
 #include <memory>
 #include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace Controller {
 
     class RenderCommand : public ICommand {
         std::string outputPath_;
         int slideIndex_;
+        bool minify_;
+        size_t threadCount_;
+        std::string splitDir_;
+        size_t slidesPerPage_;
+
+        Painting::SVGPainter::Format format() const {
+            return minify_ ? Painting::SVGPainter::Format::MINIFIED : Painting::SVGPainter::Format::PRETTY;
+        }
+
+        void executeSplit(const Model::Presentation& presentation) {
+            auto& view = View::ViewFacade::getInstance();
+            Painting::SVGPainter::Format svgFormat = format();
+
+            try {
+                SplitRenderer renderer(splitDir_, minify_ ? "minified" : "pretty", threadCount_);
+                auto outputs = renderer.render(presentation, [&](size_t i) {
+                    return renderSVG(presentation, i, i + 1, svgFormat, 1);
+                });
+
+                size_t written = 0;
+                for (const auto& output : outputs) {
+                    if (output.written) ++written;
+                }
+                view.showSuccess("Rendered " + std::to_string(static_cast<long long>(written)) +
+                    " of " + std::to_string(static_cast<long long>(outputs.size())) +
+                    " slide file(s) to '" + splitDir_ + "'");
+            }
+            catch (const std::exception& e) {
+                view.showError(e.what());
+            }
+        }
+
+        void executePaged(const Model::Presentation& presentation) {
+            auto& view = View::ViewFacade::getInstance();
+
+            std::ofstream file(outputPath_.c_str(), std::ios::binary);
+            if (!file) {
+                view.showError("Cannot write to file: " + outputPath_);
+                return;
+            }
+
+            try {
+                PagedRenderer renderer(slidesPerPage_, format(), threadCount_);
+                size_t pageCount = renderer.render(presentation, file);
+                file.close();
+                view.showSuccess("Rendered " + std::to_string(static_cast<long long>(presentation.slideCount())) +
+                    " slide(s) on " + std::to_string(static_cast<long long>(pageCount)) +
+                    " page(s) to '" + outputPath_ + "'");
+            }
+            catch (const std::exception& e) {
+                view.showError(e.what());
+            }
+        }
 
     public:
-        RenderCommand(std::string outputPath, int slideIndex = -1)
-            : outputPath_(outputPath), slideIndex_(slideIndex) {
+        // threadCount 0 uses one worker per hardware thread. A non-empty
+        // splitDir writes one file per slide there instead of outputPath;
+        // a non-zero slidesPerPage writes outputPath as paged HTML.
+        RenderCommand(std::string outputPath, int slideIndex = -1, bool minify = false, size_t threadCount = 0,
+            std::string splitDir = "", size_t slidesPerPage = 0)
+            : outputPath_(outputPath), slideIndex_(slideIndex), minify_(minify), threadCount_(threadCount),
+            splitDir_(splitDir), slidesPerPage_(slidesPerPage) {
         }
 
         void execute() override {
@@ -35,6 +102,16 @@ namespace Controller {
                 return;
             }
 
+            if (!splitDir_.empty()) {
+                executeSplit(*pres);
+                return;
+            }
+
+            if (slidesPerPage_ > 0) {
+                executePaged(*pres);
+                return;
+            }
+
             size_t startSlide = 0;
             size_t endSlide = pres->slideCount();
 
@@ -47,77 +124,7 @@ namespace Controller {
                 endSlide = startSlide + 1;
             }
 
-            int slideHeight = 250;
-            int canvasHeight = 100 + static_cast<int>((endSlide - startSlide) * slideHeight);
-            if (canvasHeight < 600) canvasHeight = 600;
-            if (canvasHeight > 4000) canvasHeight = 4000;
-
-            Painting::SVGCanvas canvas(800, canvasHeight);
-            Painting::SVGPainter& painter = canvas.getPainter();
-
-            canvas.beginDrawing();
-
-            const int leftMargin = 60;
-
-            painter.drawTextLeft(leftMargin, 40, pres->title(), "Arial", 24, "black");
-
-            Painting::Pen titleSeparatorPen("gray", 2, Painting::Pen::Type::SOLID);
-            painter.drawLine(leftMargin, 60, 800 - leftMargin, 60, titleSeparatorPen);
-
-            int yOffset = 90;
-            for (size_t i = startSlide; i < endSlide; ++i) {
-                const Model::Slide* slide = pres->getSlide(i);
-
-                if (i > startSlide) {
-                    Painting::Pen separatorPen("lightgray", 1, Painting::Pen::Type::DASHED);
-                    painter.drawLine(leftMargin, yOffset - 10, 800 - leftMargin, yOffset - 10, separatorPen);
-                }
-
-                std::string slideTitle = "Slide " + std::to_string(static_cast<long long>(i));
-                painter.drawTextLeft(leftMargin, yOffset, slideTitle, "Arial", 18, "blue");
-                yOffset += 30;
-
-                int slideX = leftMargin;
-                int slideY = yOffset;
-                int slideWidth = 800 - 2 * leftMargin;
-                int slideHeightArea = 200;
-                Painting::Pen bgPen("lightgray", 1, Painting::Pen::Type::SOLID);
-                Painting::Brush bgBrush("white", Painting::Brush::Style::SOLID);
-                int bgXPoints[4] = { slideX, slideX + slideWidth, slideX + slideWidth, slideX };
-                int bgYPoints[4] = { slideY, slideY, slideY + slideHeightArea, slideY + slideHeightArea };
-                painter.drawPolygon(bgXPoints, bgYPoints, 4, bgPen, bgBrush);
-
-                int padding = 20;
-                int contentX = slideX + padding;
-                int contentY = slideY + padding;
-                int contentWidth = slideWidth - 2 * padding;
-                int contentHeight = slideHeightArea - 2 * padding;
-
-                std::vector<Model::IShape*> sortedShapes = slide->getShapesByZOrder();
-
-                if (sortedShapes.empty()) {
-
-                    painter.drawTextLeft(
-                        slideX + padding, slideY + slideHeightArea / 2,
-                        "(No shapes on this slide)", "Arial", 12, "gray");
-                    yOffset += 30;
-                }
-                else {
-
-                    Painting::TransformedPainter transformedPainter(painter, contentX, contentY);
-
-                    for (size_t j = 0; j < sortedShapes.size(); ++j) {
-                        sortedShapes[j]->draw(transformedPainter);
-                    }
-                    yOffset += 200;
-                }
-
-                yOffset += 20;
-            }
-
-            canvas.endDrawing();
-
-            std::string svg = canvas.getOutput();
+            std::string svg = renderSVG(*pres, startSlide, endSlide, format(), threadCount_);
             std::ofstream file(outputPath_.c_str());
             if (!file) {
                 view.showError("Cannot write to file: " + outputPath_);
@@ -139,29 +146,139 @@ namespace Controller {
             }
         }
 
+        // Renders slides [startSlide, endSlide) to an SVG document. Runs of
+        // slides are painted concurrently into per-worker buffers and spliced
+        // together in slide order, so the output matches a serial render byte
+        // for byte whatever the thread count.
+        static std::string renderSVG(const Model::Presentation& presentation, size_t startSlide, size_t endSlide,
+            Painting::SVGPainter::Format format, size_t threadCount) {
+            const Visualization::DeckLayout layout = Visualization::DeckLayout::compute(presentation, startSlide, endSlide);
+            const Visualization::DeckPainter deckPainter;
+            Painting::SVGPainter document(layout.canvasWidth(), layout.canvasHeight(), format);
+            const size_t slideCount = layout.slideCount();
+
+            WorkerPool pool(threadCount);
+            if (pool.workersFor(slideCount) <= 1) {
+                document.beginPaint();
+                deckPainter.paint(document, layout);
+                document.endPaint();
+                return document.getSVG();
+            }
+
+            // A few runs per worker keeps threads busy when slides differ in cost
+            const size_t runLength = std::max<size_t>(1, slideCount / (pool.getThreadCount() * 4));
+            const size_t runCount = (slideCount + runLength - 1) / runLength;
+            std::vector<std::string> fragments(runCount);
+
+            std::vector<std::unique_ptr<Painting::SVGPainter>> painters(pool.workersFor(runCount));
+            for (auto& painter : painters) {
+                painter.reset(new Painting::SVGPainter(document.getWidth(), document.getHeight(), format));
+            }
+
+            pool.forEach(runCount, [&](size_t run, size_t worker) {
+                Painting::SVGPainter& painter = *painters[worker];
+                painter.beginFragment();
+                size_t first = startSlide + run * runLength;
+                deckPainter.paintSlides(painter, layout, first, std::min(endSlide, first + runLength));
+                fragments[run] = painter.getSVG();
+            });
+
+            document.beginPaint();
+            deckPainter.paintHeader(document, layout);
+            for (const std::string& fragment : fragments) {
+                document.appendFragment(fragment);
+            }
+            document.endPaint();
+            return document.getSVG();
+        }
+
         void undo() override {}
         bool isUndoable() const override { return false; }
     };
 
     class RenderFactory : public ICommandFactory {
+        static bool hasExtension(const std::string& path, const std::string& extension) {
+            if (path.size() < extension.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < extension.size(); ++i) {
+                char c = path[path.size() - extension.size() + i];
+                if (std::tolower(static_cast<unsigned char>(c)) != extension[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
     public:
         std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
 
             std::string outputPath = "output.svg";
-            if (args.size() >= 2 && !args[1].empty()) {
+            size_t firstOption = 1;
+            bool hasOutputPath = false;
+            if (args.size() >= 2 && !args[1].empty() && args[1][0] != '-') {
                 outputPath = args[1];
+                firstOption = 2;
+                hasOutputPath = true;
             }
 
             int slideIndex = -1;
-
-            for (size_t i = 2; i < args.size(); ++i) {
-                if (args[i] == "-slide" && i + 1 < args.size()) {
+            bool minify = false;
+            size_t threadCount = 0;
+            std::string splitDir;
+            size_t slidesPerPage = 0;
+
+            for (size_t i = firstOption; i < args.size(); ++i) {
+                if (args[i] == "-split") {
+                    if (i + 1 >= args.size() || args[i + 1].empty()) {
+                        throw std::runtime_error("render -split requires an output directory");
+                    }
+                    splitDir = args[i + 1];
+                    ++i;
+                }
+                else if (args[i] == "-slide" && i + 1 < args.size()) {
                     slideIndex = std::stoi(args[i + 1]);
-                    break;
+                    ++i;
+                }
+                else if (args[i] == "-minify") {
+                    minify = true;
+                }
+                else if (args[i] == "-pages" && i + 1 < args.size()) {
+                    int pages = std::stoi(args[i + 1]);
+                    if (pages < 1) {
+                        throw std::runtime_error("render -pages requires a positive number of slides per page");
+                    }
+                    slidesPerPage = static_cast<size_t>(pages);
+                    ++i;
+                }
+                else if (args[i] == "-threads" && i + 1 < args.size()) {
+                    int threads = std::stoi(args[i + 1]);
+                    if (threads < 1) {
+                        throw std::runtime_error("render -threads requires a positive count");
+                    }
+                    threadCount = static_cast<size_t>(threads);
+                    ++i;
+                }
+            }
+
+            // A split directory always holds every slide, with a manifest
+            // listing them all
+            if (!splitDir.empty() && slideIndex >= 0) {
+                throw std::runtime_error("render -split writes every slide; it cannot be combined with -slide");
+            }
+
+            // Pages are written as one HTML document; -split, which wins,
+            // writes no output file
+            if (slidesPerPage > 0 && splitDir.empty()) {
+                if (!hasOutputPath) {
+                    outputPath = "output.html";
+                }
+                else if (!hasExtension(outputPath, ".html") && !hasExtension(outputPath, ".htm")) {
+                    throw std::runtime_error("render -pages writes HTML; give an output file ending in .html");
                 }
             }
 
-            return std::unique_ptr<ICommand>(new RenderCommand(outputPath, slideIndex));
+            return std::unique_ptr<ICommand>(new RenderCommand(outputPath, slideIndex, minify, threadCount, splitDir, slidesPerPage));
         }
 
         std::string getCommandName() const override {
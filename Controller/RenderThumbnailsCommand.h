@@ -0,0 +1,113 @@
+#pragma once
+#include "ICommand.h"
+#include "ICommandFactory.h"
+#include "../Model/Model.h"
+#include "../Viewer/View.h"
+#include "../Painting/SVGPainter.h"
+#include "../Visualization/ThumbnailSheet.h"
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Controller {
+
+    class RenderThumbnailsCommand : public ICommand {
+        std::string outputPath_;
+        size_t columns_;
+        double scale_;
+        bool minify_;
+
+    public:
+        RenderThumbnailsCommand(std::string outputPath, size_t columns = 10, double scale = 0.1, bool minify = false)
+            : outputPath_(outputPath), columns_(columns), scale_(scale), minify_(minify) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded. Create one first.");
+                return;
+            }
+
+            const Model::Presentation* pres = model.getPresentation();
+
+            if (pres->slideCount() == 0) {
+                view.showError("Presentation has no slides. Add slides first.");
+                return;
+            }
+
+            std::vector<char> buffer(1 << 20);
+            std::ofstream file;
+            file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            file.open(outputPath_.c_str(), std::ios::binary);
+            if (!file) {
+                view.showError("Cannot write to file: " + outputPath_);
+                return;
+            }
+
+            Visualization::ThumbnailSheet sheet(*pres, columns_, scale_);
+            Painting::SVGPainter painter(file, sheet.canvasWidth(), sheet.canvasHeight(),
+                minify_ ? Painting::SVGPainter::Format::MINIFIED : Painting::SVGPainter::Format::PRETTY);
+            painter.beginPaint();
+            sheet.paint(painter);
+            painter.endPaint();
+            file.close();
+
+            if (!file) {
+                view.showError("Failed writing file: " + outputPath_);
+                return;
+            }
+
+            view.showSuccess("Rendered " + std::to_string(static_cast<long long>(pres->slideCount())) +
+                " thumbnail(s) to '" + outputPath_ + "'");
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return false; }
+    };
+
+    class RenderThumbnailsFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            if (args.size() < 2 || args[1].empty() || args[1][0] == '-') {
+                throw std::runtime_error("render_thumbnails requires an output path");
+            }
+
+            size_t columns = 10;
+            double scale = 0.1;
+            bool minify = false;
+
+            for (size_t i = 2; i < args.size(); ++i) {
+                if (args[i] == "-cols" && i + 1 < args.size()) {
+                    int cols = std::stoi(args[i + 1]);
+                    if (cols < 1) {
+                        throw std::runtime_error("render_thumbnails -cols requires a positive count");
+                    }
+                    columns = static_cast<size_t>(cols);
+                    ++i;
+                }
+                else if (args[i] == "-scale" && i + 1 < args.size()) {
+                    scale = std::stod(args[i + 1]);
+                    if (!(scale > 0.0 && scale <= 1.0)) {
+                        throw std::runtime_error("render_thumbnails -scale must be in (0, 1]");
+                    }
+                    ++i;
+                }
+                else if (args[i] == "-minify") {
+                    minify = true;
+                }
+            }
+
+            return std::unique_ptr<ICommand>(new RenderThumbnailsCommand(args[1], columns, scale, minify));
+        }
+
+        std::string getCommandName() const override {
+            return "render_thumbnails";
+        }
+    };
+
+}
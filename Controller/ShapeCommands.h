@@ -0,0 +1,290 @@
+#pragma once
+#include "ICommand.h"
+#include "ICommandFactory.h"
+#include "../Model/Model.h"
+#include "../Viewer/View.h"
+#include "../Application/Application.h"
+#include "../Application/Actions.h"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Controller {
+
+    // Edits to one shape, named by the id add_shape, show and pick report,
+    // or to a group as a whole, named by the id group and show report
+
+    inline std::uint64_t parseShapeId(const std::string& arg, const std::string& command) {
+        size_t used = 0;
+        std::uint64_t id = 0;
+        if (!arg.empty() && arg[0] >= '0' && arg[0] <= '9') {
+            try {
+                id = std::stoull(arg, &used);
+            }
+            catch (const std::out_of_range&) {
+                used = 0;
+            }
+        }
+        if (used != arg.size() || id == 0) {
+            throw std::runtime_error(command + " requires a shape id, got: " + arg);
+        }
+        return id;
+    }
+
+    inline std::string describeShapeId(std::uint64_t id) {
+        return "#" + std::to_string(static_cast<unsigned long long>(id));
+    }
+
+    // Where the shape or group with this id is; index is the shape's or the
+    // group's, as group says
+    inline bool findShapeOrGroup(const Model::Presentation& presentation, std::uint64_t id,
+        size_t& slideIndex, size_t& index, bool& group) {
+        group = false;
+        if (presentation.findShape(id, slideIndex, index)) {
+            return true;
+        }
+        group = true;
+        return presentation.findGroup(id, slideIndex, index);
+    }
+
+    class RemoveShapeCommand : public ICommand {
+        std::uint64_t shapeId_;
+        bool executed_;
+
+    public:
+        explicit RemoveShapeCommand(std::uint64_t shapeId)
+            : shapeId_(shapeId), executed_(false) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded.");
+                executed_ = false;
+                return;
+            }
+
+            const Model::Presentation& current = *model.getPresentation();
+            size_t slideIndex = 0, index = 0;
+            bool group = false;
+            if (!findShapeOrGroup(current, shapeId_, slideIndex, index, group)) {
+                view.showError("No shape with id " + describeShapeId(shapeId_));
+                executed_ = false;
+                return;
+            }
+            const size_t shapes = group ? current.getSlide(slideIndex)->groupSize(index) : 1;
+
+            std::unique_ptr<Application::IAction> action = std::make_unique<Application::RemoveShapeAction>(shapeId_);
+            Application::Application::getInstance().getEditor().doAction(std::move(action), model.getPresentation());
+
+            if (group) {
+                view.showSuccess("Removed group " + describeShapeId(shapeId_) + " and its " +
+                    std::to_string(static_cast<long long>(shapes)) + " shape(s) from slide " +
+                    std::to_string(static_cast<long long>(slideIndex)));
+            }
+            else {
+                view.showSuccess("Removed shape " + describeShapeId(shapeId_) + " from slide " +
+                    std::to_string(static_cast<long long>(slideIndex)));
+            }
+            executed_ = true;
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
+    };
+
+    class MoveShapeCommand : public ICommand {
+        std::uint64_t shapeId_;
+        int dx_, dy_;
+        bool executed_;
+
+    public:
+        MoveShapeCommand(std::uint64_t shapeId, int dx, int dy)
+            : shapeId_(shapeId), dx_(dx), dy_(dy), executed_(false) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded.");
+                executed_ = false;
+                return;
+            }
+
+            const Model::Presentation& current = *model.getPresentation();
+            size_t slideIndex = 0, index = 0;
+            bool group = false;
+            if (!findShapeOrGroup(current, shapeId_, slideIndex, index, group)) {
+                view.showError("No shape with id " + describeShapeId(shapeId_));
+                executed_ = false;
+                return;
+            }
+
+            std::unique_ptr<Application::IAction> action =
+                std::make_unique<Application::MoveShapeAction>(shapeId_, dx_, dy_);
+            Application::Application::getInstance().getEditor().doAction(std::move(action), model.getPresentation());
+
+            const Model::Slide* slide = current.getSlide(slideIndex);
+            view.showSuccess("Moved " + std::string(group ? "group " : "shape ") + describeShapeId(shapeId_) +
+                ", now " + (group ? slide->groupBounds(index) : slide->shapeBounds(index)).describe());
+            executed_ = true;
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
+    };
+
+    class RestackShapeCommand : public ICommand {
+        std::uint64_t shapeId_;
+        Application::Restack move_;
+        bool executed_;
+
+        bool towardFront() const {
+            return move_ == Application::Restack::BRING_TO_FRONT || move_ == Application::Restack::RAISE;
+        }
+
+        std::string describeMove(const std::string& what) const {
+            switch (move_) {
+            case Application::Restack::BRING_TO_FRONT: return "Brought " + what + " to the front";
+            case Application::Restack::SEND_TO_BACK: return "Sent " + what + " to the back";
+            case Application::Restack::RAISE: return "Raised " + what + " one step";
+            case Application::Restack::LOWER: return "Lowered " + what + " one step";
+            }
+            return "";
+        }
+
+    public:
+        RestackShapeCommand(std::uint64_t shapeId, Application::Restack move)
+            : shapeId_(shapeId), move_(move), executed_(false) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded.");
+                executed_ = false;
+                return;
+            }
+
+            const Model::Presentation& current = *model.getPresentation();
+            size_t slideIndex = 0, index = 0;
+            bool group = false;
+            if (!findShapeOrGroup(current, shapeId_, slideIndex, index, group)) {
+                view.showError("No shape with id " + describeShapeId(shapeId_));
+                executed_ = false;
+                return;
+            }
+
+            // A grouped shape or group moves only among its group's members,
+            // so "already at the front" is the action's to tell
+            std::unique_ptr<Application::IAction> action =
+                std::make_unique<Application::RestackShapeAction>(shapeId_, move_);
+            const std::string what = (group ? "group " : "shape ") + describeShapeId(shapeId_);
+            if (!Application::Application::getInstance().getEditor().doAction(std::move(action), model.getPresentation())) {
+                std::string message = (group ? "Group " : "Shape ") + describeShapeId(shapeId_) + " is already at the " +
+                    (towardFront() ? "front" : "back");
+                const Model::Slide* slide = current.getSlide(slideIndex);
+                if ((group ? slide->parentGroup(index) : slide->groupOf(index)) != Model::Slide::npos) {
+                    message += " of its group";
+                }
+                view.showInfo(message);
+                executed_ = false;
+                return;
+            }
+
+            view.showSuccess(describeMove(what));
+            executed_ = true;
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
+    };
+
+    class RemoveShapeFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            if (args.size() != 2) {
+                throw std::runtime_error("remove_shape requires a shape id");
+            }
+            return std::unique_ptr<ICommand>(new RemoveShapeCommand(parseShapeId(args[1], "remove_shape")));
+        }
+
+        std::string getCommandName() const override {
+            return "remove_shape";
+        }
+    };
+
+    class MoveShapeFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            if (args.size() < 2) {
+                throw std::runtime_error("move_shape requires a shape id");
+            }
+            std::uint64_t shapeId = parseShapeId(args[1], "move_shape");
+            int dx = 0, dy = 0;
+
+            for (size_t i = 2; i < args.size(); ++i) {
+                if (args[i] == "-dx" && i + 1 < args.size()) {
+                    dx = std::stoi(args[i + 1]);
+                    ++i;
+                }
+                else if (args[i] == "-dy" && i + 1 < args.size()) {
+                    dy = std::stoi(args[i + 1]);
+                    ++i;
+                }
+                else {
+                    throw std::runtime_error("Unknown move_shape option: " + args[i]);
+                }
+            }
+
+            if (dx == 0 && dy == 0) {
+                throw std::runtime_error("move_shape requires a non-zero -dx or -dy");
+            }
+
+            return std::unique_ptr<ICommand>(new MoveShapeCommand(shapeId, dx, dy));
+        }
+
+        std::string getCommandName() const override {
+            return "move_shape";
+        }
+    };
+
+    // One factory per z-order command: bring_to_front, send_to_back, raise
+    // and lower
+    class RestackShapeFactory : public ICommandFactory {
+        Application::Restack move_;
+
+    public:
+        explicit RestackShapeFactory(Application::Restack move) : move_(move) {
+        }
+
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            if (args.size() != 2) {
+                throw std::runtime_error(getCommandName() + " requires a shape id");
+            }
+            return std::unique_ptr<ICommand>(new RestackShapeCommand(parseShapeId(args[1], getCommandName()), move_));
+        }
+
+        std::string getCommandName() const override {
+            switch (move_) {
+            case Application::Restack::BRING_TO_FRONT: return "bring_to_front";
+            case Application::Restack::SEND_TO_BACK: return "send_to_back";
+            case Application::Restack::RAISE: return "raise";
+            case Application::Restack::LOWER: return "lower";
+            }
+            return "";
+        }
+    };
+
+}
@@ -0,0 +1,208 @@
+#pragma once
+#include "WorkerPool.h"
+#include "../Model/Presentation.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Controller {
+
+    // Writes each slide of a presentation to its own SVG file in a directory,
+    // slide_0000.svg, slide_0001.svg, ..., plus a manifest.json listing them.
+    // Slides are rendered and written concurrently; the caller supplies the
+    // document for a single slide.
+    //
+    // Each directory remembers which slide object and generation every file
+    // was written from, so a later render into the same directory rewrites
+    // only slides edited since, and slides that moved to another index. The
+    // record lives for the process; a fresh process rewrites everything once.
+    class SplitRenderer {
+    public:
+        typedef std::function<std::string(size_t slideIndex)> SlideRenderer;
+
+        struct OutputFile {
+            size_t slideIndex;
+            std::string fileName;
+            size_t bytes;
+            std::uint64_t slideId;
+            std::uint64_t generation;
+            bool written;
+        };
+
+    private:
+        static const size_t kWriteBufferSize = 1 << 20;
+
+        // What a directory was last rendered from
+        struct DirectoryState {
+            std::string title;
+            std::string settings;
+            std::vector<OutputFile> files;
+        };
+
+        std::string outputDir_;
+        std::string settings_;
+        size_t threadCount_;
+
+        static std::map<std::string, DirectoryState>& states() {
+            static std::map<std::string, DirectoryState> instance;
+            return instance;
+        }
+
+        static std::mutex& statesMutex() {
+            static std::mutex instance;
+            return instance;
+        }
+
+        std::string stateKey() const {
+            std::error_code error;
+            std::filesystem::path path = std::filesystem::weakly_canonical(outputDir_, error);
+            return error ? outputDir_ : path.string();
+        }
+
+        static std::string escapeJson(const std::string& str) {
+            std::string result;
+            for (char c : str) {
+                switch (c) {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                case '\t': result += "\\t"; break;
+                default: result += c; break;
+                }
+            }
+            return result;
+        }
+
+        std::string pathFor(const std::string& fileName) const {
+            return (std::filesystem::path(outputDir_) / fileName).string();
+        }
+
+        // One large write through a worker-owned buffer
+        void writeFile(const std::string& path, const std::string& content, std::vector<char>& buffer) const {
+            std::ofstream file;
+            file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            file.open(path.c_str(), std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Cannot write to file: " + path);
+            }
+            file.write(content.data(), static_cast<std::streamsize>(content.size()));
+            file.close();
+            if (!file) {
+                throw std::runtime_error("Failed writing file: " + path);
+            }
+        }
+
+    public:
+        // settings names everything besides the slide that shapes its file,
+        // such as the output format; changing it rewrites every file.
+        SplitRenderer(std::string outputDir, std::string settings = "", size_t threadCount = 0)
+            : outputDir_(outputDir), settings_(settings), threadCount_(threadCount) {
+        }
+
+        // Forgets what every directory was rendered from
+        static void resetHistory() {
+            std::lock_guard<std::mutex> lock(statesMutex());
+            states().clear();
+        }
+
+        static std::string fileNameFor(size_t slideIndex) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "slide_%04zu.svg", slideIndex);
+            return buffer;
+        }
+
+        static const char* manifestName() {
+            return "manifest.json";
+        }
+
+        std::vector<OutputFile> render(const Model::Presentation& presentation, const SlideRenderer& renderSlide) const {
+            std::error_code error;
+            std::filesystem::create_directories(outputDir_, error);
+            if (error) {
+                throw std::runtime_error("Cannot create directory: " + outputDir_);
+            }
+
+            const std::string key = stateKey();
+            DirectoryState previous;
+            {
+                std::lock_guard<std::mutex> lock(statesMutex());
+                auto it = states().find(key);
+                if (it != states().end()) {
+                    previous = it->second;
+                }
+            }
+            const bool sameSettings = previous.title == presentation.title() && previous.settings == settings_;
+
+            const size_t slideCount = presentation.slideCount();
+            std::vector<OutputFile> outputs(slideCount);
+            std::vector<size_t> dirty;
+            for (size_t i = 0; i < slideCount; ++i) {
+                const Model::Slide* slide = presentation.getSlide(i);
+                outputs[i] = OutputFile{ i, fileNameFor(i), 0, slide->id(), slide->generation(), true };
+
+                if (sameSettings && i < previous.files.size()) {
+                    const OutputFile& before = previous.files[i];
+                    if (before.slideId == slide->id() && before.generation == slide->generation() &&
+                        std::filesystem::exists(pathFor(before.fileName))) {
+                        outputs[i].bytes = before.bytes;
+                        outputs[i].written = false;
+                        continue;
+                    }
+                }
+                dirty.push_back(i);
+            }
+
+            WorkerPool pool(threadCount_);
+            std::vector<std::vector<char>> buffers(pool.workersFor(dirty.size()), std::vector<char>(kWriteBufferSize));
+
+            pool.forEach(dirty.size(), [&](size_t task, size_t worker) {
+                OutputFile& output = outputs[dirty[task]];
+                std::string svg = renderSlide(output.slideIndex);
+                writeFile(pathFor(output.fileName), svg, buffers[worker]);
+                output.bytes = svg.size();
+            });
+
+            // Files of slides past the end of a shrunken deck are stale
+            for (size_t i = slideCount; i < previous.files.size(); ++i) {
+                std::error_code error;
+                std::filesystem::remove(pathFor(previous.files[i].fileName), error);
+            }
+
+            writeManifest(presentation, outputs);
+
+            std::lock_guard<std::mutex> lock(statesMutex());
+            states()[key] = DirectoryState{ presentation.title(), settings_, outputs };
+            return outputs;
+        }
+
+        void writeManifest(const Model::Presentation& presentation, const std::vector<OutputFile>& outputs) const {
+            std::string manifest = "{\n";
+            manifest += "  \"title\": \"" + escapeJson(presentation.title()) + "\",\n";
+            manifest += "  \"slides\": [\n";
+            for (size_t i = 0; i < outputs.size(); ++i) {
+                manifest += "    { \"index\": " + std::to_string(static_cast<long long>(outputs[i].slideIndex)) +
+                    ", \"file\": \"" + outputs[i].fileName +
+                    "\", \"bytes\": " + std::to_string(static_cast<long long>(outputs[i].bytes)) +
+                    ", \"generation\": " + std::to_string(static_cast<unsigned long long>(outputs[i].generation)) + " }";
+                if (i + 1 < outputs.size()) {
+                    manifest += ",";
+                }
+                manifest += "\n";
+            }
+            manifest += "  ]\n";
+            manifest += "}\n";
+
+            std::vector<char> buffer(kWriteBufferSize);
+            writeFile(pathFor(manifestName()), manifest, buffer);
+        }
+    };
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "ICommand.h"
+#include "ICommandFactory.h"
+#include "CommandHistory.h"
+#include "../Model/MemoryStats.h"
+#include "../Model/ShapeRecord.h"
+#include "../Model/Slide.h"
+#include "../Model/StringPool.h"
+#include "../Painting/StylePalette.h"
+#include "../Painting/TextLayout.h"
+#include "../Viewer/View.h"
+#include "../Application/Application.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Controller {
+
+    // Where memory goes, by category. Every figure is a running total kept by
+    // the component that owns the memory, so this takes the same time for an
+    // empty deck as for a million slides; nothing is walked. Replacing the
+    // deck clears both histories, so the figures never include a deck that
+    // is gone.
+    class StatsCommand : public ICommand {
+    public:
+        void execute() override {
+            auto& view = View::ViewFacade::getInstance();
+            const Model::MemoryStats& stats = Model::MemoryStats::getInstance();
+            const Painting::StylePalette& palette = Painting::StylePalette::getInstance();
+            const Application::Editor& editor = Application::Application::getInstance().getEditor();
+
+            std::vector<std::pair<std::string, long long>> categories = {
+                { "Shape records", stats.bytes(Model::MemoryCategory::SHAPE_RECORDS) },
+                { "Shape geometry", stats.bytes(Model::MemoryCategory::SHAPE_GEOMETRY) },
+                { "Shape ids", stats.bytes(Model::MemoryCategory::SHAPE_IDS) },
+                { "Z-order", stats.bytes(Model::MemoryCategory::Z_ORDER) },
+                { "Slides", stats.bytes(Model::MemoryCategory::SLIDES) },
+                { "Slide lists", stats.bytes(Model::MemoryCategory::SLIDE_LISTS) },
+                { "Indexes", stats.bytes(Model::MemoryCategory::INDEXES) },
+                { "Groups", stats.bytes(Model::MemoryCategory::GROUPS) },
+                { "Strings", static_cast<long long>(Model::StringPool::getInstance().byteCount()) },
+                { "Styles", static_cast<long long>(palette.penCount() * sizeof(Painting::Pen) +
+                    palette.brushCount() * sizeof(Painting::Brush) +
+                    palette.textStyleCount() * sizeof(Painting::TextStyle)) },
+                { "Caches", static_cast<long long>(Painting::TextLayout::getInstance().byteCount()) },
+                { "Command history", static_cast<long long>(CommandHistory::getInstance().memoryUsage()) }
+            };
+            view.showInfo("Memory in use:");
+            view.showMemoryStats(categories);
+
+            // Versions share storage with the live deck, so the history's
+            // share is already within the totals above
+            view.showInfo("Undo history: " + std::to_string(static_cast<long long>(editor.undoCount())) +
+                " undo and " + std::to_string(static_cast<long long>(editor.redoCount())) +
+                " redo version(s), about " + View::ViewFacade::formatBytes(static_cast<long long>(editor.memoryUsage())) +
+                " of the above held only by them");
+
+            const long long perShape = static_cast<long long>(Model::Slide::bytesPerShape());
+            std::vector<std::pair<std::string, long long>> kinds;
+            for (size_t kind = 0; kind < Model::kShapeKindCount; ++kind) {
+                long long count = stats.shapes(kind);
+                if (count > 0) {
+                    kinds.push_back(std::make_pair(std::string(Model::ShapeRecord::typeName(static_cast<Model::ShapeKind>(kind))) +
+                        " x" + std::to_string(count), count * perShape));
+                }
+            }
+            if (!kinds.empty()) {
+                view.showInfo("Shapes stored, by kind, in the deck and its versions:");
+                view.showMemoryStats(kinds);
+            }
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return false; }
+    };
+
+    class StatsFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            if (args.size() != 1) {
+                throw std::runtime_error("stats takes no arguments");
+            }
+            return std::unique_ptr<ICommand>(new StatsCommand());
+        }
+
+        std::string getCommandName() const override {
+            return "stats";
+        }
+    };
+
+}
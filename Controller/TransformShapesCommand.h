@@ -0,0 +1,279 @@
+#pragma once
+#include "ICommand.h"
+#include "ICommandFactory.h"
+#include "../Model/Model.h"
+#include "../Viewer/View.h"
+#include "../Application/Application.h"
+#include "../Application/Actions.h"
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Controller {
+
+    // Which shapes a bulk edit applies to: one slide or the whole deck, and
+    // optionally only shapes overlapping a region of the slide.
+    struct ShapeSelection {
+        size_t slideIndex;
+        bool hasRegion;
+        int regionX, regionY, regionWidth, regionHeight;
+
+        ShapeSelection()
+            : slideIndex(Application::kAllSlides), hasRegion(false),
+            regionX(0), regionY(0), regionWidth(0), regionHeight(0) {
+        }
+
+        // Parses -slide and -region at args[i]; false if it is neither
+        bool parseOption(const std::vector<std::string>& args, size_t& i, const std::string& command) {
+            if (args[i] == "-slide") {
+                if (i + 1 >= args.size()) {
+                    throw std::runtime_error(command + " -slide requires an index");
+                }
+                slideIndex = std::stoul(args[i + 1]);
+                i += 1;
+                return true;
+            }
+            if (args[i] == "-region") {
+                if (i + 4 >= args.size()) {
+                    throw std::runtime_error(command + " -region requires x y width height");
+                }
+                regionX = std::stoi(args[i + 1]);
+                regionY = std::stoi(args[i + 2]);
+                regionWidth = std::stoi(args[i + 3]);
+                regionHeight = std::stoi(args[i + 4]);
+                hasRegion = true;
+                i += 4;
+                return true;
+            }
+            return false;
+        }
+
+        // Checks the slide index, builds region masks and counts the shapes
+        // selected; false with an error shown if the selection is invalid
+        bool resolve(const Model::Presentation& presentation, Application::ShapeMasks& masks, size_t& slideCount,
+            size_t& shapeCount) const {
+            size_t first = 0, last = 0;
+            if (!Application::resolveSlideRange(&presentation, slideIndex, first, last)) {
+                View::ViewFacade::getInstance().showError("Slide index out of range");
+                return false;
+            }
+
+            slideCount = last - first;
+            shapeCount = 0;
+            const Model::BoundingBox region(regionX, regionY, regionWidth, regionHeight);
+            for (size_t i = first; i < last; ++i) {
+                const Model::Slide* slide = presentation.getSlide(i);
+                if (hasRegion) {
+                    masks.push_back(std::vector<std::uint8_t>(slide->shapeCount()));
+                    shapeCount += slide->geometry().intersecting(region, masks.back().data());
+                }
+                else {
+                    shapeCount += slide->shapeCount();
+                }
+            }
+            return true;
+        }
+
+        // Whether fits(geometry, mask) holds on every slide of a selection
+        // that resolve() has accepted, with that slide's region mask
+        template <typename Fits>
+        bool all(const Model::Presentation& presentation, const Application::ShapeMasks& masks, const Fits& fits) const {
+            size_t first = 0, last = 0;
+            Application::resolveSlideRange(&presentation, slideIndex, first, last);
+            for (size_t i = first; i < last; ++i) {
+                const std::uint8_t* mask = hasRegion ? masks[i - first].data() : nullptr;
+                if (!fits(presentation.getSlide(i)->geometry(), mask)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    class TranslateShapesCommand : public ICommand {
+        int dx_, dy_;
+        ShapeSelection selection_;
+        bool executed_;
+
+    public:
+        TranslateShapesCommand(int dx, int dy, ShapeSelection selection)
+            : dx_(dx), dy_(dy), selection_(selection), executed_(false) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded.");
+                executed_ = false;
+                return;
+            }
+
+            Application::ShapeMasks masks;
+            size_t slideCount = 0, shapeCount = 0;
+            if (!selection_.resolve(*model.getPresentation(), masks, slideCount, shapeCount)) {
+                executed_ = false;
+                return;
+            }
+
+            const int dx = dx_, dy = dy_;
+            if (!selection_.all(*model.getPresentation(), masks,
+                [dx, dy](const Model::ShapeGeometry& geometry, const std::uint8_t* mask) {
+                    return geometry.canTranslate(dx, dy, mask);
+                })) {
+                view.showError("Moving by that much would take shapes outside the coordinate range");
+                executed_ = false;
+                return;
+            }
+
+            std::unique_ptr<Application::IAction> action =
+                std::make_unique<Application::TranslateShapesAction>(selection_.slideIndex, dx_, dy_, std::move(masks));
+            Application::Application::getInstance().getEditor().doAction(std::move(action), model.getPresentation());
+
+            view.showSuccess("Moved " + std::to_string(static_cast<long long>(shapeCount)) + " shape(s) on " +
+                std::to_string(static_cast<long long>(slideCount)) + " slide(s)");
+            executed_ = true;
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
+    };
+
+    class ScaleShapesCommand : public ICommand {
+        double factorX_, factorY_;
+        int originX_, originY_;
+        ShapeSelection selection_;
+        bool executed_;
+
+    public:
+        ScaleShapesCommand(double factorX, double factorY, int originX, int originY, ShapeSelection selection)
+            : factorX_(factorX), factorY_(factorY), originX_(originX), originY_(originY),
+            selection_(selection), executed_(false) {
+        }
+
+        void execute() override {
+            auto& model = Model::Model::getInstance();
+            auto& view = View::ViewFacade::getInstance();
+
+            if (!model.hasPresentation()) {
+                view.showError("No presentation loaded.");
+                executed_ = false;
+                return;
+            }
+
+            Application::ShapeMasks masks;
+            size_t slideCount = 0, shapeCount = 0;
+            if (!selection_.resolve(*model.getPresentation(), masks, slideCount, shapeCount)) {
+                executed_ = false;
+                return;
+            }
+
+            if (!selection_.all(*model.getPresentation(), masks,
+                [this](const Model::ShapeGeometry& geometry, const std::uint8_t* mask) {
+                    return geometry.canScale(factorX_, factorY_, originX_, originY_, mask);
+                })) {
+                view.showError("Scaling by that much would take shapes outside the coordinate range");
+                executed_ = false;
+                return;
+            }
+
+            std::unique_ptr<Application::IAction> action = std::make_unique<Application::ScaleShapesAction>(
+                selection_.slideIndex, factorX_, factorY_, originX_, originY_, std::move(masks));
+            Application::Application::getInstance().getEditor().doAction(std::move(action), model.getPresentation());
+
+            view.showSuccess("Scaled " + std::to_string(static_cast<long long>(shapeCount)) + " shape(s) on " +
+                std::to_string(static_cast<long long>(slideCount)) + " slide(s)");
+            executed_ = true;
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return executed_; }
+        size_t memoryUsage() const override { return sizeof(*this); }
+    };
+
+    class TranslateShapesFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            int dx = 0, dy = 0;
+            ShapeSelection selection;
+
+            for (size_t i = 1; i < args.size(); ++i) {
+                if (args[i] == "-dx" && i + 1 < args.size()) {
+                    dx = std::stoi(args[i + 1]);
+                    ++i;
+                }
+                else if (args[i] == "-dy" && i + 1 < args.size()) {
+                    dy = std::stoi(args[i + 1]);
+                    ++i;
+                }
+                else {
+                    selection.parseOption(args, i, "translate_shapes");
+                }
+            }
+
+            if (dx == 0 && dy == 0) {
+                throw std::runtime_error("translate_shapes requires a non-zero -dx or -dy");
+            }
+
+            return std::unique_ptr<ICommand>(new TranslateShapesCommand(dx, dy, selection));
+        }
+
+        std::string getCommandName() const override {
+            return "translate_shapes";
+        }
+    };
+
+    class ScaleShapesFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            double factorX = 0.0, factorY = 0.0;
+            int originX = 0, originY = 0;
+            ShapeSelection selection;
+
+            for (size_t i = 1; i < args.size(); ++i) {
+                if (args[i] == "-factor" && i + 1 < args.size()) {
+                    factorX = std::stod(args[i + 1]);
+                    if (factorY == 0.0) factorY = factorX;
+                    ++i;
+                }
+                else if (args[i] == "-fx" && i + 1 < args.size()) {
+                    factorX = std::stod(args[i + 1]);
+                    ++i;
+                }
+                else if (args[i] == "-fy" && i + 1 < args.size()) {
+                    factorY = std::stod(args[i + 1]);
+                    ++i;
+                }
+                else if (args[i] == "-origin" && i + 2 < args.size()) {
+                    originX = std::stoi(args[i + 1]);
+                    originY = std::stoi(args[i + 2]);
+                    i += 2;
+                }
+                else {
+                    selection.parseOption(args, i, "scale_shapes");
+                }
+            }
+
+            if (factorX == 0.0 && factorY != 0.0) factorX = 1.0;
+            if (factorY == 0.0 && factorX != 0.0) factorY = 1.0;
+            if (!(factorX > 0.0 && factorY > 0.0)) {
+                throw std::runtime_error("scale_shapes requires a positive -factor, -fx or -fy");
+            }
+            if (!std::isfinite(factorX) || !std::isfinite(factorY)) {
+                throw std::runtime_error("scale_shapes requires a finite -factor, -fx or -fy");
+            }
+
+            return std::unique_ptr<ICommand>(new ScaleShapesCommand(factorX, factorY, originX, originY, selection));
+        }
+
+        std::string getCommandName() const override {
+            return "scale_shapes";
+        }
+    };
+
+}
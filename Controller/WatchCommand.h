@@ -0,0 +1,269 @@
+#pragma once
+#include "ICommand.h"
+#include "ICommandFactory.h"
+#include "CommandHistory.h"
+#include "FileWatcher.h"
+#include "RenderCommand.h"
+#include "SplitRenderer.h"
+#include "../Model/Model.h"
+#include "../Application/Application.h"
+#include "../Serialization/JsonDeserialize.h"
+#include "../Viewer/View.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Controller {
+
+    // Live preview of a JSON deck: renders it to one SVG per slide, then
+    // re-renders whenever the file is saved. Only slides whose JSON text
+    // changed are parsed again; the others keep their slide objects, so the
+    // split renderer sees their generations unchanged and leaves their files
+    // alone. Stops after a number of cycles, or when the file is deleted.
+    class WatchCommand : public ICommand {
+        struct ReloadResult {
+            size_t slideCount;
+            size_t parsed;
+        };
+
+        std::string path_;
+        std::string outputDir_;
+        bool minify_;
+        size_t threadCount_;
+        std::chrono::milliseconds debounce_;
+        size_t maxCycles_;
+
+        // The deck as last loaded, with the JSON text each slide came from
+        std::unique_ptr<Model::Presentation> presentation_;
+        std::vector<std::string> slideTexts_;
+        std::string content_;
+
+        typedef std::chrono::steady_clock Clock;
+
+        static double millisecondsBetween(Clock::time_point from, Clock::time_point to) {
+            return std::chrono::duration<double, std::milli>(to - from).count();
+        }
+
+        static std::string formatMilliseconds(double ms) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.1f ms", ms);
+            return buffer;
+        }
+
+        // Builds the new deck from the old one's slides wherever a slide's
+        // text is unchanged, wherever it moved to. Changed slides are parsed
+        // before the current deck is touched, so a half-edited file leaves the
+        // last good deck in place.
+        ReloadResult reload(std::string content) {
+            static const size_t kParsed = static_cast<size_t>(-1);
+            Serialization::JsonDeserialize loader;
+            std::vector<std::string> texts = loader.splitSlides(content);
+
+            // Reused slides stay in the arena they were parsed into, so new
+            // ones join them there
+            std::shared_ptr<Model::Arena> arena = presentation_ ? presentation_->arena() : Model::Arena::create();
+
+            std::unordered_multimap<std::string, size_t> previous;
+            for (size_t i = 0; i < slideTexts_.size(); ++i) {
+                previous.emplace(slideTexts_[i], i);
+            }
+
+            std::vector<size_t> sources(texts.size(), kParsed);
+            std::vector<std::shared_ptr<Model::Slide>> slides(texts.size());
+            ReloadResult result{ texts.size(), 0 };
+            for (size_t i = 0; i < texts.size(); ++i) {
+                auto match = previous.find(texts[i]);
+                if (match != previous.end()) {
+                    sources[i] = match->second;
+                    previous.erase(match);
+                }
+                else {
+                    slides[i] = loader.parseSlide(texts[i], arena);
+                    ++result.parsed;
+                }
+            }
+
+            if (presentation_) {
+                std::vector<std::shared_ptr<Model::Slide>> reusable = presentation_->releaseSlides();
+                for (size_t i = 0; i < texts.size(); ++i) {
+                    if (sources[i] != kParsed) {
+                        slides[i] = std::move(reusable[sources[i]]);
+                    }
+                }
+            }
+
+            auto presentation = std::make_unique<Model::Presentation>(loader.parseTitle(content), arena);
+            for (auto& slide : slides) {
+                presentation->addSlide(std::move(slide));
+            }
+
+            presentation_ = std::move(presentation);
+            slideTexts_ = std::move(texts);
+            content_ = std::move(content);
+            return result;
+        }
+
+        size_t render() const {
+            Painting::SVGPainter::Format format = minify_ ?
+                Painting::SVGPainter::Format::MINIFIED : Painting::SVGPainter::Format::PRETTY;
+            const Model::Presentation& presentation = *presentation_;
+
+            SplitRenderer renderer(outputDir_, minify_ ? "minified" : "pretty", threadCount_);
+            auto outputs = renderer.render(presentation, [&](size_t i) {
+                return RenderCommand::renderSVG(presentation, i, i + 1, format, 1);
+            });
+
+            size_t written = 0;
+            for (const auto& output : outputs) {
+                if (output.written) ++written;
+            }
+            return written;
+        }
+
+        // Reloads and re-renders; false if the file could not be read or parsed
+        bool runCycle(size_t cycle, Clock::time_point changed) {
+            auto& view = View::ViewFacade::getInstance();
+            Clock::time_point start = Clock::now();
+
+            std::string content;
+            ReloadResult reloaded{ 0, 0 };
+            try {
+                content = Serialization::JsonDeserialize::readFile(path_);
+                if (presentation_ && content == content_) {
+                    view.showInfo("Cycle " + std::to_string(static_cast<long long>(cycle)) + ": '" + path_ + "' unchanged");
+                    return true;
+                }
+                reloaded = reload(std::move(content));
+            }
+            catch (const std::exception& e) {
+                view.showError("Cycle " + std::to_string(static_cast<long long>(cycle)) +
+                    ": reload failed, keeping the previous deck: " + e.what());
+                return false;
+            }
+            Clock::time_point loaded = Clock::now();
+
+            size_t written = 0;
+            try {
+                written = render();
+            }
+            catch (const std::exception& e) {
+                view.showError("Cycle " + std::to_string(static_cast<long long>(cycle)) + ": " + e.what());
+                return false;
+            }
+            Clock::time_point done = Clock::now();
+
+            view.showSuccess("Cycle " + std::to_string(static_cast<long long>(cycle)) + ": parsed " +
+                std::to_string(static_cast<long long>(reloaded.parsed)) + " and rendered " +
+                std::to_string(static_cast<long long>(written)) + " of " +
+                std::to_string(static_cast<long long>(reloaded.slideCount)) + " slide(s) in " +
+                formatMilliseconds(millisecondsBetween(start, done)) + " (reload " +
+                formatMilliseconds(millisecondsBetween(start, loaded)) + ", render " +
+                formatMilliseconds(millisecondsBetween(loaded, done)) + "); " +
+                formatMilliseconds(millisecondsBetween(changed, done)) + " after the change");
+            return true;
+        }
+
+    public:
+        // maxCycles 0 watches until the file is deleted
+        WatchCommand(std::string path, std::string outputDir, bool minify = false, size_t threadCount = 0,
+            std::chrono::milliseconds debounce = std::chrono::milliseconds(50), size_t maxCycles = 0)
+            : path_(path), outputDir_(outputDir), minify_(minify), threadCount_(threadCount),
+            debounce_(debounce), maxCycles_(maxCycles) {
+        }
+
+        void execute() override {
+            auto& view = View::ViewFacade::getInstance();
+
+            FileWatcher watcher(path_, debounce_);
+            Clock::time_point changed = Clock::now();
+            if (!runCycle(0, changed) && !presentation_) {
+                return;
+            }
+
+            view.showInfo("Watching '" + path_ + "' (" + (watcher.usesInotify() ? "inotify" : "polling") +
+                ", " + std::to_string(static_cast<long long>(debounce_.count())) + " ms debounce)");
+
+            for (size_t cycle = 1; maxCycles_ == 0 || cycle <= maxCycles_; ++cycle) {
+                if (!watcher.waitForChange(changed)) {
+                    view.showInfo("'" + path_ + "' was removed; stopped watching");
+                    break;
+                }
+                runCycle(cycle, changed);
+            }
+
+            // Leave the last deck loaded, as load_presentation would
+            Application::Application::getInstance().setPresentation(std::move(presentation_));
+            CommandHistory::getInstance().clear();
+            slideTexts_.clear();
+            content_.clear();
+        }
+
+        void undo() override {}
+        bool isUndoable() const override { return false; }
+    };
+
+    class WatchFactory : public ICommandFactory {
+    public:
+        std::unique_ptr<ICommand> createCommand(const std::vector<std::string>& args) override {
+            std::string path;
+            std::string outputDir;
+            bool minify = false;
+            size_t threadCount = 0;
+            int debounce = 50;
+            size_t maxCycles = 0;
+
+            for (size_t i = 1; i < args.size(); ++i) {
+                if (args[i] == "-path" && i + 1 < args.size()) {
+                    path = args[i + 1];
+                    ++i;
+                }
+                else if (args[i] == "-out" && i + 1 < args.size()) {
+                    outputDir = args[i + 1];
+                    ++i;
+                }
+                else if (args[i] == "-minify") {
+                    minify = true;
+                }
+                else if (args[i] == "-threads" && i + 1 < args.size()) {
+                    int threads = std::stoi(args[i + 1]);
+                    if (threads < 1) {
+                        throw std::runtime_error("watch -threads requires a positive count");
+                    }
+                    threadCount = static_cast<size_t>(threads);
+                    ++i;
+                }
+                else if (args[i] == "-debounce" && i + 1 < args.size()) {
+                    debounce = std::stoi(args[i + 1]);
+                    if (debounce < 0) {
+                        throw std::runtime_error("watch -debounce requires a non-negative number of milliseconds");
+                    }
+                    ++i;
+                }
+                else if (args[i] == "-cycles" && i + 1 < args.size()) {
+                    int cycles = std::stoi(args[i + 1]);
+                    if (cycles < 1) {
+                        throw std::runtime_error("watch -cycles requires a positive count");
+                    }
+                    maxCycles = static_cast<size_t>(cycles);
+                    ++i;
+                }
+            }
+
+            if (path.empty() || outputDir.empty()) {
+                throw std::runtime_error("watch requires -path and -out arguments");
+            }
+
+            return std::unique_ptr<ICommand>(new WatchCommand(path, outputDir, minify, threadCount,
+                std::chrono::milliseconds(debounce), maxCycles));
+        }
+
+        std::string getCommandName() const override {
+            return "watch";
+        }
+    };
+
+}
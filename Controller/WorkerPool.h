@@ -0,0 +1,80 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Controller {
+
+    // Runs independent tasks on a fixed number of threads, the calling thread
+    // included. Tasks are claimed in index order and each call is told which
+    // worker runs it, so per-worker state can be kept without locking. The
+    // first exception thrown by any task is rethrown once all threads stop.
+    class WorkerPool {
+        size_t threadCount_;
+
+    public:
+        explicit WorkerPool(size_t threadCount = 0)
+            : threadCount_(threadCount > 0 ? threadCount : defaultThreadCount()) {
+        }
+
+        static size_t defaultThreadCount() {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            return hardware > 0 ? hardware : 1;
+        }
+
+        size_t getThreadCount() const {
+            return threadCount_;
+        }
+
+        // Number of workers forEach() will use for this many tasks
+        size_t workersFor(size_t taskCount) const {
+            return std::max<size_t>(1, std::min(threadCount_, taskCount));
+        }
+
+        void forEach(size_t taskCount, const std::function<void(size_t task, size_t worker)>& task) const {
+            size_t workers = workersFor(taskCount);
+            if (workers <= 1) {
+                for (size_t i = 0; i < taskCount; ++i) task(i, 0);
+                return;
+            }
+
+            std::atomic<size_t> next(0);
+            std::atomic<bool> failed(false);
+            std::exception_ptr error;
+            std::mutex errorMutex;
+
+            auto work = [&](size_t worker) {
+                for (;;) {
+                    size_t i = next.fetch_add(1);
+                    if (i >= taskCount || failed.load()) return;
+                    try {
+                        task(i, worker);
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        if (!error) error = std::current_exception();
+                        failed.store(true);
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(workers - 1);
+            for (size_t t = 1; t < workers; ++t) {
+                threads.emplace_back(work, t);
+            }
+            work(0);
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            if (error) std::rethrow_exception(error);
+        }
+    };
+
+}
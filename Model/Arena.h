@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include "MemoryStats.h"
+
+namespace Model {
+
+    // Memory for one presentation's shape storage. Slides draw their arrays
+    // from size-class pools, so arrays freed by edits are reused by later
+    // ones, and each pool takes its memory in chunks of many arrays. When the
+    // last slide using an arena goes away the chunks are returned at once,
+    // instead of one free per array.
+    //
+    // Slides hold the arena by shared_ptr, so a slide kept by the undo history
+    // or moved to another deck keeps its memory alive. An arena is not
+    // thread-safe: slides are built and edited on one thread, and painting
+    // only reads them. A version of a deck handed to another thread may be
+    // read there freely, but its last reference should be dropped on the
+    // editing thread, since that frees into the arena.
+    //
+    // Each kind of storage is drawn through its own counting resource, so
+    // MemoryStats knows at any moment how much every category holds.
+    class Arena {
+        std::pmr::unsynchronized_pool_resource pools_;
+        CountingResource counters_[kMemoryCategoryCount];
+
+        static std::pmr::pool_options poolOptions() {
+            std::pmr::pool_options options;
+            options.largest_required_pool_block = 64 * 1024;
+            // Bounds the unused tail of each pool's newest chunk
+            options.max_blocks_per_chunk = 256;
+            return options;
+        }
+
+    public:
+        Arena() : pools_(poolOptions(), std::pmr::new_delete_resource()),
+            counters_{ { &pools_, MemoryCategory::SHAPE_RECORDS }, { &pools_, MemoryCategory::SHAPE_GEOMETRY },
+                { &pools_, MemoryCategory::SHAPE_IDS }, { &pools_, MemoryCategory::Z_ORDER },
+                { &pools_, MemoryCategory::SLIDES }, { &pools_, MemoryCategory::SLIDE_LISTS },
+                { &pools_, MemoryCategory::INDEXES }, { &pools_, MemoryCategory::GROUPS } } {
+        }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        static std::shared_ptr<Arena> create() {
+            return std::make_shared<Arena>();
+        }
+
+        std::pmr::memory_resource* resource(MemoryCategory category) {
+            return &counters_[static_cast<size_t>(category)];
+        }
+
+        // The heap, counted under category, for storage outside any arena.
+        // The counters are never destroyed, so storage still held by other
+        // statics at exit is freed through them safely.
+        static std::pmr::memory_resource* heap(MemoryCategory category) {
+            static CountingResource* const counters = new CountingResource[kMemoryCategoryCount]{
+                { std::pmr::new_delete_resource(), MemoryCategory::SHAPE_RECORDS },
+                { std::pmr::new_delete_resource(), MemoryCategory::SHAPE_GEOMETRY },
+                { std::pmr::new_delete_resource(), MemoryCategory::SHAPE_IDS },
+                { std::pmr::new_delete_resource(), MemoryCategory::Z_ORDER },
+                { std::pmr::new_delete_resource(), MemoryCategory::SLIDES },
+                { std::pmr::new_delete_resource(), MemoryCategory::SLIDE_LISTS },
+                { std::pmr::new_delete_resource(), MemoryCategory::INDEXES },
+                { std::pmr::new_delete_resource(), MemoryCategory::GROUPS } };
+            return &counters[static_cast<size_t>(category)];
+        }
+
+        // The resource for slides that have no arena is the heap
+        static std::pmr::memory_resource* resourceOf(const std::shared_ptr<Arena>& arena, MemoryCategory category) {
+            return arena ? arena->resource(category) : heap(category);
+        }
+    };
+
+}
@@ -0,0 +1,325 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Model {
+
+    // A sequence stored as a B-tree of chunks: elements sit in leaf arrays of
+    // up to kLeafMax, and inner nodes keep the element count of each child,
+    // so finding position i walks one path from the root. Insertion, removal
+    // and access by position take O(log n) and move at most one chunk of
+    // elements, and iteration runs through whole chunks in order.
+    //
+    // Nodes are copy-on-write like a Slide's arrays: copying a sequence
+    // shares the whole tree, and an edit copies only the nodes on its path
+    // that another copy still holds. A version of a million-slide deck kept
+    // for undo therefore costs a few kilobytes rather than the slide list.
+    //
+    // Nodes and their arrays come from the memory resource the sequence is
+    // made with, which copies share.
+    template <typename T>
+    class ChunkedSequence {
+        static const size_t kLeafMax = 64;
+        static const size_t kBranchMax = 32;
+
+        struct Node {
+            bool leaf;
+            size_t size;
+            std::pmr::vector<T> items;
+            std::pmr::vector<std::shared_ptr<Node>> children;
+            // Element count of each child, kept beside the pointers so a
+            // search reads one array
+            std::pmr::vector<size_t> counts;
+
+            Node(bool isLeaf, std::pmr::memory_resource* resource)
+                : leaf(isLeaf), size(0), items(resource), children(resource), counts(resource) {
+            }
+
+            Node(const Node& other)
+                : leaf(other.leaf), size(other.size), items(other.items, other.resource()),
+                children(other.children, other.resource()), counts(other.counts, other.resource()) {
+            }
+
+            std::pmr::memory_resource* resource() const {
+                return items.get_allocator().resource();
+            }
+
+            size_t width() const {
+                return leaf ? items.size() : children.size();
+            }
+        };
+
+        typedef std::shared_ptr<Node> NodePtr;
+
+        std::pmr::memory_resource* resource_;
+        NodePtr root_;
+
+        static NodePtr makeNode(bool leaf, std::pmr::memory_resource* resource) {
+            return std::allocate_shared<Node>(std::pmr::polymorphic_allocator<Node>(resource), leaf, resource);
+        }
+
+        // The node, first copied if another sequence shares it
+        static Node& own(NodePtr& node) {
+            if (node.use_count() > 1) {
+                node = std::allocate_shared<Node>(std::pmr::polymorphic_allocator<Node>(node->resource()), *node);
+            }
+            return *node;
+        }
+
+        // The child holding element pos, with pos made relative to it
+        static size_t locate(const Node& node, size_t& pos) {
+            size_t i = 0;
+            while (pos >= node.counts[i]) {
+                pos -= node.counts[i];
+                ++i;
+            }
+            return i;
+        }
+
+        template <typename Vector>
+        static void moveTail(Vector& from, size_t start, Vector& to) {
+            to.insert(to.end(), std::make_move_iterator(from.begin() + start), std::make_move_iterator(from.end()));
+            from.erase(from.begin() + start, from.end());
+        }
+
+        static void recount(Node& node) {
+            if (node.leaf) {
+                node.size = node.items.size();
+                return;
+            }
+            node.size = 0;
+            for (size_t count : node.counts) node.size += count;
+        }
+
+        // Moves the entries from start on into a new right sibling
+        static NodePtr split(Node& node, size_t start) {
+            NodePtr right = makeNode(node.leaf, node.resource());
+            if (node.leaf) {
+                moveTail(node.items, start, right->items);
+            }
+            else {
+                moveTail(node.children, start, right->children);
+                moveTail(node.counts, start, right->counts);
+            }
+            recount(node);
+            recount(*right);
+            return right;
+        }
+
+        // A node that overflowed by an append keeps its entries and passes
+        // on the last, so sequences built in order fill their chunks;
+        // otherwise it splits in half. Returns the new right sibling.
+        static NodePtr splitFull(Node& node, bool appended) {
+            size_t width = node.width();
+            return split(node, appended ? width - 1 : width / 2);
+        }
+
+        static NodePtr insertInto(NodePtr& node, size_t pos, T&& value) {
+            Node& n = own(node);
+            ++n.size;
+            if (n.leaf) {
+                bool appended = pos == n.items.size();
+                n.items.insert(n.items.begin() + pos, std::move(value));
+                return n.items.size() > kLeafMax ? splitFull(n, appended) : nullptr;
+            }
+
+            // Position count goes at the end of the last child
+            size_t i = 0;
+            while (i + 1 < n.children.size() && pos > n.counts[i]) {
+                pos -= n.counts[i];
+                ++i;
+            }
+            NodePtr sibling = insertInto(n.children[i], pos, std::move(value));
+            n.counts[i] = n.children[i]->size;
+            if (!sibling) {
+                return nullptr;
+            }
+            bool appended = i + 1 == n.children.size();
+            n.counts.insert(n.counts.begin() + i + 1, sibling->size);
+            n.children.insert(n.children.begin() + i + 1, std::move(sibling));
+            return n.children.size() > kBranchMax ? splitFull(n, appended) : nullptr;
+        }
+
+        // Merges child i with a neighbour once it falls under a quarter
+        // full, splitting the result again if it is over-full
+        static void rebalance(Node& parent, size_t i) {
+            const Node& child = *parent.children[i];
+            size_t minimum = (child.leaf ? kLeafMax : kBranchMax) / 4;
+            if (child.width() >= minimum || parent.children.size() < 2) {
+                return;
+            }
+
+            size_t left = i > 0 ? i - 1 : i;
+            Node& a = own(parent.children[left]);
+            Node& b = own(parent.children[left + 1]);
+            if (a.leaf) {
+                moveTail(b.items, 0, a.items);
+            }
+            else {
+                moveTail(b.children, 0, a.children);
+                moveTail(b.counts, 0, a.counts);
+            }
+            a.size += b.size;
+            parent.children.erase(parent.children.begin() + left + 1);
+            parent.counts.erase(parent.counts.begin() + left + 1);
+
+            if (a.width() > (a.leaf ? kLeafMax : kBranchMax)) {
+                NodePtr right = split(a, a.width() / 2);
+                parent.counts.insert(parent.counts.begin() + left + 1, right->size);
+                parent.children.insert(parent.children.begin() + left + 1, std::move(right));
+            }
+            parent.counts[left] = a.size;
+        }
+
+        static T eraseFrom(NodePtr& node, size_t pos) {
+            Node& n = own(node);
+            --n.size;
+            if (n.leaf) {
+                T removed = std::move(n.items[pos]);
+                n.items.erase(n.items.begin() + pos);
+                return removed;
+            }
+
+            size_t i = locate(n, pos);
+            T removed = eraseFrom(n.children[i], pos);
+            n.counts[i] = n.children[i]->size;
+            rebalance(n, i);
+            return removed;
+        }
+
+        // Visits elements [first, last) of the subtree, positions relative to it
+        template <typename Visit>
+        static void visit(const Node& node, size_t first, size_t last, const Visit& fn) {
+            if (node.leaf) {
+                for (size_t i = first; i < last; ++i) fn(node.items[i]);
+                return;
+            }
+            size_t offset = 0;
+            for (size_t i = 0; i < node.children.size() && offset < last; ++i) {
+                size_t end = offset + node.counts[i];
+                if (end > first) {
+                    size_t from = first > offset ? first - offset : 0;
+                    size_t to = (last < end ? last : end) - offset;
+                    visit(*node.children[i], from, to, fn);
+                }
+                offset = end;
+            }
+        }
+
+        static size_t memoryOf(const Node& node) {
+            size_t bytes = sizeof(Node) + node.items.capacity() * sizeof(T) +
+                node.children.capacity() * sizeof(NodePtr) + node.counts.capacity() * sizeof(size_t);
+            for (const NodePtr& child : node.children) bytes += memoryOf(*child);
+            return bytes;
+        }
+
+        void checkIndex(size_t pos) const {
+            if (pos >= size()) {
+                throw std::out_of_range("Sequence index out of range");
+            }
+        }
+
+    public:
+        explicit ChunkedSequence(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : resource_(resource) {
+        }
+
+        size_t size() const {
+            return root_ ? root_->size : 0;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        const T& at(size_t pos) const {
+            checkIndex(pos);
+            const Node* node = root_.get();
+            while (!node->leaf) {
+                node = node->children[locate(*node, pos)].get();
+            }
+            return node->items[pos];
+        }
+
+        // For writing: copies the nodes on the path that another sequence
+        // shares
+        T& mutableAt(size_t pos) {
+            checkIndex(pos);
+            Node* node = &own(root_);
+            while (!node->leaf) {
+                size_t i = locate(*node, pos);
+                node = &own(node->children[i]);
+            }
+            return node->items[pos];
+        }
+
+        void insert(size_t pos, T value) {
+            if (pos > size()) {
+                throw std::out_of_range("Sequence index out of range");
+            }
+            if (!root_) {
+                root_ = makeNode(true, resource_);
+            }
+            NodePtr sibling = insertInto(root_, pos, std::move(value));
+            if (sibling) {
+                NodePtr root = makeNode(false, resource_);
+                root->counts.push_back(root_->size);
+                root->counts.push_back(sibling->size);
+                root->size = root_->size + sibling->size;
+                root->children.push_back(std::move(root_));
+                root->children.push_back(std::move(sibling));
+                root_ = std::move(root);
+            }
+        }
+
+        void push_back(T value) {
+            insert(size(), std::move(value));
+        }
+
+        // Removes the element at pos and returns it
+        T erase(size_t pos) {
+            checkIndex(pos);
+            T removed = eraseFrom(root_, pos);
+            while (!root_->leaf && root_->children.size() == 1) {
+                NodePtr child = root_->children[0];
+                root_ = std::move(child);
+            }
+            if (root_->size == 0) {
+                root_.reset();
+            }
+            return removed;
+        }
+
+        void clear() {
+            root_.reset();
+        }
+
+        // Calls fn on elements [first, last) in order, a chunk at a time
+        template <typename Visit>
+        void forEach(size_t first, size_t last, const Visit& fn) const {
+            if (first > last || last > size()) {
+                throw std::out_of_range("Sequence range out of range");
+            }
+            if (first < last) {
+                visit(*root_, first, last, fn);
+            }
+        }
+
+        template <typename Visit>
+        void forEach(const Visit& fn) const {
+            forEach(0, size(), fn);
+        }
+
+        // Bytes held by the tree's nodes, shared ones included; the elements'
+        // own storage is not counted
+        size_t memoryUsage() const {
+            return root_ ? memoryOf(*root_) : 0;
+        }
+    };
+
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include "IShape.h"
+#include "BoundingBox.h"
+#include "Shapes.h"
+#include "../Painting/IPainter.h"
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Model {
+
+    // Shapes and other groups handled as one: moved, cloned and drawn
+    // together. Like RecordShape this is for code that builds shapes one at
+    // a time; a slide keeps its groups in a ShapeGroups table, hands one out
+    // as a GroupShape from getGroup() and takes one back through addShape().
+    //
+    // Children are drawn in order, the first at the back. The union of their
+    // bounds is cached: adding below a group clears the cache of each group
+    // on the way up to the outermost and of no other, and a move shifts the
+    // cached bounds rather than recomputing them.
+    class GroupShape : public IShape {
+        std::vector<std::unique_ptr<IShape>> children_;
+        GroupShape* parent_;
+        mutable int left_, top_, right_, bottom_;
+        mutable bool cached_;
+
+        GroupShape(const GroupShape& other)
+            : parent_(nullptr), left_(other.left_), top_(other.top_), right_(other.right_),
+            bottom_(other.bottom_), cached_(other.cached_) {
+            children_.reserve(other.children_.size());
+            for (const auto& child : other.children_) {
+                adopt(child->clone());
+            }
+        }
+
+        void adopt(std::unique_ptr<IShape> child) {
+            if (GroupShape* group = dynamic_cast<GroupShape*>(child.get())) {
+                group->parent_ = this;
+            }
+            children_.push_back(std::move(child));
+        }
+
+        // A cleared cache implies cleared caches above it, so the walk stops
+        // at the first
+        void invalidate() {
+            for (GroupShape* group = this; group != nullptr && group->cached_; group = group->parent_) {
+                group->cached_ = false;
+            }
+        }
+
+        void shift(int dx, int dy) {
+            for (auto& child : children_) {
+                if (GroupShape* group = dynamic_cast<GroupShape*>(child.get())) {
+                    group->shift(dx, dy);
+                }
+                else {
+                    BoundingBox bounds = child->getBoundingBox();
+                    child = makeShape(BoundingBox(bounds.getX() + dx, bounds.getY() + dy,
+                        bounds.getWidth(), bounds.getHeight()), child->record());
+                }
+            }
+            left_ += dx;
+            right_ += dx;
+            top_ += dy;
+            bottom_ += dy;
+        }
+
+    public:
+        GroupShape() : parent_(nullptr), left_(0), top_(0), right_(0), bottom_(0), cached_(false) {
+        }
+
+        GroupShape& operator=(const GroupShape&) = delete;
+
+        void add(std::unique_ptr<IShape> child) {
+            if (child) {
+                adopt(std::move(child));
+                invalidate();
+            }
+        }
+
+        size_t childCount() const { return children_.size(); }
+        const IShape& child(size_t index) const { return *children_[index]; }
+
+        // A child group, for editing it in place; nullptr if the child is a
+        // shape
+        GroupShape* childGroup(size_t index) {
+            return dynamic_cast<GroupShape*>(children_[index].get());
+        }
+
+        // Shapes under this group, nested ones included
+        size_t shapeCount() const {
+            size_t count = 0;
+            for (const auto& child : children_) {
+                const GroupShape* group = child->asGroup();
+                count += group ? group->shapeCount() : 1;
+            }
+            return count;
+        }
+
+        // Moves every shape under the group
+        void translate(int dx, int dy) {
+            shift(dx, dy);
+            if (parent_ != nullptr) {
+                parent_->invalidate();
+            }
+        }
+
+        std::string serialize() const override {
+            std::string result = "GROUP " + getBoundingBox().serialize();
+            for (const auto& child : children_) {
+                std::string lines = child->serialize();
+                for (size_t at = lines.find('\n'); at != std::string::npos; at = lines.find('\n', at + 3)) {
+                    lines.insert(at + 1, "  ");
+                }
+                result += "\n  " + lines;
+            }
+            return result;
+        }
+
+        std::string getType() const override { return "Group"; }
+
+        std::string getDescription() const override {
+            return "Group of " + std::to_string(static_cast<unsigned long long>(shapeCount())) + " shape(s) " +
+                getBoundingBox().describe();
+        }
+
+        // The union of the children's bounds; empty at the origin if there
+        // are none
+        BoundingBox getBoundingBox() const override {
+            if (!cached_) {
+                int left = INT_MAX, top = INT_MAX, right = INT_MIN, bottom = INT_MIN;
+                for (const auto& child : children_) {
+                    BoundingBox bounds = child->getBoundingBox();
+                    left = std::min(left, std::min(bounds.getX(), bounds.getRight()));
+                    top = std::min(top, std::min(bounds.getY(), bounds.getBottom()));
+                    right = std::max(right, std::max(bounds.getX(), bounds.getRight()));
+                    bottom = std::max(bottom, std::max(bounds.getY(), bounds.getBottom()));
+                }
+                if (children_.empty()) {
+                    left = top = right = bottom = 0;
+                }
+                left_ = left;
+                top_ = top;
+                right_ = right;
+                bottom_ = bottom;
+                cached_ = true;
+            }
+            return BoundingBox(left_, top_, right_ - left_, bottom_ - top_);
+        }
+
+        std::string getColor() const override { return "none"; }
+        std::string getFillColor() const override { return "none"; }
+        std::string getText() const override { return ""; }
+
+        void draw(Painting::IPainter& painter) const override {
+            for (const auto& child : children_) {
+                child->draw(painter);
+            }
+        }
+
+        const ShapeRecord& record() const override {
+            throw std::logic_error("A group has no shape record of its own");
+        }
+
+        const GroupShape* asGroup() const override {
+            return this;
+        }
+
+        std::unique_ptr<IShape> clone() const override {
+            return std::unique_ptr<IShape>(new GroupShape(*this));
+        }
+
+        size_t memoryUsage() const override {
+            size_t bytes = sizeof(*this) + children_.capacity() * sizeof(std::unique_ptr<IShape>);
+            for (const auto& child : children_) {
+                bytes += child->memoryUsage();
+            }
+            return bytes;
+        }
+    };
+
+}
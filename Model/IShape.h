@@ -8,6 +8,9 @@ namespace Painting {
 
 namespace Model {
 
+    class ShapeRecord;
+    class GroupShape;
+
     class IShape {
     public:
         virtual ~IShape() {}
@@ -22,7 +25,17 @@ namespace Model {
 
         virtual void draw(Painting::IPainter& painter) const = 0;
 
+        // The value a slide stores for this shape; a group has none, so
+        // check asGroup() first
+        virtual const ShapeRecord& record() const = 0;
+
+        // This shape as a group of others, or nullptr
+        virtual const GroupShape* asGroup() const { return nullptr; }
+
         virtual std::unique_ptr<IShape> clone() const = 0;
+
+        // Bytes this object holds; colors and text are pooled and not counted
+        virtual size_t memoryUsage() const = 0;
     };
 
 }
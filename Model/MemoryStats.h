@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace Model {
+
+    enum class MemoryCategory {
+        SHAPE_RECORDS,
+        SHAPE_GEOMETRY,
+        SHAPE_IDS,
+        Z_ORDER,
+        SLIDES,
+        SLIDE_LISTS,
+        INDEXES,
+        GROUPS
+    };
+
+    const size_t kMemoryCategoryCount = 8;
+    const size_t kMaxShapeKinds = 8;
+
+    // Running totals of the memory the model holds, by category, and of the
+    // shapes stored by kind. Components add to them as they allocate and
+    // release, so reading them costs nothing however large the deck is.
+    // Storage shared between versions is counted once, and the totals cover
+    // every version alive: the live deck and those kept for undo alike.
+    class MemoryStats {
+        std::atomic<long long> bytes_[kMemoryCategoryCount];
+        std::atomic<long long> shapes_[kMaxShapeKinds];
+
+        MemoryStats() {
+            for (auto& bytes : bytes_) bytes.store(0, std::memory_order_relaxed);
+            for (auto& shapes : shapes_) shapes.store(0, std::memory_order_relaxed);
+        }
+
+        MemoryStats(const MemoryStats&) = delete;
+        MemoryStats& operator=(const MemoryStats&) = delete;
+
+    public:
+        // Never destroyed, so objects released at exit can still be counted
+        static MemoryStats& getInstance() {
+            static MemoryStats* const instance = new MemoryStats();
+            return *instance;
+        }
+
+        void add(MemoryCategory category, long long bytes) {
+            bytes_[static_cast<size_t>(category)].fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        long long bytes(MemoryCategory category) const {
+            return bytes_[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+        }
+
+        void addShapes(size_t kind, long long count) {
+            shapes_[kind].fetch_add(count, std::memory_order_relaxed);
+        }
+
+        long long shapes(size_t kind) const {
+            return shapes_[kind].load(std::memory_order_relaxed);
+        }
+
+        long long totalBytes() const {
+            long long total = 0;
+            for (const auto& bytes : bytes_) total += bytes.load(std::memory_order_relaxed);
+            return total;
+        }
+    };
+
+    // Forwards to another resource, counting what is outstanding under one
+    // category
+    class CountingResource : public std::pmr::memory_resource {
+        std::pmr::memory_resource* upstream_;
+        MemoryCategory category_;
+
+    public:
+        CountingResource(std::pmr::memory_resource* upstream, MemoryCategory category)
+            : upstream_(upstream), category_(category) {
+        }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            void* block = upstream_->allocate(bytes, alignment);
+            MemoryStats::getInstance().add(category_, static_cast<long long>(bytes));
+            return block;
+        }
+
+        void do_deallocate(void* block, size_t bytes, size_t alignment) override {
+            upstream_->deallocate(block, bytes, alignment);
+            MemoryStats::getInstance().add(category_, -static_cast<long long>(bytes));
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    // A byte count one object holds in a category, for structures that grow
+    // outside a memory resource; the object sets it after each change and
+    // the destructor takes it back. A copy holds nothing until set.
+    class TrackedBytes {
+        MemoryCategory category_;
+        long long bytes_;
+
+    public:
+        explicit TrackedBytes(MemoryCategory category) : category_(category), bytes_(0) {
+        }
+
+        TrackedBytes(const TrackedBytes& other) : category_(other.category_), bytes_(0) {
+        }
+
+        TrackedBytes& operator=(const TrackedBytes&) {
+            return *this;
+        }
+
+        ~TrackedBytes() {
+            set(0);
+        }
+
+        void set(long long bytes) {
+            if (bytes != bytes_) {
+                MemoryStats::getInstance().add(category_, bytes - bytes_);
+                bytes_ = bytes;
+            }
+        }
+
+        long long get() const { return bytes_; }
+    };
+
+    // Base for objects counted by their own size: Derived adds sizeof(Derived)
+    // to the category for as long as it lives
+    template <typename Derived, MemoryCategory Category>
+    class CountedObject {
+    protected:
+        CountedObject() {
+            MemoryStats::getInstance().add(Category, static_cast<long long>(sizeof(Derived)));
+        }
+
+        CountedObject(const CountedObject&) {
+            MemoryStats::getInstance().add(Category, static_cast<long long>(sizeof(Derived)));
+        }
+
+        CountedObject& operator=(const CountedObject&) {
+            return *this;
+        }
+
+        ~CountedObject() {
+            MemoryStats::getInstance().add(Category, -static_cast<long long>(sizeof(Derived)));
+        }
+    };
+
+}
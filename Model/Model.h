@@ -31,6 +31,8 @@ namespace Model {
             presentation_ = std::make_unique<Presentation>(title);
         }
 
+        // Replaces the current deck. Its arena goes with it, unless slides
+        // from it are still held elsewhere, such as by the undo history.
         void setPresentation(std::unique_ptr<Presentation> pres) {
             presentation_ = std::move(pres);
         }
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include "MemoryStats.h"
+
+namespace Model {
+
+    // A hash table from keys to their positions in a sequence its owner
+    // keeps, for O(1) lookup of an element by id.
+    //
+    // The table is built by the first lookup and kept until the order
+    // changes. Copies share it, so copy-on-write owners and the versions in
+    // the undo history keep the table they were indexed with: after an undo,
+    // lookups are still O(1). An append updates the table in place if no
+    // copy shares it. Any other reordering drops it, which costs no more than
+    // the reordering itself.
+    //
+    // Like ShapeLabel, lookups may run on several threads at once; the table
+    // is immutable once published and swapped atomically. Updates come only
+    // from the thread editing the owner.
+    //
+    // Each table counts its approximate size under INDEXES in MemoryStats,
+    // once however many copies share it.
+    template <typename Key>
+    class PositionIndex {
+        struct Table {
+            std::unordered_map<Key, size_t> positions;
+            TrackedBytes tracked;
+
+            Table() : tracked(MemoryCategory::INDEXES) {
+            }
+
+            // A node per entry, holding the pair and the next pointer, plus
+            // the bucket array
+            void track() {
+                tracked.set(static_cast<long long>(sizeof(Table) +
+                    positions.size() * (sizeof(std::pair<const Key, size_t>) + 2 * sizeof(void*)) +
+                    positions.bucket_count() * sizeof(void*)));
+            }
+        };
+
+        mutable std::shared_ptr<Table> table_;
+
+    public:
+        static const size_t npos = static_cast<size_t>(-1);
+
+        PositionIndex() = default;
+
+        PositionIndex(const PositionIndex& other) : table_(std::atomic_load(&other.table_)) {
+        }
+
+        PositionIndex& operator=(const PositionIndex& other) {
+            std::atomic_store(&table_, std::atomic_load(&other.table_));
+            return *this;
+        }
+
+        // The order changed; rebuild on the next lookup
+        void invalidate() {
+            std::atomic_store(&table_, std::shared_ptr<Table>());
+        }
+
+        // key was added at position, after every other element
+        void appended(const Key& key, size_t position) {
+            if (table_ && table_.use_count() == 1) {
+                table_->positions[key] = position;
+                table_->track();
+            }
+            else {
+                invalidate();
+            }
+        }
+
+        // The position of key among count elements, or npos. forEachKey(add)
+        // calls add with each element's key, in order.
+        template <typename ForEachKey>
+        size_t find(const Key& key, size_t count, const ForEachKey& forEachKey) const {
+            std::shared_ptr<Table> table = std::atomic_load(&table_);
+            if (!table) {
+                table = std::make_shared<Table>();
+                table->positions.reserve(count);
+                size_t position = 0;
+                forEachKey([&table, &position](const Key& each) { table->positions.emplace(each, position++); });
+                table->track();
+                std::atomic_store(&table_, table);
+            }
+            auto found = table->positions.find(key);
+            return found == table->positions.end() ? npos : found->second;
+        }
+
+        // Bytes held by the table, if one is built
+        size_t memoryUsage() const {
+            std::shared_ptr<Table> table = std::atomic_load(&table_);
+            return table ? static_cast<size_t>(table->tracked.get()) : 0;
+        }
+    };
+
+}
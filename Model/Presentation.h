@@ -1,66 +1,226 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <string>
 #include <fstream>
 #include <stdexcept>
 #include <iostream>
+#include "Arena.h"
+#include "ChunkedSequence.h"
+#include "PositionIndex.h"
 #include "Slide.h"
 
 namespace Model {
 
+    // The generation is bumped whenever slides are added, removed or
+    // reordered, the title changes, or an earlier version is restored. Edits
+    // inside a slide bump only that slide's own generation.
+    //
+    // Slides made through makeSlide() keep their shapes in the presentation's
+    // arena, so a large deck is torn down by releasing a few blocks rather
+    // than freeing every shape array. A presentation without an arena uses
+    // the ordinary heap.
+    //
+    // A presentation is a handle to an immutable version of the deck: copying
+    // one, or taking a snapshot(), shares the slide list, the slides and their
+    // shapes. An edit copies only what it changes: the chunks of the slide
+    // list on the path to the slide, the slide being edited and, once its
+    // shapes are written, that slide's arrays. Adding, removing or reaching a
+    // slide by position takes O(log n) in the number of slides.
+    // Older versions stay as they were, so they can be restored, or read on
+    // another thread while the deck is edited.
+    //
+    // Shapes are found by id through a table from slide ids to positions,
+    // kept with the slide list, and the slide's own table of its shapes.
+    //
+    // memoryUsage() adds up this version on its own; MemoryStats keeps the
+    // running totals for every version at once.
     class Presentation {
-        std::vector<std::unique_ptr<Slide>> slides_;
-        std::string title_;
+        struct State {
+            ChunkedSequence<std::shared_ptr<Slide>> slides;
+            std::string title;
+            PositionIndex<std::uint64_t> positions;
+
+            explicit State(std::pmr::memory_resource* resource) : slides(resource) {
+            }
+        };
+
+        std::shared_ptr<Arena> arena_;
+        std::shared_ptr<State> state_;
+        std::uint64_t id_;
+        std::uint64_t generation_;
+
+        static std::uint64_t nextId() {
+            static std::atomic<std::uint64_t> counter(0);
+            return ++counter;
+        }
+
+        // The state, first made private to this version if another shares it
+        State& edit() {
+            if (state_.use_count() > 1) {
+                state_ = std::make_shared<State>(*state_);
+            }
+            return *state_;
+        }
 
     public:
-        explicit Presentation(std::string title = "Untitled")
-            : title_(std::move(title)) {
+        explicit Presentation(std::string title = "Untitled", std::shared_ptr<Arena> arena = Arena::create())
+            : arena_(std::move(arena)), state_(std::make_shared<State>(Arena::resourceOf(arena_, MemoryCategory::SLIDE_LISTS))),
+            id_(nextId()), generation_(0) {
+            state_->title = std::move(title);
         }
 
-        void addSlide(std::unique_ptr<Slide> slide, size_t position = static_cast<size_t>(-1)) {
-            size_t defaultPos = static_cast<size_t>(-1);
-            if (position == defaultPos) {
+        const std::shared_ptr<Arena>& arena() const { return arena_; }
+
+        // Shared by every version of the same deck
+        std::uint64_t id() const { return id_; }
 
-                slides_.push_back(std::move(slide));
+        // An empty slide allocating from this presentation's arena
+        std::unique_ptr<Slide> makeSlide() const {
+            return std::make_unique<Slide>(arena_);
+        }
+
+        std::uint64_t generation() const { return generation_; }
+
+        // The deck as it is now; later edits to this presentation leave it
+        // unchanged
+        std::shared_ptr<const Presentation> snapshot() const {
+            return std::make_shared<const Presentation>(*this);
+        }
+
+        // Makes an earlier version of this deck the current one
+        void restore(const Presentation& version) {
+            if (version.id_ != id_) {
+                throw std::invalid_argument("Version belongs to another presentation");
             }
-            else if (position > slides_.size()) {
+            state_ = version.state_;
+            ++generation_;
+        }
+
+        void addSlide(std::shared_ptr<Slide> slide, size_t position = static_cast<size_t>(-1)) {
+            State& state = edit();
+            ChunkedSequence<std::shared_ptr<Slide>>& slides = state.slides;
+            size_t defaultPos = static_cast<size_t>(-1);
+            if (position != defaultPos && position > slides.size()) {
 
                 std::cout << "[WARNING] Given invalid position. Slide added at the end of presentation. You can use -remove_slide to delete it" << std::endl;
-                slides_.push_back(std::move(slide));
+                position = defaultPos;
+            }
+
+            if (position == defaultPos || position == slides.size()) {
+                std::uint64_t id = slide ? slide->id() : 0;
+                slides.push_back(std::move(slide));
+                state.positions.appended(id, slides.size() - 1);
             }
             else {
-                slides_.insert(slides_.begin() + position, std::move(slide));
+                slides.insert(position, std::move(slide));
+                state.positions.invalidate();
             }
+            ++generation_;
         }
 
-        void removeSlide(size_t index) {
-            if (index >= slides_.size()) {
+        // Returns the removed slide, for callers that may put it back
+        std::shared_ptr<Slide> removeSlide(size_t index) {
+            if (index >= state_->slides.size()) {
                 throw std::out_of_range("Slide index out of range");
             }
-            slides_.erase(slides_.begin() + index);
+            State& state = edit();
+            std::shared_ptr<Slide> removed = state.slides.erase(index);
+            state.positions.invalidate();
+            ++generation_;
+            return removed;
+        }
+
+        // Hands every slide to the caller, leaving the presentation empty
+        std::vector<std::shared_ptr<Slide>> releaseSlides() {
+            std::vector<std::shared_ptr<Slide>> slides;
+            slides.reserve(state_->slides.size());
+            state_->slides.forEach([&slides](const std::shared_ptr<Slide>& slide) { slides.push_back(slide); });
+            State& state = edit();
+            state.slides.clear();
+            state.positions.invalidate();
+            ++generation_;
+            return slides;
         }
 
         size_t slideCount() const {
-            return slides_.size();
+            return state_->slides.size();
+        }
+
+        // Bytes this version holds, counting in full what it shares with
+        // other versions. Walks every slide.
+        size_t memoryUsage() const {
+            size_t bytes = sizeof(Presentation) + sizeof(State) + state_->title.capacity() +
+                state_->slides.memoryUsage() + state_->positions.memoryUsage();
+            state_->slides.forEach([&bytes](const std::shared_ptr<Slide>& slide) { bytes += slide->memoryUsage(); });
+            return bytes;
         }
 
+        // For editing: a slide another version also holds is copied first,
+        // keeping its id, so the edit does not show through to that version
         Slide* getSlide(size_t index) {
-            if (index >= slides_.size()) {
+            if (index >= state_->slides.size()) {
                 throw std::out_of_range("Slide index out of range");
             }
-            return slides_[index].get();
+            std::shared_ptr<Slide>& slide = edit().slides.mutableAt(index);
+            if (slide.use_count() > 1) {
+                slide = std::make_shared<Slide>(*slide);
+            }
+            return slide.get();
         }
 
         const Slide* getSlide(size_t index) const {
-            if (index >= slides_.size()) {
+            if (index >= state_->slides.size()) {
                 throw std::out_of_range("Slide index out of range");
             }
-            return slides_[index].get();
+            return state_->slides.at(index).get();
+        }
+
+        // Calls visit(const Slide&) for slides [first, last) in order
+        template <typename Visit>
+        void forEachSlide(size_t first, size_t last, const Visit& visit) const {
+            state_->slides.forEach(first, last, [&visit](const std::shared_ptr<Slide>& slide) { visit(*slide); });
         }
 
-        const std::vector<std::unique_ptr<Slide>>& getSlides() const {
-            return slides_;
+        // The position of the slide with this id, or npos
+        size_t findSlide(std::uint64_t slideId) const {
+            const ChunkedSequence<std::shared_ptr<Slide>>& slides = state_->slides;
+            size_t index = state_->positions.find(slideId, slides.size(), [&slides](const auto& add) {
+                slides.forEach([&add](const std::shared_ptr<Slide>& slide) { add(slide->id()); });
+            });
+            return index < slides.size() && slides.at(index)->id() == slideId ? index : Slide::npos;
+        }
+
+        // Where the shape with this id is; false if no slide holds it
+        bool findShape(std::uint64_t shapeId, size_t& slideIndex, size_t& shapeIndex) const {
+            size_t slide = findSlide(Slide::slideIdOf(shapeId));
+            if (slide == Slide::npos) {
+                return false;
+            }
+            size_t shape = state_->slides.at(slide)->findShape(shapeId);
+            if (shape == Slide::npos) {
+                return false;
+            }
+            slideIndex = slide;
+            shapeIndex = shape;
+            return true;
+        }
+
+        // Where the group with this id is; false if no slide holds it
+        bool findGroup(std::uint64_t groupId, size_t& slideIndex, size_t& groupIndex) const {
+            size_t slide = findSlide(Slide::slideIdOf(groupId));
+            if (slide == Slide::npos) {
+                return false;
+            }
+            size_t group = state_->slides.at(slide)->findGroup(groupId);
+            if (group == Slide::npos) {
+                return false;
+            }
+            slideIndex = slide;
+            groupIndex = group;
+            return true;
         }
 
         void save(const std::string& filename) const {
@@ -68,10 +228,10 @@ namespace Model {
             if (!out) {
                 throw std::runtime_error("Cannot open file for writing: " + filename);
             }
-            out << "PRESENTATION " << title_ << "\n";
-            for (const auto& slide : slides_) {
+            out << "PRESENTATION " << state_->title << "\n";
+            state_->slides.forEach([&out](const std::shared_ptr<Slide>& slide) {
                 out << slide->serialize() << "\n";
-            }
+            });
         }
 
         void load(const std::string& filename) {
@@ -80,23 +240,29 @@ namespace Model {
                 throw std::runtime_error("Cannot open file for reading: " + filename);
             }
 
-            slides_.clear();
+            State& state = edit();
+            state.slides.clear();
+            state.positions.invalidate();
+            ++generation_;
             std::string line;
 
             if (std::getline(in, line) && line.rfind("PRESENTATION ", 0) == 0) {
-                title_ = line.substr(13);
+                state.title = line.substr(13);
             }
 
             while (std::getline(in, line)) {
                 if (line.rfind("SLIDE ", 0) == 0) {
-                    slides_.push_back(std::make_unique<Slide>());
+                    state.slides.push_back(makeSlide());
+                    ++generation_;
                 }
             }
         }
 
-        const std::string& title() const { return title_; }
-        void setTitle(const std::string& title) { title_ = title; }
+        const std::string& title() const { return state_->title; }
+        void setTitle(const std::string& title) {
+            edit().title = title;
+            ++generation_;
+        }
     };
 
 }
-
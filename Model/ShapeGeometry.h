@@ -0,0 +1,250 @@
+#pragma once
+#include "BoundingBox.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace Model {
+
+    // The bounds of a slide's shapes as parallel arrays, index for index with
+    // its shape records. Bulk edits run as straight loops over plain int
+    // arrays with no calls or branches in the body, which compilers turn into
+    // SIMD code; a selection is a byte mask (1 = selected) rather than a list
+    // of indices, so masked loops vectorize too. The arrays come from the
+    // given memory resource, normally the slide's arena; a copy uses the
+    // default resource unless it is assigned into an existing geometry.
+    class ShapeGeometry {
+        std::pmr::vector<int> x_;
+        std::pmr::vector<int> y_;
+        std::pmr::vector<int> width_;
+        std::pmr::vector<int> height_;
+
+        // Edits saturate at the ends of the int range rather than wrap;
+        // commands check with canTranslate() and canScale() first, so this
+        // only guards callers that do not
+        static int saturate(std::int64_t v) {
+            return static_cast<int>(std::min<std::int64_t>(std::max<std::int64_t>(v, INT_MIN), INT_MAX));
+        }
+
+        // floor(v + 0.5), clamped to the int range, written so that it
+        // vectorizes
+        static int roundToInt(double v) {
+            double shifted = std::min(std::max(v + 0.5, static_cast<double>(INT_MIN)), static_cast<double>(INT_MAX));
+            int truncated = static_cast<int>(shifted);
+            return truncated - (shifted < truncated ? 1 : 0);
+        }
+
+        // Where an edge at position lands when scaled about origin. Worked in
+        // double, where int differences are exact, and rounded like
+        // roundToInt, but not clamped, so callers can check the range.
+        static double scaledEdge(double position, double factor, int origin) {
+            return std::floor(origin + (position - origin) * factor + 0.5);
+        }
+
+        static bool inIntRange(double v) {
+            return v >= static_cast<double>(INT_MIN) && v <= static_cast<double>(INT_MAX);
+        }
+
+        // Scales one axis about origin. Both edges are scaled and the size
+        // taken from them, so shapes that touched before still touch.
+        static void scaleAxis(int* position, int* size, size_t count, double factor, int origin,
+            const std::uint8_t* mask) {
+            if (mask == nullptr) {
+                for (size_t i = 0; i < count; ++i) {
+                    int start = roundToInt(origin + (static_cast<double>(position[i]) - origin) * factor);
+                    int end = roundToInt(origin + (static_cast<double>(position[i]) + size[i] - origin) * factor);
+                    position[i] = start;
+                    size[i] = saturate(static_cast<std::int64_t>(end) - start);
+                }
+                return;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                int start = roundToInt(origin + (static_cast<double>(position[i]) - origin) * factor);
+                int end = roundToInt(origin + (static_cast<double>(position[i]) + size[i] - origin) * factor);
+                position[i] = mask[i] ? start : position[i];
+                size[i] = mask[i] ? saturate(static_cast<std::int64_t>(end) - start) : size[i];
+            }
+        }
+
+        static bool canScaleAxis(const int* position, const int* size, size_t count, double factor, int origin,
+            const std::uint8_t* mask) {
+            for (size_t i = 0; i < count; ++i) {
+                if (mask != nullptr && !mask[i]) continue;
+                double start = scaledEdge(position[i], factor, origin);
+                double end = scaledEdge(static_cast<double>(position[i]) + size[i], factor, origin);
+                if (!inIntRange(start) || !inIntRange(end) || !inIntRange(end - start)) return false;
+            }
+            return true;
+        }
+
+        static bool canTranslateAxis(const int* position, const int* size, size_t count, int delta,
+            const std::uint8_t* mask) {
+            for (size_t i = 0; i < count; ++i) {
+                if (mask != nullptr && !mask[i]) continue;
+                std::int64_t start = static_cast<std::int64_t>(position[i]) + delta;
+                std::int64_t end = start + size[i];
+                if (start < INT_MIN || start > INT_MAX || end < INT_MIN || end > INT_MAX) return false;
+            }
+            return true;
+        }
+
+    public:
+        explicit ShapeGeometry(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : x_(resource), y_(resource), width_(resource), height_(resource) {
+        }
+
+        size_t size() const { return x_.size(); }
+        bool empty() const { return x_.empty(); }
+
+        // Bytes held by the arrays
+        size_t memoryUsage() const {
+            return (x_.capacity() + y_.capacity() + width_.capacity() + height_.capacity()) * sizeof(int);
+        }
+
+        void reserve(size_t count) {
+            x_.reserve(count);
+            y_.reserve(count);
+            width_.reserve(count);
+            height_.reserve(count);
+        }
+
+        // Exchanges contents; arrays from different resources are copied,
+        // each side keeping its own resource
+        void swap(ShapeGeometry& other) {
+            if (x_.get_allocator() == other.x_.get_allocator()) {
+                x_.swap(other.x_);
+                y_.swap(other.y_);
+                width_.swap(other.width_);
+                height_.swap(other.height_);
+                return;
+            }
+            ShapeGeometry saved(*this);
+            *this = other;
+            other = saved;
+        }
+
+        void push_back(const BoundingBox& bounds) {
+            x_.push_back(bounds.getX());
+            y_.push_back(bounds.getY());
+            width_.push_back(bounds.getWidth());
+            height_.push_back(bounds.getHeight());
+        }
+
+        void pop_back() {
+            x_.pop_back();
+            y_.pop_back();
+            width_.pop_back();
+            height_.pop_back();
+        }
+
+        void erase(size_t index) {
+            x_.erase(x_.begin() + index);
+            y_.erase(y_.begin() + index);
+            width_.erase(width_.begin() + index);
+            height_.erase(height_.begin() + index);
+        }
+
+        BoundingBox bounds(size_t index) const {
+            return BoundingBox(x_[index], y_[index], width_[index], height_[index]);
+        }
+
+        const int* xs() const { return x_.data(); }
+        const int* ys() const { return y_.data(); }
+        const int* widths() const { return width_.data(); }
+        const int* heights() const { return height_.data(); }
+
+        void translateAt(size_t index, int dx, int dy) {
+            x_[index] = saturate(static_cast<std::int64_t>(x_[index]) + dx);
+            y_[index] = saturate(static_cast<std::int64_t>(y_[index]) + dy);
+        }
+
+        // Moves every shape, or only those selected by mask
+        void translate(int dx, int dy, const std::uint8_t* mask = nullptr) {
+            const size_t count = x_.size();
+            int* x = x_.data();
+            int* y = y_.data();
+            if (mask == nullptr) {
+                for (size_t i = 0; i < count; ++i) x[i] = saturate(static_cast<std::int64_t>(x[i]) + dx);
+                for (size_t i = 0; i < count; ++i) y[i] = saturate(static_cast<std::int64_t>(y[i]) + dy);
+                return;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                x[i] = saturate(static_cast<std::int64_t>(x[i]) + (dx & -static_cast<int>(mask[i] != 0)));
+            }
+            for (size_t i = 0; i < count; ++i) {
+                y[i] = saturate(static_cast<std::int64_t>(y[i]) + (dy & -static_cast<int>(mask[i] != 0)));
+            }
+        }
+
+        // Whether translate() keeps both edges of every shape it moves within
+        // the int range
+        bool canTranslate(int dx, int dy, const std::uint8_t* mask = nullptr) const {
+            const size_t count = x_.size();
+            return canTranslateAxis(x_.data(), width_.data(), count, dx, mask) &&
+                canTranslateAxis(y_.data(), height_.data(), count, dy, mask);
+        }
+
+        // Scales positions and sizes about (originX, originY), rounding to
+        // the nearest pixel
+        void scale(double factorX, double factorY, int originX, int originY, const std::uint8_t* mask = nullptr) {
+            const size_t count = x_.size();
+            scaleAxis(x_.data(), width_.data(), count, factorX, originX, mask);
+            scaleAxis(y_.data(), height_.data(), count, factorY, originY, mask);
+        }
+
+        // Whether scale() keeps both edges and the size of every shape it
+        // scales within the int range
+        bool canScale(double factorX, double factorY, int originX, int originY, const std::uint8_t* mask = nullptr) const {
+            const size_t count = x_.size();
+            return canScaleAxis(x_.data(), width_.data(), count, factorX, originX, mask) &&
+                canScaleAxis(y_.data(), height_.data(), count, factorY, originY, mask);
+        }
+
+        // The smallest box holding every shape; false if there are none
+        bool unionBounds(BoundingBox& result) const {
+            const size_t count = x_.size();
+            if (count == 0) return false;
+
+            const int* x = x_.data();
+            const int* y = y_.data();
+            const int* w = width_.data();
+            const int* h = height_.data();
+            int left = INT_MAX, top = INT_MAX, right = INT_MIN, bottom = INT_MIN;
+            for (size_t i = 0; i < count; ++i) {
+                left = std::min(left, x[i]);
+                top = std::min(top, y[i]);
+                right = std::max(right, x[i] + w[i]);
+                bottom = std::max(bottom, y[i] + h[i]);
+            }
+            result = BoundingBox(left, top, right - left, bottom - top);
+            return true;
+        }
+
+        // Marks in mask the shapes whose bounds overlap rect, edges touching
+        // included; returns how many were marked. A negative width or height
+        // extends a box left or up from its corner, as in the spatial index.
+        size_t intersecting(const BoundingBox& rect, std::uint8_t* mask) const {
+            const size_t count = x_.size();
+            const int* x = x_.data();
+            const int* y = y_.data();
+            const int* w = width_.data();
+            const int* h = height_.data();
+            const int left = std::min(rect.getX(), rect.getRight()), right = std::max(rect.getX(), rect.getRight());
+            const int top = std::min(rect.getY(), rect.getBottom()), bottom = std::max(rect.getY(), rect.getBottom());
+            size_t hits = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const int shapeRight = x[i] + w[i], shapeBottom = y[i] + h[i];
+                std::uint8_t hit = static_cast<std::uint8_t>(
+                    (std::min(x[i], shapeRight) <= right) & (std::max(x[i], shapeRight) >= left) &
+                    (std::min(y[i], shapeBottom) <= bottom) & (std::max(y[i], shapeBottom) >= top));
+                mask[i] = hit;
+                hits += hit;
+            }
+            return hits;
+        }
+    };
+
+}
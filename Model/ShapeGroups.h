@@ -0,0 +1,343 @@
+#pragma once
+#include "BoundingBox.h"
+#include "ShapeGeometry.h"
+#include "ZOrder.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace Model {
+
+    // The groups of one slide's shapes. A group holds shapes and other
+    // groups, nested to any depth, and each shape or group has at most one
+    // parent. Shapes are named by slot, as in ZOrder, and groups by their
+    // index in this table, which keeps the order they were made in.
+    //
+    // The shapes under a group, nested ones included, stay together in the
+    // z-order, so every group is a run of it from a bottom slot to a top
+    // slot. Keeping the runs whole is up to the slide, which moves a group's
+    // shapes together; in return a renderer reaching a group's bottom slot
+    // tests the group's bounds once and, if they miss, goes on above its top
+    // slot.
+    //
+    // Each group caches the union of its shapes' bounds. An edit marks stale
+    // the path from the changed shape's group up to the outermost one, and
+    // refresh() recomputes only stale groups, each from its direct members,
+    // with the cached bounds of nested groups standing in for their shapes.
+    // Refreshes may run on several threads at once and are serialized;
+    // edits come only from the thread editing the slide.
+    class ShapeGroups {
+    public:
+        static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+
+        struct Group {
+            std::uint32_t serial;
+            std::uint32_t parent;
+            // Lowest and highest slot of the group's run of the z-order
+            std::uint32_t bottom;
+            std::uint32_t top;
+            // Shapes under the group, nested ones included; never 0
+            std::uint32_t size;
+        };
+
+        struct Box {
+            int left, top, right, bottom;
+
+            bool overlaps(const BoundingBox& area) const {
+                return left <= std::max(area.getX(), area.getRight()) &&
+                    std::min(area.getX(), area.getRight()) <= right &&
+                    top <= std::max(area.getY(), area.getBottom()) &&
+                    std::min(area.getY(), area.getBottom()) <= bottom;
+            }
+
+            BoundingBox toBounds() const {
+                return BoundingBox(left, top, right - left, bottom - top);
+            }
+        };
+
+    private:
+        std::pmr::vector<Group> groups_;
+        // The innermost group holding each slot's shape; empty while the
+        // slide has no groups
+        std::pmr::vector<std::uint32_t> groupOf_;
+        mutable std::pmr::vector<Box> bounds_;
+        mutable std::pmr::vector<std::uint8_t> stale_;
+        mutable bool anyStale_;
+        mutable std::mutex mutex_;
+
+        static Box boxOf(const ShapeGeometry& geometry, size_t slot) {
+            int x = geometry.xs()[slot], y = geometry.ys()[slot];
+            int right = x + geometry.widths()[slot], bottom = y + geometry.heights()[slot];
+            return Box{ std::min(x, right), std::min(y, bottom), std::max(x, right), std::max(y, bottom) };
+        }
+
+        static void unite(Box& box, const Box& other) {
+            box.left = std::min(box.left, other.left);
+            box.top = std::min(box.top, other.top);
+            box.right = std::max(box.right, other.right);
+            box.bottom = std::max(box.bottom, other.bottom);
+        }
+
+        void compute(std::uint32_t group, const ShapeGeometry& geometry, const ZOrder& order) const {
+            const Group& entry = groups_[group];
+            Box box{ INT_MAX, INT_MAX, INT_MIN, INT_MIN };
+            for (std::uint32_t slot = entry.bottom; ; slot = order.above(slot)) {
+                std::uint32_t child = childOf(group, slot);
+                if (child == kNone) {
+                    unite(box, boxOf(geometry, slot));
+                }
+                else {
+                    if (stale_[child]) compute(child, geometry, order);
+                    unite(box, bounds_[child]);
+                    slot = groups_[child].top;
+                }
+                if (slot == entry.top) break;
+            }
+            bounds_[group] = box;
+            stale_[group] = 0;
+        }
+
+        // Drops an entry, renumbering the groups after it
+        void removeEntry(std::uint32_t group) {
+            groups_.erase(groups_.begin() + group);
+            bounds_.erase(bounds_.begin() + group);
+            stale_.erase(stale_.begin() + group);
+            auto renumber = [group](std::uint32_t& link) {
+                if (link != kNone && link > group) --link;
+            };
+            for (Group& entry : groups_) renumber(entry.parent);
+            for (std::uint32_t& link : groupOf_) renumber(link);
+        }
+
+        void markPath(std::uint32_t group) {
+            for (; group != kNone; group = groups_[group].parent) {
+                stale_[group] = 1;
+                anyStale_ = true;
+            }
+        }
+
+    public:
+        explicit ShapeGroups(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : groups_(resource), groupOf_(resource), bounds_(resource), stale_(resource), anyStale_(false) {
+        }
+
+        ShapeGroups(const ShapeGroups& other, std::pmr::memory_resource* resource)
+            : groups_(other.groups_, resource), groupOf_(other.groupOf_, resource), bounds_(resource),
+            stale_(resource), anyStale_(false) {
+            std::lock_guard<std::mutex> lock(other.mutex_);
+            bounds_ = other.bounds_;
+            stale_ = other.stale_;
+            anyStale_ = other.anyStale_;
+        }
+
+        ShapeGroups(const ShapeGroups&) = delete;
+        ShapeGroups& operator=(const ShapeGroups&) = delete;
+
+        size_t size() const { return groups_.size(); }
+        bool empty() const { return groups_.empty(); }
+        const Group& operator[](size_t group) const { return groups_[group]; }
+
+        // Bytes held by the arrays
+        size_t memoryUsage() const {
+            return groups_.capacity() * sizeof(Group) + groupOf_.capacity() * sizeof(std::uint32_t) +
+                bounds_.capacity() * sizeof(Box) + stale_.capacity();
+        }
+
+        // The index of the group with this serial, or kNone; O(groups)
+        std::uint32_t find(std::uint32_t serial) const {
+            for (size_t i = 0; i < groups_.size(); ++i) {
+                if (groups_[i].serial == serial) return static_cast<std::uint32_t>(i);
+            }
+            return kNone;
+        }
+
+        std::uint32_t groupOf(size_t slot) const {
+            return groupOf_.empty() ? kNone : groupOf_[slot];
+        }
+
+        // The group directly under parent, kNone for the slide itself, that
+        // holds slot's shape; kNone if the shape is directly under parent.
+        // The shape must lie under parent.
+        std::uint32_t childOf(std::uint32_t parent, size_t slot) const {
+            std::uint32_t child = kNone;
+            for (std::uint32_t group = groupOf(slot); group != parent; group = groups_[group].parent) {
+                child = group;
+            }
+            return child;
+        }
+
+        // Whether group is, or lies within, ancestor
+        bool within(std::uint32_t group, std::uint32_t ancestor) const {
+            for (; group != kNone; group = groups_[group].parent) {
+                if (group == ancestor) return true;
+            }
+            return false;
+        }
+
+        // A shape was added as the last slot, outside any group
+        void appended() {
+            if (!groupOf_.empty()) groupOf_.push_back(kNone);
+        }
+
+        // The shape in slot is about to be removed, and the slots above it
+        // to move down by one; order must not have been updated yet. Groups
+        // left empty are dropped.
+        void erasing(size_t slot, const ZOrder& order) {
+            if (groupOf_.empty()) return;
+            const std::uint32_t removed = static_cast<std::uint32_t>(slot);
+            // Sizes shrink outward, so the emptied groups are the innermost
+            // of the path, and nothing else refers to them
+            std::vector<std::uint32_t> emptied;
+            for (std::uint32_t group = groupOf_[slot]; group != kNone; group = groups_[group].parent) {
+                Group& entry = groups_[group];
+                if (--entry.size == 0) {
+                    emptied.push_back(group);
+                    continue;
+                }
+                if (entry.bottom == removed) entry.bottom = order.above(removed);
+                if (entry.top == removed) entry.top = order.below(removed);
+                stale_[group] = 1;
+                anyStale_ = true;
+            }
+            std::sort(emptied.begin(), emptied.end());
+            for (auto it = emptied.rbegin(); it != emptied.rend(); ++it) {
+                removeEntry(*it);
+            }
+            groupOf_.erase(groupOf_.begin() + slot);
+            for (Group& entry : groups_) {
+                if (entry.bottom > removed) --entry.bottom;
+                if (entry.top > removed) --entry.top;
+            }
+            if (groups_.empty()) {
+                groupOf_.clear();
+            }
+        }
+
+        // A new group under parent whose run is already [bottom, top] and
+        // holds exactly the given shapes, directly, and groups; returns its
+        // index
+        std::uint32_t create(std::uint32_t serial, std::uint32_t parent, std::uint32_t bottom, std::uint32_t top,
+            const std::vector<size_t>& shapes, const std::vector<size_t>& groups, size_t slotCount) {
+            if (groupOf_.empty()) {
+                groupOf_.assign(slotCount, kNone);
+            }
+            const std::uint32_t group = static_cast<std::uint32_t>(groups_.size());
+            std::uint32_t size = static_cast<std::uint32_t>(shapes.size());
+            for (size_t child : groups) {
+                groups_[child].parent = group;
+                size += groups_[child].size;
+            }
+            for (size_t slot : shapes) {
+                groupOf_[slot] = group;
+            }
+            groups_.push_back(Group{ serial, parent, bottom, top, size });
+            bounds_.push_back(Box{ 0, 0, 0, 0 });
+            stale_.push_back(1);
+            markPath(group);
+            return group;
+        }
+
+        // Removes group, handing its members to its parent
+        void dissolve(std::uint32_t group) {
+            const std::uint32_t parent = groups_[group].parent;
+            for (Group& entry : groups_) {
+                if (entry.parent == group) entry.parent = parent;
+            }
+            for (std::uint32_t& link : groupOf_) {
+                if (link == group) link = parent;
+            }
+            removeEntry(group);
+            if (groups_.empty()) {
+                groupOf_.clear();
+            }
+        }
+
+        // The run [bottom, top], a member of parent, is about to move to just
+        // above anchor, which is in parent's run or just below it; updates
+        // the ends of parent, and of its ancestors that share them. order
+        // must not have been updated yet.
+        void moving(std::uint32_t parent, std::uint32_t bottom, std::uint32_t top, std::uint32_t anchor,
+            const ZOrder& order) {
+            if (parent == kNone) return;
+            const std::uint32_t oldBottom = groups_[parent].bottom, oldTop = groups_[parent].top;
+            std::uint32_t newBottom = oldBottom, newTop = oldTop;
+            if (bottom == oldBottom) newBottom = order.above(top);
+            if (top == oldTop) newTop = order.below(bottom);
+            if (anchor == order.below(oldBottom)) newBottom = bottom;
+            if (anchor == oldTop) newTop = top;
+            for (std::uint32_t group = parent; group != kNone; group = groups_[group].parent) {
+                Group& entry = groups_[group];
+                if (entry.bottom != oldBottom && entry.top != oldTop) break;
+                if (entry.bottom == oldBottom) entry.bottom = newBottom;
+                if (entry.top == oldTop) entry.top = newTop;
+            }
+        }
+
+        // Marks stale the groups holding slot's shape
+        void touched(size_t slot) {
+            markPath(groupOf(slot));
+        }
+
+        // Marks stale the groups holding a shape selected by mask, or every
+        // group if mask is nullptr
+        void touched(const std::uint8_t* mask) {
+            if (groups_.empty()) return;
+            if (mask == nullptr) {
+                std::fill(stale_.begin(), stale_.end(), std::uint8_t(1));
+                anyStale_ = true;
+                return;
+            }
+            for (size_t slot = 0; slot < groupOf_.size(); ++slot) {
+                if (mask[slot] && groupOf_[slot] != kNone && !stale_[groupOf_[slot]]) {
+                    markPath(groupOf_[slot]);
+                }
+            }
+        }
+
+        // Every shape under group moved by (dx, dy): its cached bounds, and
+        // those of groups within it, move too, and only the groups around
+        // it go stale
+        void shifted(std::uint32_t group, int dx, int dy) {
+            for (size_t i = 0; i < groups_.size(); ++i) {
+                if (within(static_cast<std::uint32_t>(i), group)) {
+                    Box& box = bounds_[i];
+                    box.left += dx;
+                    box.right += dx;
+                    box.top += dy;
+                    box.bottom += dy;
+                }
+            }
+            markPath(groups_[group].parent);
+        }
+
+        // Recomputes the stale groups' bounds
+        void refresh(const ShapeGeometry& geometry, const ZOrder& order) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!anyStale_) return;
+            for (size_t i = 0; i < groups_.size(); ++i) {
+                if (stale_[i]) compute(static_cast<std::uint32_t>(i), geometry, order);
+            }
+            anyStale_ = false;
+        }
+
+        // Cached bounds; refresh() first
+        const Box& bounds(size_t group) const {
+            return bounds_[group];
+        }
+
+        // Of the groups whose runs start at slot, the outermost one whose
+        // bounds miss viewport; kNone if none do. refresh() first.
+        std::uint32_t culled(size_t slot, const BoundingBox& viewport) const {
+            std::uint32_t missed = kNone;
+            for (std::uint32_t group = groupOf(slot); group != kNone && groups_[group].bottom == slot;
+                group = groups_[group].parent) {
+                if (!bounds_[group].overlaps(viewport)) missed = group;
+            }
+            return missed;
+        }
+    };
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "BoundingBox.h"
+#include "StringPool.h"
+#include "../Painting/IPainter.h"
+#include "../Painting/StylePalette.h"
+#include "../Painting/TextLayout.h"
+#include <memory>
+#include <string>
+
+namespace Model {
+
+    // A shape's text laid out inside its bounds. The layout is resolved on the
+    // first draw and kept with the shape, so later draws only replay the
+    // stored lines; it is redone only if the text, its style or the size of
+    // the box has changed since.
+    // Copy-on-write slides share records, so two render threads may draw the
+    // same label at once: the layout and the box it was made for are held in
+    // one immutable object that is swapped atomically.
+    class ShapeLabel {
+        static const int kPadding = 4;
+
+        struct Fitted {
+            std::shared_ptr<const Painting::TextBlock> block;
+            Painting::TextStyleHandle style;
+            StringHandle text;
+            Painting::TextStyleHandle baseStyle;
+            int boxWidth;
+            int boxHeight;
+
+            bool fits(StringHandle label, Painting::TextStyleHandle labelStyle, const BoundingBox& bounds) const {
+                return text == label && baseStyle == labelStyle &&
+                    boxWidth == bounds.getWidth() && boxHeight == bounds.getHeight();
+            }
+        };
+
+        mutable std::shared_ptr<const Fitted> fitted_;
+
+    public:
+        ShapeLabel() = default;
+
+        ShapeLabel(const ShapeLabel& other) : fitted_(std::atomic_load(&other.fitted_)) {
+        }
+
+        ShapeLabel& operator=(const ShapeLabel& other) {
+            std::atomic_store(&fitted_, std::atomic_load(&other.fitted_));
+            return *this;
+        }
+
+        void draw(Painting::IPainter& painter, StringHandle textHandle, const BoundingBox& bounds,
+            Painting::TextStyleHandle baseStyle) const {
+            const std::string& text = StringPool::getInstance().get(textHandle);
+            if (text.empty()) return;
+
+            std::shared_ptr<const Fitted> fitted = std::atomic_load(&fitted_);
+            if (!fitted || !fitted->fits(textHandle, baseStyle, bounds)) {
+                auto& palette = Painting::StylePalette::getInstance();
+                Painting::TextStyle base = palette.textStyle(baseStyle);
+
+                auto block = Painting::TextLayout::getInstance().layout(text, base.fontFamily, base.fontSize,
+                    bounds.getWidth() - 2 * kPadding, bounds.getHeight() - 2 * kPadding);
+                Painting::TextStyleHandle style = block->fontSize == base.fontSize
+                    ? baseStyle
+                    : palette.internTextStyle(base.fontFamily, block->fontSize, base.color, base.anchor);
+                fitted = std::make_shared<const Fitted>(Fitted{ block, style, textHandle, baseStyle,
+                    bounds.getWidth(), bounds.getHeight() });
+                std::atomic_store(&fitted_, fitted);
+            }
+
+            const Painting::TextBlock& block = *fitted->block;
+            const auto& lines = block.lines;
+            int y = bounds.getCenterY() - static_cast<int>(lines.size() - 1) * block.lineHeight / 2;
+            for (size_t i = 0; i < lines.size(); ++i) {
+                if (!lines[i].empty()) {
+                    painter.drawText(bounds.getCenterX(), y, lines[i], fitted->style);
+                }
+                y += block.lineHeight;
+            }
+        }
+    };
+
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include "BoundingBox.h"
+#include "ShapeStyle.h"
+#include "ShapeLabel.h"
+#include "StringPool.h"
+#include "../Painting/IPainter.h"
+#include "../Painting/StylePalette.h"
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace Model {
+
+    enum class ShapeKind : std::uint8_t {
+        RECTANGLE,
+        CIRCLE,
+        TRIANGLE,
+        TRAPEZOID,
+        PARALLELOGRAM,
+        RHOMBUS,
+        TEXT
+    };
+
+    const size_t kShapeKindCount = 7;
+
+    // One shape as a plain value. Slides store these contiguously, so walking
+    // a slide touches one array instead of a heap object per shape, and
+    // copying a slide is one allocation. Colors and text are StringPool
+    // handles, so copying a record copies no characters. Bounds are kept
+    // apart, in the slide's ShapeGeometry, and passed in where needed. The
+    // geometry of every kind lives in draw(); the IShape classes in Shapes.h
+    // wrap a record and its bounds for callers that want the interface.
+    class ShapeRecord {
+        ShapeStyle style_;
+        ShapeKind kind_;
+        StringHandle color_;
+        StringHandle fillColor_;
+        StringHandle text_;
+        ShapeLabel label_;
+
+        static const std::string& lookup(StringHandle handle) {
+            return StringPool::getInstance().get(handle);
+        }
+
+        void drawPolygon(Painting::IPainter& painter, const int* xPoints, const int* yPoints, int numPoints) const {
+            painter.drawPolygon(xPoints, yPoints, numPoints, style_.pen, style_.brush);
+        }
+
+        // Text boxes have no outline or fill to intern
+        ShapeRecord(const std::string& text, const std::string& textColor)
+            : style_{ Painting::PenHandle{ 0 }, Painting::BrushHandle{ 0 }, Painting::TextStyleHandle{ 0 } },
+            kind_(ShapeKind::TEXT), color_(StringPool::getInstance().intern(textColor)),
+            fillColor_(StringPool::getInstance().intern("none")), text_(StringPool::getInstance().intern(text)) {
+        }
+
+    public:
+        ShapeRecord(ShapeKind kind, const std::string& color = "black",
+            const std::string& fillColor = "none", const std::string& text = "")
+            : style_(ShapeStyle::make(color, fillColor)), kind_(kind),
+            color_(StringPool::getInstance().intern(color)), fillColor_(StringPool::getInstance().intern(fillColor)),
+            text_(StringPool::getInstance().intern(text)) {
+        }
+
+        // A text box; its font is kept only in the interned label style
+        static ShapeRecord makeText(const std::string& text, const std::string& textColor = "black",
+            const std::string& fontFamily = "Arial", int fontSize = 14) {
+            ShapeRecord record(text, textColor);
+            record.style_.label = Painting::StylePalette::getInstance().internTextStyle(fontFamily, fontSize,
+                Painting::Color(textColor));
+            return record;
+        }
+
+        // Maps the "type" names used by JSON files and getType()
+        static bool kindFromType(const std::string& type, ShapeKind& kind) {
+            static const ShapeKind kinds[] = { ShapeKind::RECTANGLE, ShapeKind::CIRCLE, ShapeKind::TRIANGLE,
+                ShapeKind::TRAPEZOID, ShapeKind::PARALLELOGRAM, ShapeKind::RHOMBUS, ShapeKind::TEXT };
+            for (ShapeKind candidate : kinds) {
+                if (type == typeName(candidate)) {
+                    kind = candidate;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static const char* typeName(ShapeKind kind) {
+            switch (kind) {
+            case ShapeKind::RECTANGLE: return "Rectangle";
+            case ShapeKind::CIRCLE: return "Circle";
+            case ShapeKind::TRIANGLE: return "Triangle";
+            case ShapeKind::TRAPEZOID: return "Trapezoid";
+            case ShapeKind::PARALLELOGRAM: return "Parallelogram";
+            case ShapeKind::RHOMBUS: return "Rhombus";
+            case ShapeKind::TEXT: return "Text";
+            }
+            return "";
+        }
+
+        ShapeKind kind() const { return kind_; }
+        const ShapeStyle& style() const { return style_; }
+        const std::string& text() const { return lookup(text_); }
+
+        // A text box reports no outline or fill of its own
+        const std::string& color() const {
+            static const std::string none = "none";
+            return kind_ == ShapeKind::TEXT ? none : lookup(color_);
+        }
+
+        const std::string& fillColor() const {
+            static const std::string none = "none";
+            return kind_ == ShapeKind::TEXT ? none : lookup(fillColor_);
+        }
+
+        const std::string& fontFamily() const {
+            return Painting::StylePalette::getInstance().textStyle(style_.label).fontFamily;
+        }
+
+        int fontSize() const {
+            return Painting::StylePalette::getInstance().textStyle(style_.label).fontSize;
+        }
+
+        std::string getType() const {
+            return typeName(kind_);
+        }
+
+        std::string serialize(const BoundingBox& bounds) const {
+            if (kind_ == ShapeKind::TEXT) {
+                return "TEXT " + bounds.serialize() + " \"" + text() + "\"";
+            }
+
+            static const char* const keywords[] = { "RECT", "CIRCLE", "TRIANGLE", "TRAPEZOID", "PARALLELOGRAM", "RHOMBUS" };
+            std::string result = std::string(keywords[static_cast<int>(kind_)]) + " " + bounds.serialize() + " " + lookup(color_);
+            if (text_.index != 0) result += " \"" + text() + "\"";
+            return result;
+        }
+
+        std::string getDescription(const BoundingBox& bounds) const {
+            std::ostringstream oss;
+            if (kind_ == ShapeKind::TEXT) {
+                oss << "Text " << bounds.describe() << " \"" << text() << "\"";
+                return oss.str();
+            }
+
+            oss << typeName(kind_) << " " << bounds.describe() << " [" << lookup(color_) << "]";
+            if (text_.index != 0) oss << " text: \"" << text() << "\"";
+            return oss.str();
+        }
+
+        void draw(Painting::IPainter& painter, const BoundingBox& b) const {
+            switch (kind_) {
+            case ShapeKind::RECTANGLE: {
+                int xPoints[4] = { b.getX(), b.getRight(), b.getRight(), b.getX() };
+                int yPoints[4] = { b.getY(), b.getY(), b.getBottom(), b.getBottom() };
+                drawPolygon(painter, xPoints, yPoints, 4);
+                break;
+            }
+            case ShapeKind::CIRCLE:
+                painter.drawEllipse(b.getCenterX(), b.getCenterY(), b.getWidth() / 2, b.getHeight() / 2,
+                    style_.pen, style_.brush);
+                break;
+            case ShapeKind::TRIANGLE: {
+                int xPoints[3] = { b.getX(), b.getRight(), b.getCenterX() };
+                int yPoints[3] = { b.getBottom(), b.getBottom(), b.getY() };
+                drawPolygon(painter, xPoints, yPoints, 3);
+                break;
+            }
+            case ShapeKind::TRAPEZOID: {
+                int indent = b.getWidth() / 4;
+                int xPoints[4] = { b.getX(), b.getRight(), b.getRight() - indent, b.getX() + indent };
+                int yPoints[4] = { b.getBottom(), b.getBottom(), b.getY(), b.getY() };
+                drawPolygon(painter, xPoints, yPoints, 4);
+                break;
+            }
+            case ShapeKind::PARALLELOGRAM: {
+                int slant = b.getWidth() / 5;
+                int xPoints[4] = { b.getX(), b.getRight() - slant, b.getRight(), b.getX() + slant };
+                int yPoints[4] = { b.getBottom(), b.getBottom(), b.getY(), b.getY() };
+                drawPolygon(painter, xPoints, yPoints, 4);
+                break;
+            }
+            case ShapeKind::RHOMBUS: {
+                int xPoints[4] = { b.getX(), b.getCenterX(), b.getRight(), b.getCenterX() };
+                int yPoints[4] = { b.getCenterY(), b.getY(), b.getCenterY(), b.getBottom() };
+                drawPolygon(painter, xPoints, yPoints, 4);
+                break;
+            }
+            case ShapeKind::TEXT:
+                break;
+            }
+
+            if (text_.index != 0) {
+                label_.draw(painter, text_, b, style_.label);
+            }
+        }
+
+    };
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "../Painting/StylePalette.h"
+#include <string>
+
+namespace Model {
+
+    // Palette handles for a shape's outline, fill and label, resolved once when
+    // the shape is constructed instead of on every draw.
+    struct ShapeStyle {
+        Painting::PenHandle pen;
+        Painting::BrushHandle brush;
+        Painting::TextStyleHandle label;
+
+        static ShapeStyle make(const std::string& color, const std::string& fillColor) {
+            auto& palette = Painting::StylePalette::getInstance();
+            Painting::Color stroke(color);
+            Painting::Color fill(fillColor);
+
+            Painting::Brush::Style brushStyle = fill.isNone()
+                ? Painting::Brush::Style::NONE
+                : Painting::Brush::Style::SOLID;
+
+            ShapeStyle style;
+            style.pen = palette.internPen(Painting::Pen(stroke, 2, Painting::Pen::Type::SOLID));
+            style.brush = palette.internBrush(Painting::Brush(fill, brushStyle));
+            style.label = palette.internTextStyle("Arial", 14, stroke);
+            return style;
+        }
+    };
+
+}
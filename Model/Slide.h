@@ -1,80 +1,768 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
 #include <iostream>
+#include "Arena.h"
+#include "GroupShape.h"
 #include "IShape.h"
+#include "MemoryStats.h"
+#include "PositionIndex.h"
+#include "ShapeGeometry.h"
+#include "ShapeGroups.h"
+#include "ShapeRecord.h"
+#include "Shapes.h"
+#include "SpatialIndex.h"
+#include "ZOrder.h"
 
 namespace Model {
 
-    class Slide {
-        std::vector<std::unique_ptr<IShape> > shapes_;
+    static_assert(kShapeKindCount <= kMaxShapeKinds, "MemoryStats counts too few shape kinds");
+
+    // Every slide gets a process-unique id, and a generation that every
+    // mutation bumps; together they tell whether a slide drawn earlier has
+    // changed since. Generations come from one counter, so an (id, generation)
+    // pair is never reused, even by an edit made after an undo. A copy keeps
+    // the id: it is the same slide in another version of the deck. clone()
+    // makes a new slide.
+    //
+    // Shapes are stored by value in the order they were added: the records in
+    // one array and their bounds in a ShapeGeometry alongside, index for
+    // index. A shape's index changes only when a shape before it is removed.
+    // The z-order is kept apart, in a ZOrder over the same indexes, so
+    // restacking a shape moves nothing in the arrays; drawing walks it from
+    // bottomShape() up through shapeAbove(). Callers that want the IShape
+    // interface get an adapter holding a copy of a record and its bounds.
+    // The arrays are allocated from the slide's arena, if it has one, which
+    // it keeps alive.
+    //
+    // The arrays are copy-on-write: a clone in the same arena shares them by
+    // reference count, and whichever slide is edited first copies them. So
+    // duplicating a slide, or keeping one for undo, costs the same however
+    // many shapes it has.
+    //
+    // Hit tests go through a spatial index kept with the arrays. Edits keep it
+    // current where that is cheap and otherwise mark it for rebuilding on the
+    // next pick() or select().
+    //
+    // Each shape has a 64-bit id that stays with it through reordering and
+    // undo: the slide's id in the high half and a serial number, unique
+    // within the slide, in the low half. Shapes in a clone therefore get new
+    // ids without their serials being copied, and a lookup by id is a hash
+    // probe, first for the slide and then for the serial.
+    //
+    // Shapes can be grouped, and groups nested, in a ShapeGroups table kept
+    // with the arrays. A group's shapes stay together in the z-order and
+    // restack, move, clone and disappear together; restacking a shape or
+    // group moves it among the other members of its own group. Each group
+    // caches its bounds, so drawShapes() with a viewport passes over a group
+    // that misses it in one test. Group ids come from the same serials as
+    // shape ids, and getGroup() and addShape() carry a group out of and into
+    // a slide as a GroupShape.
+    //
+    // Slides, their arrays and their indexes are counted in MemoryStats as
+    // they are made and freed; memoryUsage() reports one slide on its own.
+    class Slide : public CountedObject<Slide, MemoryCategory::SLIDES> {
+        struct Content {
+            std::pmr::vector<ShapeRecord> shapes;
+            ShapeGeometry geometry;
+            std::pmr::vector<std::uint32_t> serials;
+            std::uint32_t nextSerial;
+            ZOrder order;
+            ShapeGroups groups;
+            SpatialIndex index;
+            PositionIndex<std::uint32_t> positions;
+            // Shapes of each kind, reported to MemoryStats while the content
+            // lives
+            std::uint32_t kindCounts[kShapeKindCount];
+
+            explicit Content(const std::shared_ptr<Arena>& arena)
+                : shapes(Arena::resourceOf(arena, MemoryCategory::SHAPE_RECORDS)),
+                geometry(Arena::resourceOf(arena, MemoryCategory::SHAPE_GEOMETRY)),
+                serials(Arena::resourceOf(arena, MemoryCategory::SHAPE_IDS)), nextSerial(1),
+                order(Arena::resourceOf(arena, MemoryCategory::Z_ORDER)),
+                groups(Arena::resourceOf(arena, MemoryCategory::GROUPS)), kindCounts() {
+            }
+
+            Content(const Content& other, const std::shared_ptr<Arena>& arena)
+                : shapes(other.shapes, Arena::resourceOf(arena, MemoryCategory::SHAPE_RECORDS)),
+                geometry(Arena::resourceOf(arena, MemoryCategory::SHAPE_GEOMETRY)),
+                serials(other.serials, Arena::resourceOf(arena, MemoryCategory::SHAPE_IDS)),
+                nextSerial(other.nextSerial), order(other.order, Arena::resourceOf(arena, MemoryCategory::Z_ORDER)),
+                groups(other.groups, Arena::resourceOf(arena, MemoryCategory::GROUPS)),
+                positions(other.positions), kindCounts() {
+                geometry = other.geometry;
+                for (size_t kind = 0; kind < kShapeKindCount; ++kind) {
+                    counted(static_cast<ShapeKind>(kind), other.kindCounts[kind]);
+                }
+            }
+
+            Content(const Content&) = delete;
+            Content& operator=(const Content&) = delete;
+
+            ~Content() {
+                for (size_t kind = 0; kind < kShapeKindCount; ++kind) {
+                    counted(static_cast<ShapeKind>(kind), -static_cast<long long>(kindCounts[kind]));
+                }
+            }
+
+            void counted(ShapeKind kind, long long delta) {
+                if (delta != 0) {
+                    kindCounts[static_cast<size_t>(kind)] += static_cast<std::uint32_t>(delta);
+                    MemoryStats::getInstance().addShapes(static_cast<size_t>(kind), delta);
+                }
+            }
+        };
+
+        std::shared_ptr<Arena> arena_;
+        std::shared_ptr<Content> content_;
+        std::uint64_t id_;
+        std::uint64_t generation_;
+
+        static std::uint64_t nextId() {
+            static std::atomic<std::uint64_t> counter(0);
+            return ++counter;
+        }
+
+        static std::uint64_t nextGeneration() {
+            static std::atomic<std::uint64_t> counter(0);
+            return ++counter;
+        }
+
+        // New content in arena, empty or a copy of source
+        static std::shared_ptr<Content> makeContent(const std::shared_ptr<Arena>& arena, const Content* source) {
+            std::pmr::polymorphic_allocator<Content> allocator(Arena::resourceOf(arena, MemoryCategory::SLIDES));
+            return source
+                ? std::allocate_shared<Content>(allocator, *source, arena)
+                : std::allocate_shared<Content>(allocator, arena);
+        }
+
+        Slide(std::shared_ptr<Arena> arena, std::shared_ptr<Content> content)
+            : arena_(std::move(arena)), content_(std::move(content)), id_(nextId()), generation_(0) {
+        }
+
+        void touch() {
+            generation_ = nextGeneration();
+        }
+
+        static size_t fromOrder(std::uint32_t slot) {
+            return slot == ZOrder::kNone ? npos : slot;
+        }
+
+        static size_t fromGroups(std::uint32_t group) {
+            return group == ShapeGroups::kNone ? npos : group;
+        }
+
+        // A shape, or a group's shapes, as a run of the z-order within its
+        // parent group, kNone for the slide itself
+        struct Run {
+            std::uint32_t bottom;
+            std::uint32_t top;
+            std::uint32_t parent;
+        };
+
+        Run shapeRun(size_t index) const {
+            const std::uint32_t slot = static_cast<std::uint32_t>(index);
+            return Run{ slot, slot, content_->groups.groupOf(index) };
+        }
+
+        Run groupRun(size_t group) const {
+            const ShapeGroups::Group& entry = content_->groups[group];
+            return Run{ entry.bottom, entry.top, entry.parent };
+        }
+
+        // The run of the member of parent that holds slot's shape
+        Run memberRun(std::uint32_t parent, std::uint32_t slot) const {
+            std::uint32_t child = content_->groups.childOf(parent, slot);
+            return child == ShapeGroups::kNone ? Run{ slot, slot, parent } : groupRun(child);
+        }
+
+        enum class Move { TO_FRONT, TO_BACK, UP, DOWN };
+
+        // Moves a run among the other members of its parent, unless it is
+        // already as far as it can go that way. Shapes keep their indexes,
+        // so the spatial and id indexes stand. Without groups a shape moves
+        // in O(1); otherwise in O(shapes moved).
+        bool restack(const Run& run, Move move) {
+            const ShapeGroups& groups = content_->groups;
+            const ZOrder& current = content_->order;
+            const std::uint32_t bottom = run.parent == ShapeGroups::kNone ? current.bottom() : groups[run.parent].bottom;
+            const std::uint32_t top = run.parent == ShapeGroups::kNone ? current.top() : groups[run.parent].top;
+            const bool towardFront = move == Move::TO_FRONT || move == Move::UP;
+            if (towardFront ? run.top == top : run.bottom == bottom) {
+                return false;
+            }
+
+            std::uint32_t anchor = ZOrder::kNone;
+            switch (move) {
+            case Move::TO_FRONT: anchor = top; break;
+            case Move::TO_BACK: anchor = current.below(bottom); break;
+            case Move::UP: anchor = memberRun(run.parent, current.above(run.top)).top; break;
+            case Move::DOWN: anchor = current.below(memberRun(run.parent, current.below(run.bottom)).bottom); break;
+            }
+
+            Content& content = edit();
+            if (content.groups.empty()) {
+                switch (move) {
+                case Move::TO_FRONT: content.order.bringToFront(run.bottom); break;
+                case Move::TO_BACK: content.order.sendToBack(run.bottom); break;
+                case Move::UP: content.order.raise(run.bottom); break;
+                case Move::DOWN: content.order.lower(run.bottom); break;
+                }
+            }
+            else {
+                content.groups.moving(run.parent, run.bottom, run.top, anchor, content.order);
+                content.order.moveRun(run.bottom, run.top, anchor);
+            }
+            touch();
+            return true;
+        }
+
+        // Removes one shape from every array and index but the id table
+        static void eraseShape(Content& content, size_t index) {
+            content.counted(content.shapes[index].kind(), -1);
+            content.groups.erasing(index, content.order);
+            content.shapes.erase(content.shapes.begin() + index);
+            content.geometry.erase(index);
+            content.serials.erase(content.serials.begin() + index);
+            content.order.erase(index);
+            content.index.erased(index);
+        }
+
+        // The content, first made private to this slide if a clone shares it
+        Content& edit() {
+            if (content_.use_count() > 1) {
+                content_ = makeContent(arena_, content_.get());
+            }
+            return *content_;
+        }
 
     public:
-        explicit Slide() {
+        static const size_t npos = static_cast<size_t>(-1);
+
+        explicit Slide(std::shared_ptr<Arena> arena = nullptr)
+            : arena_(std::move(arena)), content_(makeContent(arena_, nullptr)), id_(nextId()), generation_(0) {
+        }
+
+        const std::shared_ptr<Arena>& arena() const { return arena_; }
+
+        std::uint64_t id() const { return id_; }
+        std::uint64_t generation() const { return generation_; }
+
+        // Returns the new shape's id, or 0 if there was no shape. A group
+        // is added with addGroup().
+        std::uint64_t addShape(std::unique_ptr<IShape> shape) {
+            if (!shape) {
+                return 0;
+            }
+            if (const GroupShape* group = shape->asGroup()) {
+                return addGroup(*group);
+            }
+            return addShape(shape->getBoundingBox(), shape->record());
+        }
+
+        std::uint64_t addShape(const BoundingBox& bounds, ShapeRecord shape) {
+            Content& content = edit();
+            const std::uint32_t serial = content.nextSerial++;
+            content.counted(shape.kind(), 1);
+            content.shapes.push_back(std::move(shape));
+            content.geometry.push_back(bounds);
+            content.serials.push_back(serial);
+            content.order.append();
+            content.groups.appended();
+            content.index.appended(content.shapes.size() - 1);
+            content.positions.appended(serial, content.shapes.size() - 1);
+            touch();
+            return shapeIdOf(id_, serial);
         }
 
-        void addShape(std::unique_ptr<IShape> shape) {
-            shapes_.push_back(std::move(shape));
+        // Sizes storage for a known number of shapes, when loading or copying
+        void reserveShapes(size_t count) {
+            Content& content = edit();
+            content.shapes.reserve(count);
+            content.geometry.reserve(count);
+            content.serials.reserve(count);
+            content.order.reserve(count);
         }
 
         void removeLastShape() {
-            if (!shapes_.empty()) {
-                shapes_.pop_back();
+            if (!content_->shapes.empty()) {
+                Content& content = edit();
+                content.counted(content.shapes.back().kind(), -1);
+                content.groups.erasing(content.shapes.size() - 1, content.order);
+                content.shapes.pop_back();
+                content.geometry.pop_back();
+                content.serials.pop_back();
+                content.order.erase(content.shapes.size());
+                content.index.erased(content.shapes.size());
+                touch();
             }
         }
 
         std::unique_ptr<IShape> removeShapeAt(size_t index) {
-            if (index >= shapes_.size()) {
+            if (index >= content_->shapes.size()) {
                 return nullptr;
             }
-            auto shape = std::move(shapes_[index]);
-            shapes_.erase(shapes_.begin() + index);
+            auto shape = getShape(index);
+            Content& content = edit();
+            eraseShape(content, index);
+            content.positions.invalidate();
+            touch();
             return shape;
         }
 
+        // Grouped shapes follow a GROUP line, indented one step further
         std::string serialize() const {
             std::string result = "SLIDE";
-            for (size_t i = 0; i < shapes_.size(); ++i) {
-                result += "\n  " + shapes_[i]->serialize();
+            for (size_t i = bottomShape(); i != npos; i = shapeAbove(i)) {
+                const size_t depth = groupDepth(i);
+                forGroupsStartingAt(i, [this, &result](size_t group, size_t outer) {
+                    result += "\n  " + std::string(2 * outer, ' ') + "GROUP " + groupBounds(group).serialize();
+                });
+                result += "\n  " + std::string(2 * depth, ' ') +
+                    content_->shapes[i].serialize(content_->geometry.bounds(i));
             }
             return result;
         }
-        size_t shapeCount() const { return shapes_.size(); }
+        size_t shapeCount() const { return content_->shapes.size(); }
+
+        // The array space one shape takes: its record, bounds, serial and
+        // place in the z-order
+        static size_t bytesPerShape() {
+            return sizeof(ShapeRecord) + 4 * sizeof(int) + sizeof(std::uint32_t) +
+                sizeof(std::uint64_t) + 2 * sizeof(std::uint32_t);
+        }
+
+        // Bytes this slide holds, counting in full the arrays it shares with
+        // clones or other versions until one of them is edited
+        size_t memoryUsage() const {
+            const Content& content = *content_;
+            return sizeof(Slide) + sizeof(Content) +
+                content.shapes.capacity() * sizeof(ShapeRecord) + content.geometry.memoryUsage() +
+                content.serials.capacity() * sizeof(std::uint32_t) + content.order.memoryUsage() +
+                content.groups.memoryUsage() + content.index.memoryUsage() + content.positions.memoryUsage();
+        }
+
+        static std::uint64_t shapeIdOf(std::uint64_t slideId, std::uint32_t serial) {
+            return (slideId << 32) | serial;
+        }
+
+        // The id of the slide a shape id belongs to
+        static std::uint64_t slideIdOf(std::uint64_t shapeId) {
+            return shapeId >> 32;
+        }
+
+        std::uint64_t shapeId(size_t index) const {
+            return shapeIdOf(id_, content_->serials[index]);
+        }
+
+        // The position of the shape with this id, or npos
+        size_t findShape(std::uint64_t shapeId) const {
+            if (slideIdOf(shapeId) != id_) {
+                return npos;
+            }
+            const Content& content = *content_;
+            const std::uint32_t serial = static_cast<std::uint32_t>(shapeId);
+            size_t index = content.positions.find(serial, content.serials.size(), [&content](const auto& add) {
+                for (std::uint32_t each : content.serials) add(each);
+            });
+            // Removing the last shape leaves its entry behind
+            if (index >= content.serials.size() || content.serials[index] != serial) {
+                return npos;
+            }
+            return index;
+        }
+
+        // In the order they were added; see bottomShape() for z-order
+        const std::pmr::vector<ShapeRecord>& getShapes() const {
+            return content_->shapes;
+        }
+
+        const ShapeGeometry& geometry() const {
+            return content_->geometry;
+        }
+
+        BoundingBox shapeBounds(size_t index) const {
+            return content_->geometry.bounds(index);
+        }
+
+        std::unique_ptr<IShape> getShape(size_t index) const {
+            if (index >= content_->shapes.size()) {
+                return nullptr;
+            }
+            return makeShape(content_->geometry.bounds(index), content_->shapes[index]);
+        }
+
+        // The z-order, back to front: from bottomShape() follow shapeAbove()
+        // until npos. Neither allocates.
+        size_t bottomShape() const { return fromOrder(content_->order.bottom()); }
+        size_t topShape() const { return fromOrder(content_->order.top()); }
+        size_t shapeAbove(size_t index) const { return fromOrder(content_->order.above(index)); }
+        size_t shapeBelow(size_t index) const { return fromOrder(content_->order.below(index)); }
+
+        // Whether shape a is drawn over shape b
+        bool inFront(size_t a, size_t b) const {
+            return content_->order.inFront(a, b);
+        }
+
+        // How many shapes are drawn before this one; O(n)
+        size_t zPosition(size_t index) const {
+            return content_->order.depth(index);
+        }
 
-        const std::vector<std::unique_ptr<IShape> >& getShapes() const {
-            return shapes_;
+        // The topmost shape whose bounds contain (x, y), edges included, or
+        // npos if there is none
+        size_t pick(int x, int y) const {
+            const ZOrder& order = content_->order;
+            std::uint32_t index = content_->index.pick(content_->geometry, x, y,
+                [&order](std::uint32_t a, std::uint32_t b) { return order.inFront(a, b); });
+            return index == SpatialIndex::kNone ? npos : index;
         }
 
-        std::vector<IShape*> getShapesByZOrder() const {
-            std::vector<IShape*> result;
-            result.reserve(shapes_.size());
-            for (const auto& shape : shapes_) {
-                if (shape) {
-                    result.push_back(shape.get());
+        // Shapes whose bounds overlap region, edges touching included, or with
+        // inside set only those wholly within it; back to front
+        std::vector<size_t> select(const BoundingBox& region, bool inside = false) const {
+            std::vector<std::uint32_t> found = content_->index.select(content_->geometry, region, inside);
+            const ZOrder& order = content_->order;
+            std::sort(found.begin(), found.end(),
+                [&order](std::uint32_t a, std::uint32_t b) { return order.inFront(b, a); });
+            return std::vector<size_t>(found.begin(), found.end());
+        }
+
+        void drawShapes(Painting::IPainter& painter) const {
+            const Content& content = *content_;
+            for (std::uint32_t i = content.order.bottom(); i != ZOrder::kNone; i = content.order.above(i)) {
+                content.shapes[i].draw(painter, content.geometry.bounds(i));
+            }
+        }
+
+        // Draws what may show in viewport, given in slide coordinates: a
+        // group whose bounds miss it is passed over with one test however
+        // many shapes it holds. Shapes outside any group are all drawn.
+        void drawShapes(Painting::IPainter& painter, const BoundingBox& viewport) const {
+            const Content& content = *content_;
+            if (content.groups.empty()) {
+                drawShapes(painter);
+                return;
+            }
+            content.groups.refresh(content.geometry, content.order);
+            for (std::uint32_t i = content.order.bottom(); i != ZOrder::kNone; i = content.order.above(i)) {
+                std::uint32_t culled = content.groups.culled(i, viewport);
+                if (culled != ShapeGroups::kNone) {
+                    i = content.groups[culled].top;
+                    continue;
+                }
+                content.shapes[i].draw(painter, content.geometry.bounds(i));
+            }
+        }
+
+        // Restacking, among the other members of the shape's group if it is
+        // in one: each returns false, changing nothing, if the shape is
+        // already as far as it can go or there is no such shape
+        bool bringToFront(size_t index) {
+            return index < content_->shapes.size() && restack(shapeRun(index), Move::TO_FRONT);
+        }
+
+        bool sendToBack(size_t index) {
+            return index < content_->shapes.size() && restack(shapeRun(index), Move::TO_BACK);
+        }
+
+        // One step toward the front, over the shape or group just above it
+        bool raise(size_t index) {
+            return index < content_->shapes.size() && restack(shapeRun(index), Move::UP);
+        }
+
+        bool lower(size_t index) {
+            return index < content_->shapes.size() && restack(shapeRun(index), Move::DOWN);
+        }
+
+        void translateShape(size_t index, int dx, int dy) {
+            if (index < content_->shapes.size()) {
+                Content& content = edit();
+                content.geometry.translateAt(index, dx, dy);
+                content.groups.touched(index);
+                content.index.invalidate();
+                touch();
+            }
+        }
+
+        // Bulk geometry edits; mask selects shapes, nullptr means all of them
+        void translateShapes(int dx, int dy, const std::uint8_t* mask = nullptr) {
+            Content& content = edit();
+            content.geometry.translate(dx, dy, mask);
+            content.groups.touched(mask);
+            content.index.invalidate();
+            touch();
+        }
+
+        void scaleShapes(double factorX, double factorY, int originX, int originY, const std::uint8_t* mask = nullptr) {
+            Content& content = edit();
+            content.geometry.scale(factorX, factorY, originX, originY, mask);
+            content.groups.touched(mask);
+            content.index.invalidate();
+            touch();
+        }
+
+        // Replaces every shape's bounds at once, as when undoing a bulk edit;
+        // the shape count must not change
+        void swapGeometry(ShapeGeometry& geometry) {
+            if (geometry.size() != content_->shapes.size()) {
+                throw std::invalid_argument("Geometry does not match the slide's shapes");
+            }
+            Content& content = edit();
+            content.geometry.swap(geometry);
+            content.groups.touched(nullptr);
+            content.index.invalidate();
+            touch();
+        }
+
+        // Groups are numbered in the order they were made; removing one
+        // renumbers those after it, so edits name them by id
+        size_t groupCount() const { return content_->groups.size(); }
+
+        std::uint64_t groupId(size_t group) const {
+            return shapeIdOf(id_, content_->groups[group].serial);
+        }
+
+        // The group with this id, or npos; O(groups)
+        size_t findGroup(std::uint64_t groupId) const {
+            if (slideIdOf(groupId) != id_) {
+                return npos;
+            }
+            return fromGroups(content_->groups.find(static_cast<std::uint32_t>(groupId)));
+        }
+
+        // The innermost group holding the shape, or npos
+        size_t groupOf(size_t index) const {
+            return fromGroups(content_->groups.groupOf(index));
+        }
+
+        size_t parentGroup(size_t group) const {
+            return fromGroups(content_->groups[group].parent);
+        }
+
+        // The group directly under parent, npos for the slide itself, that
+        // holds the shape; npos if the shape is directly under parent
+        size_t childGroup(size_t parent, size_t index) const {
+            return fromGroups(content_->groups.childOf(static_cast<std::uint32_t>(parent), index));
+        }
+
+        // How many groups hold the shape
+        size_t groupDepth(size_t index) const {
+            size_t depth = 0;
+            for (size_t group = groupOf(index); group != npos; group = parentGroup(group)) ++depth;
+            return depth;
+        }
+
+        // Calls visit(group, outer) for each group whose shapes start, in the
+        // z-order, at this shape, outermost first; outer counts the groups
+        // around it. A walk of the z-order meets each group once this way.
+        template <typename Visit>
+        void forGroupsStartingAt(size_t index, const Visit& visit) const {
+            const ShapeGroups& groups = content_->groups;
+            std::vector<std::uint32_t> starting;
+            for (std::uint32_t group = groups.groupOf(index); group != ShapeGroups::kNone && groups[group].bottom == index;
+                group = groups[group].parent) {
+                starting.push_back(group);
+            }
+            const size_t outer = starting.empty() ? 0 : groupDepth(index) - starting.size();
+            for (size_t i = starting.size(); i-- > 0;) {
+                visit(static_cast<size_t>(starting[i]), outer + starting.size() - 1 - i);
+            }
+        }
+
+        // Shapes under the group, nested ones included
+        size_t groupSize(size_t group) const { return content_->groups[group].size; }
+
+        // The group's shapes are the run of the z-order from its bottom
+        // shape up to its top shape
+        size_t groupBottom(size_t group) const { return content_->groups[group].bottom; }
+        size_t groupTop(size_t group) const { return content_->groups[group].top; }
+
+        // The union of the group's shapes' bounds, recomputed only if a
+        // shape under it has changed since last asked
+        BoundingBox groupBounds(size_t group) const {
+            const Content& content = *content_;
+            content.groups.refresh(content.geometry, content.order);
+            return content.groups.bounds(group).toBounds();
+        }
+
+        // Groups the shapes and groups with these ids, which must be distinct,
+        // on this slide and members of the same group, or of none. The new
+        // group takes their place in it: the others move down in the z-order
+        // to close ranks under the topmost, keeping their order. Returns the
+        // group's id, or 0 if the ids do not make a group.
+        std::uint64_t groupShapes(const std::vector<std::uint64_t>& ids) {
+            std::vector<size_t> shapes, groups;
+            std::vector<Run> runs;
+            for (std::uint64_t id : ids) {
+                size_t index = findShape(id);
+                if (index != npos) {
+                    shapes.push_back(index);
+                    runs.push_back(shapeRun(index));
+                    continue;
+                }
+                size_t group = findGroup(id);
+                if (group == npos) {
+                    return 0;
+                }
+                groups.push_back(group);
+                runs.push_back(groupRun(group));
+            }
+            std::sort(shapes.begin(), shapes.end());
+            std::sort(groups.begin(), groups.end());
+            if (runs.empty() || std::adjacent_find(shapes.begin(), shapes.end()) != shapes.end() ||
+                std::adjacent_find(groups.begin(), groups.end()) != groups.end()) {
+                return 0;
+            }
+            for (const Run& run : runs) {
+                if (run.parent != runs.front().parent) return 0;
+            }
+
+            Content& content = edit();
+            ZOrder& order = content.order;
+            std::sort(runs.begin(), runs.end(), [&order](const Run& a, const Run& b) { return order.inFront(a.top, b.top); });
+            std::uint32_t bottom = runs.front().bottom;
+            for (size_t i = 1; i < runs.size(); ++i) {
+                const Run& run = runs[i];
+                const std::uint32_t anchor = order.below(bottom);
+                if (anchor != run.top) {
+                    content.groups.moving(run.parent, run.bottom, run.top, anchor, order);
+                    order.moveRun(run.bottom, run.top, anchor);
+                }
+                bottom = run.bottom;
+            }
+            const std::uint32_t serial = content.nextSerial++;
+            content.groups.create(serial, runs.front().parent, bottom, runs.front().top, shapes, groups,
+                content.shapes.size());
+            touch();
+            return shapeIdOf(id_, serial);
+        }
+
+        // Adds the group's shapes on top, grouped and nested as in it;
+        // returns the new group's id, or 0 if it holds no shapes
+        std::uint64_t addGroup(const GroupShape& group) {
+            std::vector<std::uint64_t> ids;
+            ids.reserve(group.childCount());
+            for (size_t i = 0; i < group.childCount(); ++i) {
+                const IShape& child = group.child(i);
+                const GroupShape* inner = child.asGroup();
+                std::uint64_t id = inner ? addGroup(*inner) : addShape(child.getBoundingBox(), child.record());
+                if (id != 0) ids.push_back(id);
+            }
+            return ids.empty() ? 0 : groupShapes(ids);
+        }
+
+        // A copy of the group's shapes, nested as they are, back to front
+        std::unique_ptr<GroupShape> getGroup(size_t group) const {
+            if (group >= content_->groups.size()) {
+                return nullptr;
+            }
+            auto result = std::make_unique<GroupShape>();
+            const ShapeGroups& groups = content_->groups;
+            const ShapeGroups::Group& entry = groups[group];
+            const std::uint32_t parent = static_cast<std::uint32_t>(group);
+            for (std::uint32_t slot = entry.bottom; ; slot = content_->order.above(slot)) {
+                std::uint32_t child = groups.childOf(parent, slot);
+                if (child == ShapeGroups::kNone) {
+                    result->add(getShape(slot));
+                }
+                else {
+                    result->add(getGroup(child));
+                    slot = groups[child].top;
                 }
+                if (slot == entry.top) break;
             }
             return result;
         }
 
-        void bringToFront(size_t index) {
-            if (index < shapes_.size()) {
-                auto shape = std::move(shapes_[index]);
-                shapes_.erase(shapes_.begin() + index);
-                shapes_.push_back(std::move(shape));
+        // Members go to the group's parent, keeping their places
+        bool ungroup(size_t group) {
+            if (group >= content_->groups.size()) {
+                return false;
             }
+            edit().groups.dissolve(static_cast<std::uint32_t>(group));
+            touch();
+            return true;
         }
 
+        // Moves the group's shapes; the cached bounds of it and the groups
+        // within it move along, and only the groups around it are recomputed
+        void translateGroup(size_t group, int dx, int dy) {
+            if (group >= content_->groups.size()) {
+                return;
+            }
+            Content& content = edit();
+            const ShapeGroups::Group& entry = content.groups[group];
+            for (std::uint32_t slot = entry.bottom; ; slot = content.order.above(slot)) {
+                content.geometry.translateAt(slot, dx, dy);
+                if (slot == entry.top) break;
+            }
+            content.groups.shifted(static_cast<std::uint32_t>(group), dx, dy);
+            content.index.invalidate();
+            touch();
+        }
+
+        // Removes the group with every shape under it; O(shapes in the group
+        // x shapes on the slide)
+        std::unique_ptr<GroupShape> removeGroup(size_t group) {
+            std::unique_ptr<GroupShape> removed = getGroup(group);
+            if (!removed) {
+                return nullptr;
+            }
+            Content& content = edit();
+            std::vector<std::uint32_t> slots;
+            const ShapeGroups::Group& entry = content.groups[group];
+            for (std::uint32_t slot = entry.bottom; ; slot = content.order.above(slot)) {
+                slots.push_back(slot);
+                if (slot == entry.top) break;
+            }
+            std::sort(slots.begin(), slots.end());
+            for (auto it = slots.rbegin(); it != slots.rend(); ++it) {
+                eraseShape(content, *it);
+            }
+            content.positions.invalidate();
+            touch();
+            return removed;
+        }
+
+        // Restacking a group among the other members of its parent, as for
+        // shapes
+        bool bringGroupToFront(size_t group) {
+            return group < content_->groups.size() && restack(groupRun(group), Move::TO_FRONT);
+        }
+
+        bool sendGroupToBack(size_t group) {
+            return group < content_->groups.size() && restack(groupRun(group), Move::TO_BACK);
+        }
+
+        bool raiseGroup(size_t group) {
+            return group < content_->groups.size() && restack(groupRun(group), Move::UP);
+        }
+
+        bool lowerGroup(size_t group) {
+            return group < content_->groups.size() && restack(groupRun(group), Move::DOWN);
+        }
+
+        // A new slide, with its own id, sharing this one's shapes until
+        // either is edited
         std::unique_ptr<Slide> clone() const {
-            auto cloned = std::make_unique<Slide>();
-            for (const auto& shape : shapes_) {
-                if (shape) {
-                    cloned->addShape(shape->clone());
-                }
+            return std::unique_ptr<Slide>(new Slide(arena_, content_));
+        }
+
+        // A copy allocating from another arena, as when copying into a new
+        // deck; shapes are copied unless the arena is this slide's own
+        std::unique_ptr<Slide> clone(const std::shared_ptr<Arena>& arena) const {
+            if (arena == arena_) {
+                return clone();
             }
-            return cloned;
+            return std::unique_ptr<Slide>(new Slide(arena, makeContent(arena, content_.get())));
         }
     };
 
 }
-
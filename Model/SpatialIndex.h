@@ -0,0 +1,272 @@
+#pragma once
+#include "BoundingBox.h"
+#include "MemoryStats.h"
+#include "ShapeGeometry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Model {
+
+    // A packed R-tree over one slide's shape bounds, answering which shapes
+    // lie under a point or overlap a rectangle in logarithmic time. Entries
+    // are the shapes' slots in the slide's arrays, which changes of z-order
+    // leave alone; the slide reports the changes that do move them:
+    //   - appended shapes go to a short list that queries scan, until it
+    //     grows past a fraction of the tree;
+    //   - a removal renumbers the leaves in one pass and leaves a tombstone
+    //     in place;
+    //   - edits that move shapes mark the tree stale.
+    // The tree is (re)built on the next query when stale or when too much has
+    // piled up, by sorting the boxes into tiles (STR bulk loading).
+    //
+    // Queries may run on several threads at once; the lazy rebuild is
+    // serialized. Updates come only from the thread editing the slide.
+    class SpatialIndex {
+    public:
+        static const std::uint32_t kNone = 0xFFFFFFFFu;
+
+    private:
+        static const size_t kFanout = 16;
+
+        struct Box {
+            int left, top, right, bottom;
+
+            bool contains(int x, int y) const {
+                return left <= x && x <= right && top <= y && y <= bottom;
+            }
+
+            bool overlaps(const Box& other) const {
+                return left <= other.right && other.left <= right && top <= other.bottom && other.top <= bottom;
+            }
+
+            bool inside(const Box& other) const {
+                return other.left <= left && right <= other.right && other.top <= top && bottom <= other.bottom;
+            }
+        };
+
+        // Level 0 holds one box per leaf entry, each level above the union of
+        // up to kFanout consecutive boxes of the level below; levelStart_
+        // indexes the levels in boxes_, root last
+        mutable std::vector<Box> boxes_;
+        mutable std::vector<std::uint32_t> entries_;
+        mutable std::vector<size_t> levelStart_;
+        mutable std::vector<std::uint32_t> pending_;
+        // Highest slot held by a leaf; changes above it touch only
+        // pending_
+        mutable std::uint32_t treeTop_;
+        mutable size_t removed_;
+        mutable bool built_;
+        mutable bool stale_;
+        mutable std::mutex mutex_;
+        mutable TrackedBytes tracked_;
+
+        // Reports the arrays' size to MemoryStats after they change
+        void track() const {
+            tracked_.set(static_cast<long long>(boxes_.capacity() * sizeof(Box) +
+                (entries_.capacity() + pending_.capacity()) * sizeof(std::uint32_t) +
+                levelStart_.capacity() * sizeof(size_t)));
+        }
+
+        static Box boxOf(const ShapeGeometry& geometry, size_t index) {
+            int x = geometry.xs()[index], y = geometry.ys()[index];
+            int right = x + geometry.widths()[index], bottom = y + geometry.heights()[index];
+            return Box{ std::min(x, right), std::min(y, bottom), std::max(x, right), std::max(y, bottom) };
+        }
+
+        static Box unite(const Box& a, const Box& b) {
+            return Box{ std::min(a.left, b.left), std::min(a.top, b.top),
+                std::max(a.right, b.right), std::max(a.bottom, b.bottom) };
+        }
+
+        void build(const ShapeGeometry& geometry) const {
+            const size_t count = geometry.size();
+            std::vector<std::uint32_t> order(count);
+            for (size_t i = 0; i < count; ++i) order[i] = static_cast<std::uint32_t>(i);
+
+            // Sort-tile-recursive: vertical slices by center x, then each
+            // slice by center y, so every run of kFanout entries is compact
+            auto centerX = [&](std::uint32_t i) { return 2LL * geometry.xs()[i] + geometry.widths()[i]; };
+            auto centerY = [&](std::uint32_t i) { return 2LL * geometry.ys()[i] + geometry.heights()[i]; };
+            std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) { return centerX(a) < centerX(b); });
+            size_t leaves = (count + kFanout - 1) / kFanout;
+            size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(leaves))));
+            size_t perSlice = slices > 0 ? ((leaves + slices - 1) / slices) * kFanout : count;
+            for (size_t start = 0; start < count; start += perSlice) {
+                auto first = order.begin() + start;
+                auto last = order.begin() + std::min(count, start + perSlice);
+                std::sort(first, last, [&](std::uint32_t a, std::uint32_t b) { return centerY(a) < centerY(b); });
+            }
+
+            boxes_.clear();
+            levelStart_.clear();
+            boxes_.reserve(count + count / (kFanout - 1) + 1);
+            entries_ = order;
+            levelStart_.push_back(0);
+            for (std::uint32_t i : order) {
+                boxes_.push_back(boxOf(geometry, i));
+            }
+
+            size_t levelBegin = 0, levelSize = count;
+            while (levelSize > 1) {
+                size_t next = boxes_.size();
+                for (size_t i = 0; i < levelSize; i += kFanout) {
+                    Box box = boxes_[levelBegin + i];
+                    size_t end = std::min(levelSize, i + kFanout);
+                    for (size_t j = i + 1; j < end; ++j) box = unite(box, boxes_[levelBegin + j]);
+                    boxes_.push_back(box);
+                }
+                levelStart_.push_back(next);
+                levelBegin = next;
+                levelSize = boxes_.size() - next;
+            }
+
+            pending_.clear();
+            treeTop_ = count > 0 ? static_cast<std::uint32_t>(count - 1) : 0;
+            removed_ = 0;
+            built_ = true;
+            stale_ = false;
+            track();
+        }
+
+        // Rebuilds when the tree is stale or its side lists have grown
+        void prepare(const ShapeGeometry& geometry) const {
+            size_t size = entries_.size();
+            if (stale_ || !built_ || pending_.size() > 32 + size / 8 || removed_ > size / 4) {
+                build(geometry);
+            }
+        }
+
+        size_t levelSize(size_t level) const {
+            size_t end = level + 1 < levelStart_.size() ? levelStart_[level + 1] : boxes_.size();
+            return end - levelStart_[level];
+        }
+
+        // Calls visit for every live leaf entry whose box, and every box
+        // above it, passes descend
+        template <typename Descend, typename Visit>
+        void search(const Descend& descend, const Visit& visit) const {
+            if (entries_.empty()) return;
+
+            // Each level leaves at most kFanout - 1 siblings on the stack, and
+            // 32-bit positions need at most 8 levels
+            struct Frame { size_t level, index; };
+            Frame stack[8 * kFanout + 1];
+            size_t depth = 0;
+            size_t top = levelStart_.size() - 1;
+            stack[depth++] = Frame{ top, 0 };
+            while (depth > 0) {
+                Frame frame = stack[--depth];
+                const Box& box = boxes_[levelStart_[frame.level] + frame.index];
+                if (!descend(box)) continue;
+                if (frame.level == 0) {
+                    std::uint32_t entry = entries_[frame.index];
+                    if (entry != kNone) visit(entry);
+                    continue;
+                }
+                size_t first = frame.index * kFanout;
+                size_t last = std::min(levelSize(frame.level - 1), first + kFanout);
+                for (size_t child = first; child < last; ++child) {
+                    stack[depth++] = Frame{ frame.level - 1, child };
+                }
+            }
+        }
+
+    public:
+        SpatialIndex()
+            : treeTop_(0), removed_(0), built_(false), stale_(true), tracked_(MemoryCategory::INDEXES) {
+        }
+
+        // A copy starts unbuilt and indexes the copied geometry when first
+        // queried
+        SpatialIndex(const SpatialIndex&)
+            : treeTop_(0), removed_(0), built_(false), stale_(true), tracked_(MemoryCategory::INDEXES) {
+        }
+
+        SpatialIndex& operator=(const SpatialIndex&) {
+            invalidate();
+            return *this;
+        }
+
+        // Shapes moved or were replaced; rebuild on the next query
+        void invalidate() {
+            stale_ = true;
+        }
+
+        // A shape was added on top, at position index
+        void appended(size_t index) {
+            if (built_ && !stale_) {
+                pending_.push_back(static_cast<std::uint32_t>(index));
+                track();
+            }
+        }
+
+        // The shape at index was removed and those above it moved down
+        void erased(size_t index) {
+            if (!built_ || stale_) return;
+            const std::uint32_t removed = static_cast<std::uint32_t>(index);
+            if (removed <= treeTop_ && !entries_.empty()) {
+                for (std::uint32_t& entry : entries_) {
+                    if (entry == removed) {
+                        entry = kNone;
+                        ++removed_;
+                    }
+                    else if (entry != kNone && entry > removed) {
+                        --entry;
+                    }
+                }
+                if (treeTop_ > 0) --treeTop_;
+            }
+            pending_.erase(std::remove(pending_.begin(), pending_.end(), removed), pending_.end());
+            for (std::uint32_t& entry : pending_) {
+                if (entry > removed) --entry;
+            }
+        }
+
+        // Bytes held by the tree
+        size_t memoryUsage() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return static_cast<size_t>(tracked_.get());
+        }
+
+        // Of the shapes whose bounds contain (x, y), edges included, the one
+        // for which inFront(it, other) holds against every other; kNone if
+        // there are none
+        template <typename InFront>
+        std::uint32_t pick(const ShapeGeometry& geometry, int x, int y, const InFront& inFront) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            prepare(geometry);
+
+            std::uint32_t best = kNone;
+            auto consider = [&](std::uint32_t entry) {
+                if (best == kNone || inFront(entry, best)) best = entry;
+            };
+            search([&](const Box& box) { return box.contains(x, y); }, consider);
+            for (std::uint32_t entry : pending_) {
+                if (boxOf(geometry, entry).contains(x, y)) consider(entry);
+            }
+            return best;
+        }
+
+        // Slots of the shapes overlapping region, or only those wholly inside
+        // it, in no particular order
+        std::vector<std::uint32_t> select(const ShapeGeometry& geometry, const BoundingBox& region, bool inside) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            prepare(geometry);
+
+            const Box area{ std::min(region.getX(), region.getRight()), std::min(region.getY(), region.getBottom()),
+                std::max(region.getX(), region.getRight()), std::max(region.getY(), region.getBottom()) };
+            std::vector<std::uint32_t> found;
+            auto accept = [&](std::uint32_t entry) {
+                Box box = boxOf(geometry, entry);
+                if (inside ? box.inside(area) : box.overlaps(area)) found.push_back(entry);
+            };
+            search([&](const Box& box) { return box.overlaps(area); }, accept);
+            for (std::uint32_t entry : pending_) accept(entry);
+            return found;
+        }
+    };
+
+}
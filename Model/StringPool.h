@@ -0,0 +1,77 @@
+#pragma once
+#include "../Painting/StylePalette.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Model {
+
+    // Handle to a string in the StringPool; index 0 is the empty string
+    struct StringHandle {
+        std::uint32_t index;
+    };
+
+    inline bool operator==(StringHandle a, StringHandle b) { return a.index == b.index; }
+    inline bool operator!=(StringHandle a, StringHandle b) { return a.index != b.index; }
+
+    // Process-wide table of the colors and texts shapes carry. A deck has a
+    // few dozen colors and a handful of repeated labels across any number of
+    // shapes, so each is stored once and shapes hold 32-bit handles; copying
+    // a shape copies no characters. Like the StylePalette, interning takes a
+    // lock and lookups do not, and strings never move once added, so the
+    // references get() returns stay valid for the life of the program.
+    class StringPool {
+    private:
+        Painting::StableTable<std::string> strings_;
+
+        // Keys view the pooled strings themselves
+        std::unordered_map<std::string_view, std::uint32_t> index_;
+        std::atomic<size_t> bytes_;
+        std::mutex mutex_;
+
+        StringPool() : bytes_(0) {
+            strings_.push_back(std::string());
+            index_.emplace(std::string_view(strings_[0]), 0);
+        }
+
+        StringPool(const StringPool&) = delete;
+        StringPool& operator=(const StringPool&) = delete;
+
+    public:
+        static StringPool& getInstance() {
+            static StringPool instance;
+            return instance;
+        }
+
+        StringHandle intern(const std::string& value) {
+            if (value.empty()) return StringHandle{ 0 };
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto found = index_.find(std::string_view(value));
+            if (found != index_.end()) {
+                return StringHandle{ found->second };
+            }
+
+            std::uint32_t index = static_cast<std::uint32_t>(strings_.size());
+            strings_.push_back(value);
+            const std::string& stored = strings_[index];
+            index_.emplace(std::string_view(stored), index);
+            bytes_.fetch_add(sizeof(std::string) + stored.size() + 1, std::memory_order_relaxed);
+            return StringHandle{ index };
+        }
+
+        const std::string& get(StringHandle handle) const {
+            return strings_[handle.index];
+        }
+
+        // Distinct strings held, the empty string included
+        size_t size() const { return strings_.size(); }
+
+        // Approximate memory held by the pooled strings, excluding the index
+        size_t byteCount() const { return bytes_.load(std::memory_order_relaxed); }
+    };
+
+}
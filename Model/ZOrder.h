@@ -0,0 +1,255 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace Model {
+
+    // The stacking order of a slide's shapes, kept apart from where they are
+    // stored. Shapes are named by slot, their index in the slide's arrays;
+    // slots are linked back to front, and each carries an order key that
+    // grows toward the front, so:
+    //   - walking the order follows the links and allocates nothing;
+    //   - which of two shapes is in front is one key comparison;
+    //   - moving a shape to either end, or one step past a neighbour, relinks
+    //     it and takes one new key, or swaps two, in O(1);
+    //   - a run of linked slots, such as a group's shapes, moves as a whole
+    //     by relinking its ends, taking a key per slot.
+    // Keys at the ends are spaced kGap apart. When the key space runs out at
+    // one end every key is reassigned in one pass, which over the 2^31 moves
+    // it takes to get there costs O(1) a move.
+    class ZOrder {
+    public:
+        static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+
+    private:
+        static const std::uint64_t kGap = 1ull << 32;
+        static const std::uint64_t kMiddle = 1ull << 63;
+
+        std::pmr::vector<std::uint64_t> keys_;
+        // The next slot toward the front, and toward the back
+        std::pmr::vector<std::uint32_t> above_;
+        std::pmr::vector<std::uint32_t> below_;
+        std::uint32_t bottom_;
+        std::uint32_t top_;
+
+        void unlink(std::uint32_t slot) {
+            std::uint32_t above = above_[slot], below = below_[slot];
+            if (below != kNone) above_[below] = above;
+            else bottom_ = above;
+            if (above != kNone) below_[above] = below;
+            else top_ = below;
+        }
+
+        // Links slot in just above anchor, or at the bottom if anchor is kNone
+        void linkAbove(std::uint32_t slot, std::uint32_t anchor) {
+            std::uint32_t above = anchor == kNone ? bottom_ : above_[anchor];
+            below_[slot] = anchor;
+            above_[slot] = above;
+            if (anchor != kNone) above_[anchor] = slot;
+            else bottom_ = slot;
+            if (above != kNone) below_[above] = slot;
+            else top_ = slot;
+        }
+
+        // Spaces the keys evenly about the middle of the key space, in order
+        void relabel() {
+            std::uint64_t key = kMiddle - static_cast<std::uint64_t>(keys_.size() / 2) * kGap;
+            for (std::uint32_t slot = bottom_; slot != kNone; slot = above_[slot]) {
+                keys_[slot] = key;
+                key += kGap;
+            }
+        }
+
+        std::uint64_t keyAboveTop() {
+            if (top_ == kNone) return kMiddle;
+            if (keys_[top_] > ~0ull - kGap) relabel();
+            return keys_[top_] + kGap;
+        }
+
+        std::uint64_t keyBelowBottom() {
+            if (bottom_ == kNone) return kMiddle;
+            if (keys_[bottom_] < kGap) relabel();
+            return keys_[bottom_] - kGap;
+        }
+
+    public:
+        explicit ZOrder(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : keys_(resource), above_(resource), below_(resource), bottom_(kNone), top_(kNone) {
+        }
+
+        ZOrder(const ZOrder& other, std::pmr::memory_resource* resource)
+            : keys_(other.keys_, resource), above_(other.above_, resource), below_(other.below_, resource),
+            bottom_(other.bottom_), top_(other.top_) {
+        }
+
+        size_t size() const { return keys_.size(); }
+
+        void reserve(size_t count) {
+            keys_.reserve(count);
+            above_.reserve(count);
+            below_.reserve(count);
+        }
+
+        // Bytes held by the arrays
+        size_t memoryUsage() const {
+            return keys_.capacity() * sizeof(std::uint64_t) +
+                (above_.capacity() + below_.capacity()) * sizeof(std::uint32_t);
+        }
+
+        std::uint32_t bottom() const { return bottom_; }
+        std::uint32_t top() const { return top_; }
+        std::uint32_t above(size_t slot) const { return above_[slot]; }
+        std::uint32_t below(size_t slot) const { return below_[slot]; }
+
+        // Whether slot a is drawn in front of slot b
+        bool inFront(size_t a, size_t b) const {
+            return keys_[a] > keys_[b];
+        }
+
+        // How many shapes are behind slot; O(n)
+        size_t depth(size_t slot) const {
+            const std::uint64_t key = keys_[slot];
+            const std::uint64_t* keys = keys_.data();
+            size_t behind = 0;
+            for (size_t i = 0; i < keys_.size(); ++i) behind += keys[i] < key;
+            return behind;
+        }
+
+        // Adds the next slot, in front of every other
+        void append() {
+            std::uint64_t key = keyAboveTop();
+            std::uint32_t slot = static_cast<std::uint32_t>(keys_.size());
+            keys_.push_back(key);
+            above_.push_back(kNone);
+            below_.push_back(kNone);
+            linkAbove(slot, top_);
+        }
+
+        // Removes slot; the slots after it move down by one. Removing the
+        // last slot is O(1), any other O(n).
+        void erase(size_t slot) {
+            const std::uint32_t removed = static_cast<std::uint32_t>(slot);
+            unlink(removed);
+            keys_.erase(keys_.begin() + slot);
+            above_.erase(above_.begin() + slot);
+            below_.erase(below_.begin() + slot);
+            if (slot == keys_.size()) {
+                return;
+            }
+            auto renumber = [removed](std::uint32_t& link) {
+                if (link != kNone && link > removed) --link;
+            };
+            for (std::uint32_t& link : above_) renumber(link);
+            for (std::uint32_t& link : below_) renumber(link);
+            renumber(bottom_);
+            renumber(top_);
+        }
+
+        // Each returns false, changing nothing, if the shape is already there
+        bool bringToFront(size_t slot) {
+            const std::uint32_t moved = static_cast<std::uint32_t>(slot);
+            if (moved == top_) return false;
+            std::uint64_t key = keyAboveTop();
+            unlink(moved);
+            keys_[moved] = key;
+            linkAbove(moved, top_);
+            return true;
+        }
+
+        bool sendToBack(size_t slot) {
+            const std::uint32_t moved = static_cast<std::uint32_t>(slot);
+            if (moved == bottom_) return false;
+            std::uint64_t key = keyBelowBottom();
+            unlink(moved);
+            keys_[moved] = key;
+            linkAbove(moved, kNone);
+            return true;
+        }
+
+        // One step toward the front: trades places, and keys, with the shape
+        // just above
+        bool raise(size_t slot) {
+            const std::uint32_t moved = static_cast<std::uint32_t>(slot);
+            const std::uint32_t above = above_[moved];
+            if (above == kNone) return false;
+            std::swap(keys_[moved], keys_[above]);
+            unlink(moved);
+            linkAbove(moved, above);
+            return true;
+        }
+
+        bool lower(size_t slot) {
+            const std::uint32_t moved = static_cast<std::uint32_t>(slot);
+            const std::uint32_t below = below_[moved];
+            if (below == kNone) return false;
+            std::swap(keys_[moved], keys_[below]);
+            unlink(moved);
+            linkAbove(moved, below_[below]);
+            return true;
+        }
+
+        // Moves the run linked from first up to last, keeping its order, to
+        // just above anchor, or to the bottom if anchor is kNone; anchor must
+        // not lie in the run. The run takes keys spread between its new
+        // neighbours' in O(length), or all keys are reassigned when there is
+        // no room.
+        void moveRun(size_t first, size_t last, std::uint32_t anchor) {
+            const std::uint32_t bottom = static_cast<std::uint32_t>(first);
+            const std::uint32_t top = static_cast<std::uint32_t>(last);
+            std::uint32_t below = below_[bottom], above = above_[top];
+            if (below != kNone) above_[below] = above;
+            else bottom_ = above;
+            if (above != kNone) below_[above] = below;
+            else top_ = below;
+
+            above = anchor == kNone ? bottom_ : above_[anchor];
+            below_[bottom] = anchor;
+            above_[top] = above;
+            if (anchor != kNone) above_[anchor] = bottom;
+            else bottom_ = bottom;
+            if (above != kNone) below_[above] = top;
+            else top_ = top;
+
+            std::uint64_t length = 1;
+            for (std::uint32_t slot = bottom; slot != top; slot = above_[slot]) ++length;
+            std::uint64_t low, step;
+            if (anchor == kNone && above == kNone) {
+                return;
+            }
+            if (anchor == kNone) {
+                step = kGap;
+                if (keys_[above] < (length + 1) * kGap) {
+                    relabel();
+                    return;
+                }
+                low = keys_[above] - (length + 1) * kGap;
+            }
+            else if (above == kNone) {
+                step = kGap;
+                low = keys_[anchor];
+                if (low > ~0ull - (length + 1) * kGap) {
+                    relabel();
+                    return;
+                }
+            }
+            else {
+                low = keys_[anchor];
+                step = (keys_[above] - low) / (length + 1);
+                if (step == 0) {
+                    relabel();
+                    return;
+                }
+            }
+            std::uint64_t key = low;
+            for (std::uint32_t slot = bottom; ; slot = above_[slot]) {
+                key += step;
+                keys_[slot] = key;
+                if (slot == top) break;
+            }
+        }
+    };
+
+}
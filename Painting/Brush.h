@@ -1,5 +1,5 @@
 #pragma once
-#include <string>
+#include "Color.h"
 
 namespace Painting {
 
@@ -12,23 +12,22 @@ namespace Painting {
         };
 
     private:
-        std::string color_;
+        Color color_;
         Style style_;
         float opacity_;
 
     public:
-        Brush(std::string color = "none", Style style = Style::NONE, float opacity = 1.0f)
+        Brush(Color color = Color::none(), Style style = Style::NONE, float opacity = 1.0f)
             : color_(color), style_(style), opacity_(opacity) {
         }
 
-        const std::string& getColor() const { return color_; }
+        Color getColor() const { return color_; }
         Style getStyle() const { return style_; }
         float getOpacity() const { return opacity_; }
 
-        void setColor(const std::string& color) { color_ = color; }
+        void setColor(Color color) { color_ = color; }
         void setStyle(Style style) { style_ = style; }
         void setOpacity(float opacity) { opacity_ = opacity; }
     };
 
 }
-
@@ -0,0 +1,308 @@
+#pragma once
+#include "StableTable.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Painting {
+
+    // Packed 0xRRGGBBAA color. Parsed once from a CSS color name, hex code or
+    // rgb()/rgba() so that pens and brushes can be compared and hashed as plain
+    // integers.
+    //
+    // Text that toString() would not give back as written, such as rgb(...),
+    // an upper-case hex code or text that does not parse, is also kept,
+    // interned, and written out unchanged.
+    class Color {
+        std::uint32_t rgba_;
+        std::uint32_t literal_;     // 0, or 1 + the index of the text as written
+
+        struct NamedColor {
+            const char* name;
+            std::uint32_t rgb;
+        };
+
+        static const NamedColor* namedColors(size_t& count) {
+            static const NamedColor table[] = {
+                { "black", 0x000000 }, { "white", 0xFFFFFF }, { "gray", 0x808080 }, { "grey", 0x808080 },
+                { "lightgray", 0xD3D3D3 }, { "lightgrey", 0xD3D3D3 }, { "darkgray", 0xA9A9A9 }, { "darkgrey", 0xA9A9A9 },
+                { "dimgray", 0x696969 }, { "silver", 0xC0C0C0 }, { "gainsboro", 0xDCDCDC }, { "whitesmoke", 0xF5F5F5 },
+                { "red", 0xFF0000 }, { "darkred", 0x8B0000 }, { "maroon", 0x800000 }, { "crimson", 0xDC143C },
+                { "firebrick", 0xB22222 }, { "indianred", 0xCD5C5C }, { "salmon", 0xFA8072 }, { "tomato", 0xFF6347 },
+                { "coral", 0xFF7F50 }, { "orangered", 0xFF4500 }, { "orange", 0xFFA500 }, { "darkorange", 0xFF8C00 },
+                { "gold", 0xFFD700 }, { "yellow", 0xFFFF00 }, { "khaki", 0xF0E68C }, { "beige", 0xF5F5DC },
+                { "ivory", 0xFFFFF0 }, { "wheat", 0xF5DEB3 }, { "tan", 0xD2B48C }, { "chocolate", 0xD2691E },
+                { "sienna", 0xA0522D }, { "brown", 0xA52A2A }, { "green", 0x008000 }, { "darkgreen", 0x006400 },
+                { "lime", 0x00FF00 }, { "limegreen", 0x32CD32 }, { "lightgreen", 0x90EE90 }, { "olive", 0x808000 },
+                { "seagreen", 0x2E8B57 }, { "forestgreen", 0x228B22 }, { "teal", 0x008080 }, { "cyan", 0x00FFFF },
+                { "aqua", 0x00FFFF }, { "turquoise", 0x40E0D0 }, { "blue", 0x0000FF }, { "navy", 0x000080 },
+                { "darkblue", 0x00008B }, { "mediumblue", 0x0000CD }, { "royalblue", 0x4169E1 }, { "steelblue", 0x4682B4 },
+                { "skyblue", 0x87CEEB }, { "lightblue", 0xADD8E6 }, { "dodgerblue", 0x1E90FF }, { "indigo", 0x4B0082 },
+                { "purple", 0x800080 }, { "violet", 0xEE82EE }, { "magenta", 0xFF00FF }, { "fuchsia", 0xFF00FF },
+                { "orchid", 0xDA70D6 }, { "plum", 0xDDA0DD }, { "pink", 0xFFC0CB }, { "hotpink", 0xFF69B4 },
+                { "lavender", 0xE6E6FA },
+                // The rest of the CSS named colors, after the ones above so that
+                // toString() keeps picking the same name for their values
+                { "aliceblue", 0xF0F8FF }, { "antiquewhite", 0xFAEBD7 }, { "aquamarine", 0x7FFFD4 }, { "azure", 0xF0FFFF },
+                { "bisque", 0xFFE4C4 }, { "blanchedalmond", 0xFFEBCD }, { "blueviolet", 0x8A2BE2 }, { "burlywood", 0xDEB887 },
+                { "cadetblue", 0x5F9EA0 }, { "chartreuse", 0x7FFF00 }, { "cornflowerblue", 0x6495ED }, { "cornsilk", 0xFFF8DC },
+                { "darkcyan", 0x008B8B }, { "darkgoldenrod", 0xB8860B }, { "darkkhaki", 0xBDB76B }, { "darkmagenta", 0x8B008B },
+                { "darkolivegreen", 0x556B2F }, { "darkorchid", 0x9932CC }, { "darksalmon", 0xE9967A }, { "darkseagreen", 0x8FBC8F },
+                { "darkslateblue", 0x483D8B }, { "darkslategray", 0x2F4F4F }, { "darkslategrey", 0x2F4F4F }, { "darkturquoise", 0x00CED1 },
+                { "darkviolet", 0x9400D3 }, { "deeppink", 0xFF1493 }, { "deepskyblue", 0x00BFFF }, { "dimgrey", 0x696969 },
+                { "floralwhite", 0xFFFAF0 }, { "ghostwhite", 0xF8F8FF }, { "goldenrod", 0xDAA520 }, { "greenyellow", 0xADFF2F },
+                { "honeydew", 0xF0FFF0 }, { "lavenderblush", 0xFFF0F5 }, { "lawngreen", 0x7CFC00 }, { "lemonchiffon", 0xFFFACD },
+                { "lightcoral", 0xF08080 }, { "lightcyan", 0xE0FFFF }, { "lightgoldenrodyellow", 0xFAFAD2 }, { "lightpink", 0xFFB6C1 },
+                { "lightsalmon", 0xFFA07A }, { "lightseagreen", 0x20B2AA }, { "lightskyblue", 0x87CEFA }, { "lightslategray", 0x778899 },
+                { "lightslategrey", 0x778899 }, { "lightsteelblue", 0xB0C4DE }, { "lightyellow", 0xFFFFE0 }, { "linen", 0xFAF0E6 },
+                { "mediumaquamarine", 0x66CDAA }, { "mediumorchid", 0xBA55D3 }, { "mediumpurple", 0x9370DB }, { "mediumseagreen", 0x3CB371 },
+                { "mediumslateblue", 0x7B68EE }, { "mediumspringgreen", 0x00FA9A }, { "mediumturquoise", 0x48D1CC }, { "mediumvioletred", 0xC71585 },
+                { "midnightblue", 0x191970 }, { "mintcream", 0xF5FFFA }, { "mistyrose", 0xFFE4E1 }, { "moccasin", 0xFFE4B5 },
+                { "navajowhite", 0xFFDEAD }, { "oldlace", 0xFDF5E6 }, { "olivedrab", 0x6B8E23 }, { "palegoldenrod", 0xEEE8AA },
+                { "palegreen", 0x98FB98 }, { "paleturquoise", 0xAFEEEE }, { "palevioletred", 0xDB7093 }, { "papayawhip", 0xFFEFD5 },
+                { "peachpuff", 0xFFDAB9 }, { "peru", 0xCD853F }, { "powderblue", 0xB0E0E6 }, { "rebeccapurple", 0x663399 },
+                { "rosybrown", 0xBC8F8F }, { "saddlebrown", 0x8B4513 }, { "sandybrown", 0xF4A460 }, { "seashell", 0xFFF5EE },
+                { "slateblue", 0x6A5ACD }, { "slategray", 0x708090 }, { "slategrey", 0x708090 }, { "snow", 0xFFFAFA },
+                { "springgreen", 0x00FF7F }, { "thistle", 0xD8BFD8 }, { "yellowgreen", 0x9ACD32 }
+            };
+            count = sizeof(table) / sizeof(table[0]);
+            return table;
+        }
+
+        struct Literals {
+            StableTable<std::string> texts;
+            std::unordered_map<std::string, std::uint32_t> index;
+            std::mutex mutex;
+        };
+
+        static Literals& literals() {
+            static Literals instance;
+            return instance;
+        }
+
+        static std::uint32_t internLiteral(const std::string& text) {
+            Literals& table = literals();
+            std::lock_guard<std::mutex> lock(table.mutex);
+            auto inserted = table.index.emplace(text, static_cast<std::uint32_t>(table.texts.size()) + 1);
+            if (inserted.second) {
+                table.texts.push_back(text);
+            }
+            return inserted.first->second;
+        }
+
+        static int hexDigit(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        // One channel of rgb()/rgba() at text[pos]: a number, or a percentage
+        // of max, clamped to [0, max]. Advances pos past it.
+        static bool parseChannel(const std::string& text, size_t& pos, double max, double& value) {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+            const char* start = text.c_str() + pos;
+            char* end = nullptr;
+            value = std::strtod(start, &end);
+            if (end == start || !std::isfinite(value)) return false;
+            pos += static_cast<size_t>(end - start);
+            if (pos < text.size() && text[pos] == '%') {
+                value = value * max / 100.0;
+                ++pos;
+            }
+            value = std::min(std::max(value, 0.0), max);
+            return true;
+        }
+
+        // rgb(r, g, b) and rgba(r, g, b, a), with commas, or spaces and an
+        // optional "/ a" as in CSS Color 4. lower is the text in lower case.
+        static bool parseFunction(const std::string& lower, Color& out) {
+            size_t pos = 0;
+            if (lower.compare(0, 5, "rgba(") == 0) pos = 5;
+            else if (lower.compare(0, 4, "rgb(") == 0) pos = 4;
+            else return false;
+
+            double channels[4] = { 0.0, 0.0, 0.0, 1.0 };
+            size_t count = 0;
+            bool commas = false;
+            while (count < 4) {
+                if (!parseChannel(lower, pos, count < 3 ? 255.0 : 1.0, channels[count])) return false;
+                ++count;
+                while (pos < lower.size() && std::isspace(static_cast<unsigned char>(lower[pos]))) ++pos;
+                if (pos >= lower.size()) return false;
+                if (lower[pos] == ')') break;
+                if (count == 3 && lower[pos] == '/') {
+                    ++pos;
+                    continue;
+                }
+                if (lower[pos] == ',') {
+                    if (count > 1 && !commas) return false;
+                    commas = true;
+                    ++pos;
+                }
+                else if (commas) {
+                    return false;
+                }
+            }
+            if (count < 3 || pos >= lower.size() || lower[pos] != ')' || pos + 1 != lower.size()) return false;
+
+            std::uint32_t rgba = 0;
+            for (size_t i = 0; i < 4; ++i) {
+                double scale = i < 3 ? 1.0 : 255.0;
+                rgba = (rgba << 8) | static_cast<std::uint32_t>(channels[i] * scale + 0.5);
+            }
+            out = fromRGBA(rgba);
+            return true;
+        }
+
+    public:
+        Color() : rgba_(0x000000FFu), literal_(0) {
+        }
+
+        explicit Color(const std::string& text) : Color(parse(text)) {
+        }
+
+        // Implicit so that call sites can keep writing Pen("gray", ...)
+        Color(const char* text) : Color(parse(text)) {
+        }
+
+        static Color fromRGBA(std::uint32_t rgba) {
+            Color c;
+            c.rgba_ = rgba;
+            return c;
+        }
+
+        static Color none() {
+            return fromRGBA(0);
+        }
+
+        static bool tryParse(const std::string& text, Color& out) {
+            if (text.empty() || text == "none" || text == "transparent") {
+                out = none();
+                return true;
+            }
+
+            if (text[0] == '#') {
+                size_t digits = text.size() - 1;
+                if (digits != 3 && digits != 6 && digits != 8) return false;
+
+                std::uint32_t value = 0;
+                for (size_t i = 1; i < text.size(); ++i) {
+                    int d = hexDigit(text[i]);
+                    if (d < 0) return false;
+                    value = (value << 4) | static_cast<std::uint32_t>(d);
+                }
+
+                if (digits == 3) {
+                    std::uint32_t r = (value >> 8) & 0xF, g = (value >> 4) & 0xF, b = value & 0xF;
+                    value = (r * 0x11) << 16 | (g * 0x11) << 8 | (b * 0x11);
+                }
+                out = fromRGBA(digits == 8 ? value : (value << 8) | 0xFF);
+                return true;
+            }
+
+            std::string lower;
+            lower.reserve(text.size());
+            for (char c : text) {
+                lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+
+            size_t count = 0;
+            const NamedColor* table = namedColors(count);
+            for (size_t i = 0; i < count; ++i) {
+                if (lower == table[i].name) {
+                    out = fromRGBA((table[i].rgb << 8) | 0xFF);
+                    return true;
+                }
+            }
+            return parseFunction(lower, out);
+        }
+
+        // Text that does not parse is kept as written and packs as black, the
+        // default stroke of every shape, for backends that need the numbers.
+        static Color parse(const std::string& text) {
+            Color result;
+            if (!tryParse(text, result)) {
+                result = Color();
+                result.literal_ = internLiteral(text);
+            }
+            else if (!result.isNone() && result.toString() != text) {
+                result.literal_ = internLiteral(text);
+            }
+            return result;
+        }
+
+        std::uint32_t rgba() const { return rgba_; }
+
+        // The packed color and, above it, the text it was written as, if kept
+        std::uint64_t key() const { return (static_cast<std::uint64_t>(literal_) << 32) | rgba_; }
+        std::uint8_t red() const { return static_cast<std::uint8_t>(rgba_ >> 24); }
+        std::uint8_t green() const { return static_cast<std::uint8_t>(rgba_ >> 16); }
+        std::uint8_t blue() const { return static_cast<std::uint8_t>(rgba_ >> 8); }
+        std::uint8_t alpha() const { return static_cast<std::uint8_t>(rgba_); }
+
+        bool isNone() const { return alpha() == 0; }
+        float opacity() const { return alpha() / 255.0f; }
+
+        // The opacity toString() leaves out, for backends to emit on its own:
+        // none for text written out as given, which carries its own
+        float separateOpacity() const { return literal_ != 0 ? 1.0f : opacity(); }
+
+        // Canonical CSS form: the text as written if kept, otherwise the first
+        // matching color name, otherwise #rrggbb. Alpha is not part of the
+        // string; backends emit separateOpacity().
+        std::string toString() const {
+            if (literal_ != 0) return literals().texts[literal_ - 1];
+            if (isNone()) return "none";
+
+            std::uint32_t rgb = rgba_ >> 8;
+            size_t count = 0;
+            const NamedColor* table = namedColors(count);
+            for (size_t i = 0; i < count; ++i) {
+                if (table[i].rgb == rgb) return table[i].name;
+            }
+
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "#%06x", static_cast<unsigned>(rgb));
+            return buffer;
+        }
+
+        // Shortest equivalent CSS form: a name, #rgb or #rrggbb, whichever is
+        // fewest characters; text kept as written is left alone.
+        std::string toShortString() const {
+            if (literal_ != 0) return literals().texts[literal_ - 1];
+            if (isNone()) return "none";
+
+            std::uint32_t rgb = rgba_ >> 8;
+            char buffer[8];
+            std::uint32_t r = rgb >> 16, g = (rgb >> 8) & 0xFF, b = rgb & 0xFF;
+            if (r % 0x11 == 0 && g % 0x11 == 0 && b % 0x11 == 0) {
+                std::snprintf(buffer, sizeof(buffer), "#%x%x%x",
+                    static_cast<unsigned>(r / 0x11), static_cast<unsigned>(g / 0x11), static_cast<unsigned>(b / 0x11));
+            }
+            else {
+                std::snprintf(buffer, sizeof(buffer), "#%06x", static_cast<unsigned>(rgb));
+            }
+            std::string shortest = buffer;
+
+            size_t count = 0;
+            const NamedColor* table = namedColors(count);
+            for (size_t i = 0; i < count; ++i) {
+                if (table[i].rgb == rgb && std::string(table[i].name).size() < shortest.size()) {
+                    shortest = table[i].name;
+                }
+            }
+            return shortest;
+        }
+
+        bool operator==(const Color& other) const { return key() == other.key(); }
+        bool operator!=(const Color& other) const { return key() != other.key(); }
+    };
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "IPainter.h"
+#include <cstdint>
+
+namespace Painting {
+
+    // Counts the primitives, polygon points and text bytes it is asked to draw.
+    class CountingPainter : public IPainter {
+    public:
+        struct Counts {
+            std::uint64_t lines;
+            std::uint64_t ellipses;
+            std::uint64_t polygons;
+            std::uint64_t texts;
+            std::uint64_t points;
+            std::uint64_t textBytes;
+
+            std::uint64_t primitives() const {
+                return lines + ellipses + polygons + texts;
+            }
+        };
+
+    private:
+        int width_;
+        int height_;
+        Counts counts_;
+
+    public:
+        CountingPainter(int width = 800, int height = 600)
+            : width_(width), height_(height), counts_() {
+        }
+
+        void drawLine(int, int, int, int, PenHandle) override {
+            counts_.lines++;
+            counts_.points += 2;
+        }
+
+        void drawEllipse(int, int, int, int, PenHandle, BrushHandle) override {
+            counts_.ellipses++;
+            counts_.points += 1;
+        }
+
+        void drawPolygon(const int*, const int*, int numPoints, PenHandle, BrushHandle) override {
+            counts_.polygons++;
+            counts_.points += static_cast<std::uint64_t>(numPoints);
+        }
+
+        void drawText(int, int, const std::string& text, TextStyleHandle) override {
+            counts_.texts++;
+            counts_.points += 1;
+            counts_.textBytes += text.size();
+        }
+
+        void beginPaint() override {
+            counts_ = Counts();
+        }
+
+        void endPaint() override {}
+        int getWidth() const override { return width_; }
+        int getHeight() const override { return height_; }
+
+        const Counts& getCounts() const { return counts_; }
+    };
+
+}
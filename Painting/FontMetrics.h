@@ -0,0 +1,105 @@
+#pragma once
+#include <cctype>
+#include <string>
+
+namespace Painting {
+
+    // Built-in advance widths (1/1000 em) for printable ASCII, taken from the
+    // standard Helvetica and Times metrics; Courier is a flat 600. Font families are mapped
+    // onto the closest table; unknown families use the sans-serif one.
+    class FontMetrics {
+    public:
+        enum class Face {
+            SANS,
+            SERIF,
+            MONO
+        };
+
+    private:
+        const unsigned short* widths_;
+        unsigned short fallback_;
+
+        static const unsigned short* sansWidths() {
+            static const unsigned short table[95] = {
+                278, 278, 355, 556, 556, 889, 667, 191, 333, 333, 389, 584, 278, 333, 278, 278,
+                556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 278, 278, 584, 584, 584, 556,
+                1015, 667, 667, 722, 722, 667, 611, 778, 722, 278, 500, 667, 556, 833, 722, 778,
+                667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 278, 278, 278, 469, 556,
+                333, 556, 556, 500, 556, 556, 278, 556, 556, 222, 222, 500, 222, 833, 556, 556,
+                556, 556, 333, 500, 278, 556, 500, 722, 500, 500, 500, 334, 260, 334, 584
+            };
+            return table;
+        }
+
+        static const unsigned short* serifWidths() {
+            static const unsigned short table[95] = {
+                250, 333, 408, 500, 500, 833, 778, 180, 333, 333, 500, 564, 250, 333, 250, 278,
+                500, 500, 500, 500, 500, 500, 500, 500, 500, 500, 278, 278, 564, 564, 564, 444,
+                921, 722, 667, 667, 722, 611, 556, 722, 722, 333, 389, 722, 611, 889, 722, 722,
+                556, 722, 667, 556, 611, 722, 722, 944, 722, 722, 611, 333, 278, 333, 469, 500,
+                333, 444, 500, 444, 500, 444, 333, 500, 500, 278, 278, 500, 278, 778, 500, 500,
+                500, 500, 333, 389, 278, 500, 500, 722, 500, 500, 444, 480, 200, 480, 541
+            };
+            return table;
+        }
+
+    public:
+        explicit FontMetrics(Face face = Face::SANS) {
+            switch (face) {
+            case Face::SERIF: widths_ = serifWidths(); fallback_ = 500; break;
+            case Face::MONO: widths_ = nullptr; fallback_ = 600; break;
+            default: widths_ = sansWidths(); fallback_ = 556; break;
+            }
+        }
+
+        static Face faceFor(const std::string& fontFamily) {
+            std::string lower;
+            for (char c : fontFamily) {
+                lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            if (lower.find("courier") != std::string::npos || lower.find("mono") != std::string::npos ||
+                lower.find("consolas") != std::string::npos) {
+                return Face::MONO;
+            }
+            if (lower.find("times") != std::string::npos || lower.find("georgia") != std::string::npos ||
+                lower == "serif") {
+                return Face::SERIF;
+            }
+            return Face::SANS;
+        }
+
+        static const FontMetrics& forFamily(const std::string& fontFamily) {
+            static const FontMetrics sans(Face::SANS);
+            static const FontMetrics serif(Face::SERIF);
+            static const FontMetrics mono(Face::MONO);
+            switch (faceFor(fontFamily)) {
+            case Face::SERIF: return serif;
+            case Face::MONO: return mono;
+            default: return sans;
+            }
+        }
+
+        // Width of one byte in 1/1000 em. UTF-8 continuation bytes are free so a
+        // multi-byte character is counted once, at the fallback width.
+        int advance(unsigned char c) const {
+            if ((c & 0xC0) == 0x80) return 0;
+            if (!widths_) return c == '\t' ? fallback_ * 4 : fallback_;
+            if (c >= 32 && c < 127) return widths_[c - 32];
+            if (c == '\t') return widths_[0] * 4;
+            return fallback_;
+        }
+
+        int measure(const std::string& text, size_t begin, size_t end) const {
+            int units = 0;
+            for (size_t i = begin; i < end; ++i) {
+                units += advance(static_cast<unsigned char>(text[i]));
+            }
+            return units;
+        }
+
+        int measure(const std::string& text) const {
+            return measure(text, 0, text.size());
+        }
+    };
+
+}
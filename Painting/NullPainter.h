@@ -0,0 +1,29 @@
+#pragma once
+#include "IPainter.h"
+
+namespace Painting {
+
+    // Accepts every primitive and does nothing. Rendering into it measures the
+    // cost of walking the model without any output formatting.
+    class NullPainter : public IPainter {
+    private:
+        int width_;
+        int height_;
+
+    public:
+        NullPainter(int width = 800, int height = 600)
+            : width_(width), height_(height) {
+        }
+
+        void drawLine(int, int, int, int, PenHandle) override {}
+        void drawEllipse(int, int, int, int, PenHandle, BrushHandle) override {}
+        void drawPolygon(const int*, const int*, int, PenHandle, BrushHandle) override {}
+        void drawText(int, int, const std::string&, TextStyleHandle) override {}
+
+        void beginPaint() override {}
+        void endPaint() override {}
+        int getWidth() const override { return width_; }
+        int getHeight() const override { return height_; }
+    };
+
+}
@@ -0,0 +1,425 @@
+#pragma once
+#include "IPainter.h"
+#include "StylePalette.h"
+#include "FontMetrics.h"
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef PP_USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace Painting {
+
+    // Writes a PDF document straight to a stream, one page per
+    // beginPaint()/endPaint() pair. Each page's content stream is built in
+    // memory and written out when the page ends, so memory is bounded by one
+    // page; the page tree and cross-reference table follow in endDocument().
+    //
+    // Text uses the standard Helvetica, Times and Courier fonts in WinAnsi
+    // encoding. Content streams are Flate-compressed when built with
+    // PP_USE_ZLIB and linked against zlib.
+    class PdfPainter : public IPainter {
+    private:
+        // Objects 1 and 2 are the catalog and the page tree; the three fonts
+        // follow, and pages are numbered from there as they are written.
+        static const int kCatalogObject = 1;
+        static const int kPagesObject = 2;
+        static const int kFirstFontObject = 3;
+        static const int kFontCount = 3;
+
+        std::ostream& out_;
+        long long written_;
+        int width_;
+        int height_;
+        bool started_;
+        bool finished_;
+        bool isPainting_;
+
+        std::vector<long long> offsets_;
+        std::vector<int> pageObjects_;
+
+        // Current page
+        std::string content_;
+        std::set<int> alphas_;
+        std::uint32_t strokeColor_;
+        std::uint32_t fillColor_;
+        int lineWidth_;
+        int dash_;
+        int alpha_;
+
+        static const char* fontName(FontMetrics::Face face) {
+            switch (face) {
+            case FontMetrics::Face::SERIF: return "Times-Roman";
+            case FontMetrics::Face::MONO: return "Courier";
+            default: return "Helvetica";
+            }
+        }
+
+        static int fontIndex(FontMetrics::Face face) {
+            switch (face) {
+            case FontMetrics::Face::SERIF: return 2;
+            case FontMetrics::Face::MONO: return 3;
+            default: return 1;
+            }
+        }
+
+        // Shortest decimal with up to two places
+        static std::string number(double value) {
+            std::string text;
+            appendNumber(text, value);
+            return text;
+        }
+
+        static void appendNumber(std::string& out, double value) {
+            long long hundredths = static_cast<long long>(value * 100.0 + (value < 0 ? -0.5 : 0.5));
+            if (hundredths < 0) {
+                out += '-';
+                hundredths = -hundredths;
+            }
+            out += std::to_string(hundredths / 100);
+            int fraction = static_cast<int>(hundredths % 100);
+            if (fraction != 0) {
+                out += '.';
+                out += static_cast<char>('0' + fraction / 10);
+                if (fraction % 10 != 0) out += static_cast<char>('0' + fraction % 10);
+            }
+        }
+
+        // Appends a number and a trailing space to the page content
+        void put(double value) {
+            appendNumber(content_, value);
+            content_ += ' ';
+        }
+
+        void write(const std::string& text) {
+            out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+            written_ += static_cast<long long>(text.size());
+        }
+
+        int newObject() {
+            offsets_.push_back(written_);
+            int id = static_cast<int>(offsets_.size());
+            write(std::to_string(id) + " 0 obj\n");
+            return id;
+        }
+
+        void reserveObjects(int count) {
+            for (int i = 0; i < count; ++i) offsets_.push_back(0);
+        }
+
+        void beginDocument() {
+            write("%PDF-1.4\n%\xE2\xE3\xCF\xD3\n");
+            reserveObjects(kFirstFontObject - 1);
+
+            for (int i = 0; i < kFontCount; ++i) {
+                FontMetrics::Face face = i == 0 ? FontMetrics::Face::SANS
+                    : i == 1 ? FontMetrics::Face::SERIF : FontMetrics::Face::MONO;
+                newObject();
+                write(std::string("<< /Type /Font /Subtype /Type1 /BaseFont /") + fontName(face) +
+                    " /Encoding /WinAnsiEncoding >>\nendobj\n");
+            }
+            started_ = true;
+        }
+
+        double pdfY(double y) const {
+            return height_ - y;
+        }
+
+        void setStroke(const Pen& pen) {
+            std::uint32_t rgba = pen.getColor().rgba();
+            if (rgba != strokeColor_) {
+                content_ += color(pen.getColor()) + " RG\n";
+                strokeColor_ = rgba;
+            }
+            if (pen.getWidth() != lineWidth_) {
+                content_ += std::to_string(pen.getWidth()) + " w\n";
+                lineWidth_ = pen.getWidth();
+            }
+            int dash = static_cast<int>(pen.getType());
+            if (dash != dash_) {
+                switch (pen.getType()) {
+                case Pen::Type::DASHED: content_ += "[5 5] 0 d\n"; break;
+                case Pen::Type::DOTTED: content_ += "[2 2] 0 d\n"; break;
+                default: content_ += "[] 0 d\n"; break;
+                }
+                dash_ = dash;
+            }
+        }
+
+        void setFill(Color fill) {
+            if (fill.rgba() != fillColor_) {
+                content_ += color(fill) + " rg\n";
+                fillColor_ = fill.rgba();
+            }
+        }
+
+        // Fill opacity goes through an ExtGState per distinct alpha on the
+        // page. It sets only the nonstroking alpha (/ca): as with SVG's
+        // fill-opacity, the outline stays opaque.
+        void setFillAlpha(int alpha) {
+            if (alpha == alpha_) return;
+            alphas_.insert(alpha);
+            content_ += "/GA" + std::to_string(alpha) + " gs\n";
+            alpha_ = alpha;
+        }
+
+        static std::string color(Color c) {
+            return number(c.red() / 255.0) + " " + number(c.green() / 255.0) + " " + number(c.blue() / 255.0);
+        }
+
+        // Picks the painting operator for a closed path, setting up state
+        const char* paintOperator(PenHandle penHandle, BrushHandle brushHandle) {
+            auto& palette = StylePalette::getInstance();
+            const Pen& pen = palette.pen(penHandle);
+            const Brush& brush = palette.brush(brushHandle);
+
+            bool stroke = !pen.getColor().isNone() && pen.getWidth() > 0;
+            bool fill = brush.getStyle() != Brush::Style::NONE && !brush.getColor().isNone();
+
+            if (stroke) setStroke(pen);
+            if (fill) {
+                setFill(brush.getColor());
+                float opacity = brush.getOpacity() * brush.getColor().opacity();
+                setFillAlpha(static_cast<int>(opacity * 255.0f + 0.5f));
+            }
+            else {
+                setFillAlpha(255);
+            }
+
+            if (stroke && fill) return "B\n";
+            if (fill) return "f\n";
+            if (stroke) return "S\n";
+            return "n\n";
+        }
+
+        // WinAnsi string literal; characters outside Latin-1 become '?'
+        static std::string pdfString(const std::string& text) {
+            std::string result = "(";
+            for (size_t i = 0; i < text.size(); ++i) {
+                unsigned char c = static_cast<unsigned char>(text[i]);
+                unsigned int code = c;
+                if (c >= 0x80) {
+                    size_t length = (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 1;
+                    code = length == 2 && i + 1 < text.size()
+                        ? ((c & 0x1Fu) << 6) | (static_cast<unsigned char>(text[i + 1]) & 0x3Fu)
+                        : '?';
+                    if (code > 0xFF || code < 0xA0) code = '?';
+                    i += length - 1;
+                }
+
+                if (code == '(' || code == ')' || code == '\\') {
+                    result += '\\';
+                    result += static_cast<char>(code);
+                }
+                else if (code < 32) {
+                    result += ' ';
+                }
+                else {
+                    result += static_cast<char>(code);
+                }
+            }
+            result += ")";
+            return result;
+        }
+
+        std::string compress(const std::string& data, bool& compressed) const {
+#ifdef PP_USE_ZLIB
+            uLongf size = compressBound(static_cast<uLong>(data.size()));
+            std::string result(size, '\0');
+            if (compress2(reinterpret_cast<Bytef*>(&result[0]), &size,
+                reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()), Z_DEFAULT_COMPRESSION) == Z_OK) {
+                result.resize(size);
+                compressed = true;
+                return result;
+            }
+#endif
+            compressed = false;
+            return data;
+        }
+
+    public:
+        explicit PdfPainter(std::ostream& out, int width = 800, int height = 600)
+            : out_(out), written_(0), width_(width), height_(height),
+            started_(false), finished_(false), isPainting_(false),
+            strokeColor_(0), fillColor_(0), lineWidth_(1), dash_(0), alpha_(255) {
+        }
+
+        // Size of the pages begun from now on
+        void setPageSize(int width, int height) {
+            width_ = width;
+            height_ = height;
+        }
+
+        void beginPaint() override {
+            if (finished_) {
+                throw std::logic_error("PDF document already finished");
+            }
+            if (!started_) {
+                beginDocument();
+            }
+
+            content_.clear();
+            alphas_.clear();
+            // PDF graphics state defaults: black, width 1, solid, opaque
+            strokeColor_ = 0x000000FFu;
+            fillColor_ = 0x000000FFu;
+            lineWidth_ = 1;
+            dash_ = static_cast<int>(Pen::Type::SOLID);
+            alpha_ = 255;
+
+            // Page background, as in the SVG output
+            content_ += "1 g\n0 0 " + std::to_string(width_) + " " + std::to_string(height_) + " re\nf\n0 g\n";
+            isPainting_ = true;
+        }
+
+        void endPaint() override {
+            if (!isPainting_) return;
+            isPainting_ = false;
+
+            bool compressed = false;
+            std::string data = compress(content_, compressed);
+            std::string().swap(content_);
+
+            int contentObject = newObject();
+            write("<< /Length " + std::to_string(data.size()) + (compressed ? " /Filter /FlateDecode" : "") + " >>\nstream\n");
+            write(data);
+            write("\nendstream\nendobj\n");
+
+            std::string resources = "<< /Font << /F1 3 0 R /F2 4 0 R /F3 5 0 R >>";
+            if (!alphas_.empty()) {
+                resources += " /ExtGState <<";
+                for (int alpha : alphas_) {
+                    std::string value = number(alpha / 255.0);
+                    resources += " /GA" + std::to_string(alpha) + " << /ca " + value + " >>";
+                }
+                resources += " >>";
+            }
+            resources += " >>";
+
+            int pageObject = newObject();
+            write("<< /Type /Page /Parent 2 0 R /MediaBox [0 0 " + std::to_string(width_) + " " +
+                std::to_string(height_) + "] /Resources " + resources +
+                " /Contents " + std::to_string(contentObject) + " 0 R >>\nendobj\n");
+            pageObjects_.push_back(pageObject);
+        }
+
+        // Writes the page tree, catalog, cross-reference table and trailer
+        void endDocument() {
+            if (finished_) return;
+            if (isPainting_) endPaint();
+            if (!started_) beginDocument();
+
+            offsets_[kPagesObject - 1] = written_;
+            std::string kids;
+            for (int page : pageObjects_) {
+                if (!kids.empty()) kids += ' ';
+                kids += std::to_string(page) + " 0 R";
+            }
+            write(std::to_string(kPagesObject) + " 0 obj\n<< /Type /Pages /Kids [" + kids + "] /Count " +
+                std::to_string(pageObjects_.size()) + " >>\nendobj\n");
+
+            offsets_[kCatalogObject - 1] = written_;
+            write(std::to_string(kCatalogObject) + " 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n");
+
+            long long xref = written_;
+            write("xref\n0 " + std::to_string(offsets_.size() + 1) + "\n0000000000 65535 f \n");
+            char entry[32];
+            for (long long offset : offsets_) {
+                std::snprintf(entry, sizeof(entry), "%010lld 00000 n \n", offset);
+                write(entry);
+            }
+            write("trailer\n<< /Size " + std::to_string(offsets_.size() + 1) + " /Root 1 0 R >>\nstartxref\n" +
+                std::to_string(xref) + "\n%%EOF\n");
+            out_.flush();
+            finished_ = true;
+        }
+
+        void drawLine(int x1, int y1, int x2, int y2, PenHandle pen) override {
+            if (!isPainting_) return;
+            const Pen& style = StylePalette::getInstance().pen(pen);
+            if (style.getColor().isNone()) return;
+
+            setStroke(style);
+            setFillAlpha(255);
+            put(x1); put(pdfY(y1)); content_ += "m ";
+            put(x2); put(pdfY(y2)); content_ += "l S\n";
+        }
+
+        void drawEllipse(int centerX, int centerY, int radiusX, int radiusY,
+            PenHandle pen, BrushHandle brush) override {
+            if (!isPainting_) return;
+
+            // Four cubic Béziers, one per quadrant
+            const double k = 0.5522847498;
+            double cx = centerX, cy = pdfY(centerY);
+            double rx = radiusX, ry = radiusY;
+            double ox = rx * k, oy = ry * k;
+
+            const char* op = paintOperator(pen, brush);
+            const double path[4][6] = {
+                { cx + rx, cy + oy, cx + ox, cy + ry, cx, cy + ry },
+                { cx - ox, cy + ry, cx - rx, cy + oy, cx - rx, cy },
+                { cx - rx, cy - oy, cx - ox, cy - ry, cx, cy - ry },
+                { cx + ox, cy - ry, cx + rx, cy - oy, cx + rx, cy }
+            };
+            put(cx + rx); put(cy); content_ += "m\n";
+            for (const auto& curve : path) {
+                for (double value : curve) put(value);
+                content_ += "c\n";
+            }
+            content_ += op;
+        }
+
+        void drawPolygon(const int* xPoints, const int* yPoints, int numPoints,
+            PenHandle pen, BrushHandle brush) override {
+            if (!isPainting_ || numPoints < 3) return;
+
+            const char* op = paintOperator(pen, brush);
+            put(xPoints[0]); put(pdfY(yPoints[0])); content_ += "m\n";
+            for (int i = 1; i < numPoints; ++i) {
+                put(xPoints[i]); put(pdfY(yPoints[i])); content_ += "l\n";
+            }
+            content_ += "h ";
+            content_ += op;
+        }
+
+        void drawText(int x, int y, const std::string& text, TextStyleHandle style) override {
+            if (!isPainting_ || text.empty()) return;
+
+            const TextStyle& textStyle = StylePalette::getInstance().textStyle(style);
+            if (textStyle.color.isNone()) return;
+            FontMetrics::Face face = FontMetrics::faceFor(textStyle.fontFamily);
+            const FontMetrics& metrics = FontMetrics::forFamily(textStyle.fontFamily);
+
+            double left = x;
+            if (textStyle.anchor == TextAnchor::MIDDLE) {
+                left -= metrics.measure(text) * textStyle.fontSize / 2000.0;
+            }
+            // SVG text is vertically centred on y; PDF draws from the baseline
+            double baseline = pdfY(y + textStyle.fontSize * 0.35);
+
+            setFill(textStyle.color);
+            setFillAlpha(255);
+            content_ += "BT /F";
+            content_ += static_cast<char>('0' + fontIndex(face));
+            content_ += ' ';
+            put(textStyle.fontSize); content_ += "Tf ";
+            put(left); put(baseline); content_ += "Td ";
+            content_ += pdfString(text);
+            content_ += " Tj ET\n";
+        }
+
+        int getWidth() const override { return width_; }
+        int getHeight() const override { return height_; }
+
+        size_t pageCount() const { return pageObjects_.size(); }
+        long long bytesWritten() const { return written_; }
+    };
+
+}
@@ -1,5 +1,5 @@
 #pragma once
-#include <string>
+#include "Color.h"
 
 namespace Painting {
 
@@ -12,23 +12,22 @@ namespace Painting {
         };
 
     private:
-        std::string color_;
+        Color color_;
         int width_;
         Type type_;
 
     public:
-        Pen(std::string color = "black", int width = 1, Type type = Type::SOLID)
+        Pen(Color color = Color(), int width = 1, Type type = Type::SOLID)
             : color_(color), width_(width), type_(type) {
         }
 
-        const std::string& getColor() const { return color_; }
+        Color getColor() const { return color_; }
         int getWidth() const { return width_; }
         Type getType() const { return type_; }
 
-        void setColor(const std::string& color) { color_ = color; }
+        void setColor(Color color) { color_ = color; }
         void setWidth(int width) { width_ = width; }
         void setType(Type type) { type_ = type; }
     };
 
 }
-
@@ -10,8 +10,9 @@ namespace Painting {
         std::unique_ptr<SVGPainter> painter_;
 
     public:
-        explicit SVGCanvas(int width = 800, int height = 600)
-            : painter_(new SVGPainter(width, height)) {
+        explicit SVGCanvas(int width = 800, int height = 600,
+            SVGPainter::Format format = SVGPainter::Format::PRETTY)
+            : painter_(new SVGPainter(width, height, format)) {
         }
 
         SVGPainter& getPainter() {
@@ -1,32 +1,76 @@
 #pragma once
 #include "IPainter.h"
-#include "Pen.h"
-#include "Brush.h"
+#include "StylePalette.h"
+#include <cstdio>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace Painting {
 
     class SVGPainter : public IPainter {
+    public:
+        // MINIFIED drops indentation, newlines, default-valued attributes and
+        // redundant precision, and writes polygons as paths when that is shorter.
+        enum class Format {
+            PRETTY,
+            MINIFIED
+        };
+
     private:
         int width_;
         int height_;
+        Format format_;
         std::ostringstream content_;
+        std::ostream* stream_;
         bool isPainting_;
+        bool standalone_;
+
+        // Attribute strings formatted once per style handle, indexed by handle
+        std::vector<std::string> penAttrs_;
+        std::vector<std::string> brushAttrs_;
+        std::vector<std::string> textAttrs_;
+
+        // Reused buffer for building one element
+        std::string scratch_;
 
     public:
-        SVGPainter(int width = 800, int height = 600)
-            : width_(width), height_(height), isPainting_(false) {
+        SVGPainter(int width = 800, int height = 600, Format format = Format::PRETTY)
+            : width_(width), height_(height), format_(format), stream_(nullptr), isPainting_(false), standalone_(true) {
+        }
+
+        // Writes straight to the given stream instead of an internal buffer,
+        // so that large documents need not be held in memory; getSVG() then
+        // returns nothing.
+        SVGPainter(std::ostream& stream, int width = 800, int height = 600, Format format = Format::PRETTY)
+            : width_(width), height_(height), format_(format), stream_(&stream), isPainting_(false), standalone_(true) {
+        }
+
+        // A standalone document starts with an XML declaration; turn it off
+        // for SVG embedded in HTML. Minified output never has one.
+        void setStandalone(bool standalone) {
+            standalone_ = standalone;
         }
 
         void beginPaint() override {
             content_.str("");
-            content_ << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-            content_ << "<svg xmlns=\"http://www.w3.org/2000/svg\" ";
-            content_ << "width=\"" << width_ << "\" height=\"" << height_ << "\" ";
-            content_ << "style=\"overflow: visible;\">\n";
+            if (isMinified()) {
+                out() << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width_
+                    << "\" height=\"" << height_ << "\" overflow=\"visible\">";
+                out() << "<rect width=\"" << width_ << "\" height=\"" << height_
+                    << "\" fill=\"#fff\" stroke=\"gray\"/>";
+                isPainting_ = true;
+                return;
+            }
+
+            if (standalone_) {
+                out() << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+            }
+            out() << "<svg xmlns=\"http://www.w3.org/2000/svg\" ";
+            out() << "width=\"" << width_ << "\" height=\"" << height_ << "\" ";
+            out() << "style=\"overflow: visible;\">\n";
 
-            content_ << "  <rect x=\"0\" y=\"0\" width=\"" << width_
+            out() << "  <rect x=\"0\" y=\"0\" width=\"" << width_
                 << "\" height=\"" << height_
                 << "\" fill=\"white\" stroke=\"gray\" stroke-width=\"1\"/>\n";
 
@@ -34,128 +78,324 @@ namespace Painting {
         }
 
         void endPaint() override {
-            content_ << "</svg>\n";
+            out() << (isMinified() ? "</svg>" : "</svg>\n");
             isPainting_ = false;
         }
 
-        void drawLine(int x1, int y1, int x2, int y2, const Pen& pen) override {
+        void drawLine(int x1, int y1, int x2, int y2, PenHandle pen) override {
             if (!isPainting_) return;
 
-            content_ << "  <line x1=\"" << x1 << "\" y1=\"" << y1
+            if (isMinified()) {
+                out() << "<line x1=\"" << x1 << "\" y1=\"" << y1
+                    << "\" x2=\"" << x2 << "\" y2=\"" << y2 << "\"" << penAttributes(pen) << "/>";
+                return;
+            }
+
+            out() << "  <line x1=\"" << x1 << "\" y1=\"" << y1
                 << "\" x2=\"" << x2 << "\" y2=\"" << y2 << "\" ";
-            content_ << "stroke=\"" << pen.getColor() << "\" ";
-            content_ << "stroke-width=\"" << pen.getWidth() << "\" ";
+            out() << penAttributes(pen);
+            out() << "/>\n";
+        }
 
-            if (pen.getType() == Pen::Type::DASHED) {
-                content_ << "stroke-dasharray=\"5,5\" ";
+        void drawEllipse(int centerX, int centerY, int radiusX, int radiusY,
+            PenHandle pen, BrushHandle brush) override {
+            if (!isPainting_) return;
+
+            if (isMinified()) {
+                if (radiusX == radiusY) {
+                    out() << "<circle cx=\"" << centerX << "\" cy=\"" << centerY << "\" r=\"" << radiusX << "\"";
+                }
+                else {
+                    out() << "<ellipse cx=\"" << centerX << "\" cy=\"" << centerY
+                        << "\" rx=\"" << radiusX << "\" ry=\"" << radiusY << "\"";
+                }
+                out() << brushAttributes(brush) << penAttributes(pen) << "/>";
+                return;
             }
-            else if (pen.getType() == Pen::Type::DOTTED) {
-                content_ << "stroke-dasharray=\"2,2\" ";
+
+            out() << "  <ellipse cx=\"" << centerX << "\" cy=\"" << centerY
+                << "\" rx=\"" << radiusX << "\" ry=\"" << radiusY << "\" ";
+            out() << brushAttributes(brush);
+            out() << penAttributes(pen);
+            out() << "/>\n";
+        }
+
+        void drawPolygon(const int* xPoints, const int* yPoints, int numPoints,
+            PenHandle pen, BrushHandle brush) override {
+            if (!isPainting_ || numPoints < 3) return;
+
+            if (isMinified()) {
+                // Whichever element is shorter, tag included; the polygon on a tie
+                static const char kPathOpen[] = "<path d=\"";
+                static const char kPolygonOpen[] = "<polygon points=\"";
+                std::string& element = scratch_;
+                element.assign(kPathOpen);
+                size_t pathLength = appendPathData(element, xPoints, yPoints, numPoints);
+                if (sizeof(kPathOpen) - 1 + pathLength >=
+                    sizeof(kPolygonOpen) - 1 + polygonPointsLength(xPoints, yPoints, numPoints)) {
+                    element.assign(kPolygonOpen);
+                    appendPolygonPoints(element, xPoints, yPoints, numPoints);
+                }
+                element += '"';
+                element += brushAttributes(brush);
+                element += penAttributes(pen);
+                element += "/>";
+                out() << element;
+                return;
             }
 
-            content_ << "/>\n";
+            out() << "  <polygon points=\"";
+            for (int i = 0; i < numPoints; ++i) {
+                if (i > 0) out() << " ";
+                out() << xPoints[i] << "," << yPoints[i];
+            }
+            out() << "\" ";
+            out() << brushAttributes(brush);
+            out() << penAttributes(pen);
+            out() << "/>\n";
         }
 
-        void drawEllipse(int centerX, int centerY, int radiusX, int radiusY,
-            const Pen& pen, const Brush& brush) override {
+        void drawText(int x, int y, const std::string& text, TextStyleHandle style) override {
             if (!isPainting_) return;
 
-            content_ << "  <ellipse cx=\"" << centerX << "\" cy=\"" << centerY
-                << "\" rx=\"" << radiusX << "\" ry=\"" << radiusY << "\" ";
+            if (isMinified()) {
+                out() << "<text x=\"" << x << "\" y=\"" << y << "\"" << textAttributes(style) << ">";
+                out() << escapeXML(text) << "</text>";
+                return;
+            }
 
-            if (brush.getStyle() == Brush::Style::NONE) {
-                content_ << "fill=\"none\" ";
+            out() << "  <text x=\"" << x << "\" y=\"" << y << "\" ";
+            out() << textAttributes(style) << ">";
+            out() << escapeXML(text);
+            out() << "</text>\n";
+        }
+
+        int getWidth() const override { return width_; }
+        int getHeight() const override { return height_; }
+        Format getFormat() const { return format_; }
+
+        std::string getSVG() const {
+            return content_.str();
+        }
+
+        // Starts a buffer of elements with no document header or footer, for
+        // pieces painted separately and spliced in with appendFragment().
+        void beginFragment() {
+            content_.str("");
+            isPainting_ = true;
+        }
+
+        void appendFragment(const std::string& fragment) {
+            if (!isPainting_) return;
+            out() << fragment;
+        }
+
+    private:
+        static const std::string& cached(std::vector<std::string>& cache, std::uint32_t index) {
+            if (index >= cache.size()) {
+                cache.resize(index + 1);
             }
-            else {
-                content_ << "fill=\"" << brush.getColor() << "\" ";
-                content_ << "fill-opacity=\"" << brush.getOpacity() << "\" ";
+            return cache[index];
+        }
+
+        const std::string& penAttributes(PenHandle handle) {
+            const std::string& attrs = cached(penAttrs_, handle.index);
+            if (!attrs.empty()) return attrs;
+
+            const Pen& pen = StylePalette::getInstance().pen(handle);
+            std::ostringstream oss;
+            if (isMinified()) {
+                oss << " stroke=\"" << pen.getColor().toShortString() << "\"";
+                if (pen.getColor().separateOpacity() < 1.0f && !pen.getColor().isNone()) {
+                    oss << " stroke-opacity=\"" << shortNumber(pen.getColor().separateOpacity()) << "\"";
+                }
+                if (pen.getWidth() != 1) {
+                    oss << " stroke-width=\"" << pen.getWidth() << "\"";
+                }
+                if (pen.getType() == Pen::Type::DASHED) {
+                    oss << " stroke-dasharray=\"5\"";
+                }
+                else if (pen.getType() == Pen::Type::DOTTED) {
+                    oss << " stroke-dasharray=\"2\"";
+                }
+                return penAttrs_[handle.index] = oss.str();
             }
 
-            content_ << "stroke=\"" << pen.getColor() << "\" ";
-            content_ << "stroke-width=\"" << pen.getWidth() << "\" ";
+            oss << "stroke=\"" << pen.getColor().toString() << "\" ";
+            if (pen.getColor().separateOpacity() < 1.0f && !pen.getColor().isNone()) {
+                oss << "stroke-opacity=\"" << pen.getColor().separateOpacity() << "\" ";
+            }
+            oss << "stroke-width=\"" << pen.getWidth() << "\" ";
 
             if (pen.getType() == Pen::Type::DASHED) {
-                content_ << "stroke-dasharray=\"5,5\" ";
+                oss << "stroke-dasharray=\"5,5\" ";
             }
             else if (pen.getType() == Pen::Type::DOTTED) {
-                content_ << "stroke-dasharray=\"2,2\" ";
+                oss << "stroke-dasharray=\"2,2\" ";
             }
-
-            content_ << "/>\n";
+            return penAttrs_[handle.index] = oss.str();
         }
 
-        void drawPolygon(const int* xPoints, const int* yPoints, int numPoints,
-            const Pen& pen, const Brush& brush) override {
-            if (!isPainting_ || numPoints < 3) return;
+        const std::string& brushAttributes(BrushHandle handle) {
+            const std::string& attrs = cached(brushAttrs_, handle.index);
+            if (!attrs.empty()) return attrs;
 
-            content_ << "  <polygon points=\"";
-            for (int i = 0; i < numPoints; ++i) {
-                if (i > 0) content_ << " ";
-                content_ << xPoints[i] << "," << yPoints[i];
+            const Brush& brush = StylePalette::getInstance().brush(handle);
+            std::ostringstream oss;
+            if (isMinified()) {
+                if (brush.getStyle() == Brush::Style::NONE) {
+                    oss << " fill=\"none\"";
+                }
+                else {
+                    float opacity = brush.getOpacity() * brush.getColor().separateOpacity();
+                    oss << " fill=\"" << brush.getColor().toShortString() << "\"";
+                    if (opacity < 1.0f) {
+                        oss << " fill-opacity=\"" << shortNumber(opacity) << "\"";
+                    }
+                }
+                return brushAttrs_[handle.index] = oss.str();
             }
-            content_ << "\" ";
 
             if (brush.getStyle() == Brush::Style::NONE) {
-                content_ << "fill=\"none\" ";
+                oss << "fill=\"none\" ";
             }
             else {
-                content_ << "fill=\"" << brush.getColor() << "\" ";
-                content_ << "fill-opacity=\"" << brush.getOpacity() << "\" ";
+                oss << "fill=\"" << brush.getColor().toString() << "\" ";
+                oss << "fill-opacity=\"" << brush.getOpacity() * brush.getColor().separateOpacity() << "\" ";
             }
+            return brushAttrs_[handle.index] = oss.str();
+        }
 
-            content_ << "stroke=\"" << pen.getColor() << "\" ";
-            content_ << "stroke-width=\"" << pen.getWidth() << "\" ";
+        const std::string& textAttributes(TextStyleHandle handle) {
+            const std::string& attrs = cached(textAttrs_, handle.index);
+            if (!attrs.empty()) return attrs;
 
-            if (pen.getType() == Pen::Type::DASHED) {
-                content_ << "stroke-dasharray=\"5,5\" ";
+            const TextStyle& style = StylePalette::getInstance().textStyle(handle);
+            std::ostringstream oss;
+            if (isMinified()) {
+                if (style.anchor == TextAnchor::MIDDLE) {
+                    oss << " text-anchor=\"middle\"";
+                }
+                oss << " dominant-baseline=\"middle\"";
+                oss << " font-family=\"" << style.fontFamily << "\"";
+                oss << " font-size=\"" << style.fontSize << "\"";
+                if (style.color != Color()) {
+                    oss << " fill=\"" << style.color.toShortString() << "\"";
+                }
+                return textAttrs_[handle.index] = oss.str();
             }
-            else if (pen.getType() == Pen::Type::DOTTED) {
-                content_ << "stroke-dasharray=\"2,2\" ";
+
+            oss << "text-anchor=\"" << (style.anchor == TextAnchor::START ? "start" : "middle") << "\" ";
+            oss << "dominant-baseline=\"middle\" ";
+            oss << "font-family=\"" << style.fontFamily << "\" ";
+            oss << "font-size=\"" << style.fontSize << "\" ";
+            oss << "fill=\"" << style.color.toString() << "\"";
+            return textAttrs_[handle.index] = oss.str();
+        }
+
+        std::ostream& out() {
+            return stream_ ? *stream_ : content_;
+        }
+
+        bool isMinified() const {
+            return format_ == Format::MINIFIED;
+        }
+
+        // Up to three decimals with trailing zeros and the leading zero dropped
+        static std::string shortNumber(float value) {
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "%.3f", value);
+            std::string text = buffer;
+            while (!text.empty() && text.back() == '0') text.pop_back();
+            if (!text.empty() && text.back() == '.') text.pop_back();
+            if (text.size() > 1 && text[0] == '0' && text[1] == '.') text.erase(0, 1);
+            if (text.empty()) text = "0";
+            return text;
+        }
+
+        // Characters in the decimal form of value, sign included
+        static size_t digits(int value) {
+            size_t count = value < 0 ? 2 : 1;
+            unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+            while (magnitude >= 10) {
+                magnitude /= 10;
+                ++count;
             }
+            return count;
+        }
 
-            content_ << "/>\n";
+        static size_t polygonPointsLength(const int* xPoints, const int* yPoints, int numPoints) {
+            size_t length = static_cast<size_t>(numPoints) * 2 - 1;
+            for (int i = 0; i < numPoints; ++i) {
+                length += digits(xPoints[i]) + digits(yPoints[i]);
+            }
+            return length;
         }
 
-        void drawText(int x, int y, const std::string& text,
-            const std::string& fontFamily, int fontSize,
-            const std::string& color) override {
-            if (!isPainting_) return;
+        static void appendPolygonPoints(std::string& out, const int* xPoints, const int* yPoints, int numPoints) {
+            for (int i = 0; i < numPoints; ++i) {
+                if (i > 0) out += ' ';
+                out += std::to_string(xPoints[i]);
+                out += ',';
+                out += std::to_string(yPoints[i]);
+            }
+        }
 
-            content_ << "  <text x=\"" << x << "\" y=\"" << y << "\" ";
-            content_ << "text-anchor=\"middle\" dominant-baseline=\"middle\" ";
-            content_ << "font-family=\"" << fontFamily << "\" ";
-            content_ << "font-size=\"" << fontSize << "\" ";
-            content_ << "fill=\"" << color << "\">";
-            content_ << escapeXML(text);
-            content_ << "</text>\n";
+        // Appends a command letter and its numbers; a separator is only
+        // needed between two numbers when the second has no minus sign.
+        static void appendCommand(std::string& out, char command, int first) {
+            out += command;
+            out += std::to_string(first);
         }
 
-        void drawTextLeft(int x, int y, const std::string& text,
-            const std::string& fontFamily, int fontSize,
-            const std::string& color) {
-            if (!isPainting_) return;
+        static void appendCommand(std::string& out, char command, int first, int second) {
+            appendCommand(out, command, first);
+            if (second >= 0) out += ' ';
+            out += std::to_string(second);
+        }
 
-            content_ << "  <text x=\"" << x << "\" y=\"" << y << "\" ";
-            content_ << "text-anchor=\"start\" dominant-baseline=\"middle\" ";
-            content_ << "font-family=\"" << fontFamily << "\" ";
-            content_ << "font-size=\"" << fontSize << "\" ";
-            content_ << "fill=\"" << color << "\">";
-            content_ << escapeXML(text);
-            content_ << "</text>\n";
+        static size_t commandLength(int first, int second) {
+            return 1 + digits(first) + (second >= 0 ? 1 : 0) + digits(second);
         }
 
-        int getWidth() const override { return width_; }
-        int getHeight() const override { return height_; }
+        // Closed path using whichever of the absolute and relative commands is
+        // shorter at each vertex, with H/V for axis-aligned edges. Returns the
+        // length of the path data appended.
+        static size_t appendPathData(std::string& out, const int* xPoints, const int* yPoints, int numPoints) {
+            size_t start = out.size();
+            appendCommand(out, 'M', xPoints[0], yPoints[0]);
 
-        std::string getSVG() const {
-            return content_.str();
+            for (int i = 1; i < numPoints; ++i) {
+                int dx = xPoints[i] - xPoints[i - 1];
+                int dy = yPoints[i] - yPoints[i - 1];
+
+                if (dy == 0) {
+                    if (digits(dx) < digits(xPoints[i])) appendCommand(out, 'h', dx);
+                    else appendCommand(out, 'H', xPoints[i]);
+                }
+                else if (dx == 0) {
+                    if (digits(dy) < digits(yPoints[i])) appendCommand(out, 'v', dy);
+                    else appendCommand(out, 'V', yPoints[i]);
+                }
+                else if (commandLength(dx, dy) < commandLength(xPoints[i], yPoints[i])) {
+                    appendCommand(out, 'l', dx, dy);
+                }
+                else {
+                    appendCommand(out, 'L', xPoints[i], yPoints[i]);
+                }
+            }
+            out += 'z';
+            return out.size() - start;
         }
 
-    private:
         std::string escapeXML(const std::string& text) const {
             std::string result;
             for (size_t i = 0; i < text.length(); ++i) {
                 char c = text[i];
+                if (isMinified() && (c == '"' || c == '\'' || c == '>')) {
+                    result += c;
+                    continue;
+                }
                 switch (c) {
                 case '&':  result += "&amp;"; break;
                 case '<':  result += "&lt;"; break;
@@ -170,4 +410,3 @@ namespace Painting {
     };
 
 }
-
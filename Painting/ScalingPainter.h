@@ -0,0 +1,220 @@
+#pragma once
+#include "IPainter.h"
+#include "StylePalette.h"
+#include "FontMetrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Painting {
+
+    // Draws onto a base painter at a reduced scale, with cheap stand-ins for
+    // detail that would not be visible: text smaller than a few pixels becomes
+    // a grey bar, shapes smaller than the detail threshold collapse to their
+    // bounding rectangle, and anything under half a pixel is skipped.
+    //
+    // Scaled pens and text styles are interned once per handle, so this
+    // painter must not be shared between threads.
+    class ScalingPainter : public IPainter {
+    public:
+        struct LevelOfDetail {
+            double detailPixels;
+            double minTextPixels;
+            double minVisiblePixels;
+        };
+
+        static LevelOfDetail defaultLevelOfDetail() {
+            return LevelOfDetail{ 4.0, 5.0, 0.5 };
+        }
+
+    private:
+        static constexpr std::uint32_t kUnset = 0xFFFFFFFFu;
+
+        IPainter& basePainter_;
+        double scale_;
+        int offsetX_;
+        int offsetY_;
+        LevelOfDetail lod_;
+
+        std::vector<std::uint32_t> scaledPens_;
+        std::vector<std::uint32_t> scaledTextStyles_;
+        std::vector<std::uint32_t> outlineBrushes_;
+        std::vector<const FontMetrics*> textMetrics_;
+        BrushHandle textBarBrush_;
+        PenHandle noPen_;
+
+        int mapX(double x) const {
+            return offsetX_ + static_cast<int>(std::lround(x * scale_));
+        }
+
+        int mapY(double y) const {
+            return offsetY_ + static_cast<int>(std::lround(y * scale_));
+        }
+
+        static std::uint32_t& slot(std::vector<std::uint32_t>& cache, std::uint32_t index) {
+            if (index >= cache.size()) {
+                cache.resize(index + 1, kUnset);
+            }
+            return cache[index];
+        }
+
+        PenHandle scaledPen(PenHandle handle) {
+            std::uint32_t& cached = slot(scaledPens_, handle.index);
+            if (cached == kUnset) {
+                Pen pen = StylePalette::getInstance().pen(handle);
+                pen.setWidth(std::max(1, static_cast<int>(std::lround(pen.getWidth() * scale_))));
+                cached = StylePalette::getInstance().internPen(pen).index;
+            }
+            return PenHandle{ cached };
+        }
+
+        // Fill for a shape collapsed to its box: its own fill, or its outline
+        // color when it has none, so the box stays visible
+        BrushHandle collapsedBrush(PenHandle pen, BrushHandle brush) {
+            auto& palette = StylePalette::getInstance();
+            if (palette.brush(brush).getStyle() != Brush::Style::NONE) {
+                return brush;
+            }
+
+            std::uint32_t& cached = slot(outlineBrushes_, pen.index);
+            if (cached == kUnset) {
+                cached = palette.internBrush(Brush(palette.pen(pen).getColor(), Brush::Style::SOLID)).index;
+            }
+            return BrushHandle{ cached };
+        }
+
+        void drawBox(double left, double top, double right, double bottom, PenHandle pen, BrushHandle brush) {
+            int x1 = mapX(left), y1 = mapY(top);
+            int x2 = std::max(x1 + 1, mapX(right)), y2 = std::max(y1 + 1, mapY(bottom));
+            int xs[4] = { x1, x2, x2, x1 };
+            int ys[4] = { y1, y1, y2, y2 };
+            basePainter_.drawPolygon(xs, ys, 4, noPen_, collapsedBrush(pen, brush));
+        }
+
+    public:
+        ScalingPainter(IPainter& basePainter, double scale, int offsetX = 0, int offsetY = 0,
+            LevelOfDetail lod = defaultLevelOfDetail())
+            : basePainter_(basePainter), scale_(scale), offsetX_(offsetX), offsetY_(offsetY), lod_(lod) {
+            auto& palette = StylePalette::getInstance();
+            textBarBrush_ = palette.internBrush(Brush("silver", Brush::Style::SOLID));
+            noPen_ = palette.internPen(Pen(Color::none(), 0));
+        }
+
+        // Moves the origin, keeping the interned styles
+        void setOffset(int offsetX, int offsetY) {
+            offsetX_ = offsetX;
+            offsetY_ = offsetY;
+        }
+
+        double getScale() const { return scale_; }
+
+        void drawLine(int x1, int y1, int x2, int y2, PenHandle pen) override {
+            double length = std::max(std::abs(x2 - x1), std::abs(y2 - y1)) * scale_;
+            if (length < lod_.minVisiblePixels) return;
+            basePainter_.drawLine(mapX(x1), mapY(y1), mapX(x2), mapY(y2), scaledPen(pen));
+        }
+
+        void drawEllipse(int centerX, int centerY, int radiusX, int radiusY,
+            PenHandle pen, BrushHandle brush) override {
+            double size = 2.0 * std::max(radiusX, radiusY) * scale_;
+            if (size < lod_.minVisiblePixels) return;
+
+            if (size < lod_.detailPixels) {
+                drawBox(centerX - radiusX, centerY - radiusY, centerX + radiusX, centerY + radiusY, pen, brush);
+                return;
+            }
+
+            basePainter_.drawEllipse(mapX(centerX), mapY(centerY),
+                static_cast<int>(std::lround(radiusX * scale_)), static_cast<int>(std::lround(radiusY * scale_)),
+                scaledPen(pen), brush);
+        }
+
+        void drawPolygon(const int* xPoints, const int* yPoints, int numPoints,
+            PenHandle pen, BrushHandle brush) override {
+            if (numPoints < 3) return;
+
+            int left = xPoints[0], right = xPoints[0], top = yPoints[0], bottom = yPoints[0];
+            for (int i = 1; i < numPoints; ++i) {
+                left = std::min(left, xPoints[i]);
+                right = std::max(right, xPoints[i]);
+                top = std::min(top, yPoints[i]);
+                bottom = std::max(bottom, yPoints[i]);
+            }
+
+            double size = std::max(right - left, bottom - top) * scale_;
+            if (size < lod_.minVisiblePixels) return;
+
+            if (size < lod_.detailPixels) {
+                drawBox(left, top, right, bottom, pen, brush);
+                return;
+            }
+
+            int stackX[8], stackY[8];
+            std::vector<int> heapX, heapY;
+            int* xs = stackX;
+            int* ys = stackY;
+            if (numPoints > 8) {
+                heapX.resize(numPoints);
+                heapY.resize(numPoints);
+                xs = heapX.data();
+                ys = heapY.data();
+            }
+            for (int i = 0; i < numPoints; ++i) {
+                xs[i] = mapX(xPoints[i]);
+                ys[i] = mapY(yPoints[i]);
+            }
+            basePainter_.drawPolygon(xs, ys, numPoints, scaledPen(pen), brush);
+        }
+
+        void drawText(int x, int y, const std::string& text, TextStyleHandle style) override {
+            const TextStyle& textStyle = StylePalette::getInstance().textStyle(style);
+            double fontPixels = textStyle.fontSize * scale_;
+            if (fontPixels < lod_.minVisiblePixels || textStyle.color.isNone()) return;
+
+            if (fontPixels < lod_.minTextPixels) {
+                if (style.index >= textMetrics_.size()) {
+                    textMetrics_.resize(style.index + 1, nullptr);
+                }
+                if (!textMetrics_[style.index]) {
+                    textMetrics_[style.index] = &FontMetrics::forFamily(textStyle.fontFamily);
+                }
+                double width = textMetrics_[style.index]->measure(text) * textStyle.fontSize / 1000.0;
+                double left = textStyle.anchor == TextAnchor::MIDDLE ? x - width / 2 : x;
+                double half = textStyle.fontSize * 0.3;
+
+                int x1 = mapX(left), y1 = mapY(y - half);
+                int x2 = std::max(x1 + 1, mapX(left + width)), y2 = std::max(y1 + 1, mapY(y + half));
+                int xs[4] = { x1, x2, x2, x1 };
+                int ys[4] = { y1, y1, y2, y2 };
+                basePainter_.drawPolygon(xs, ys, 4, noPen_, textBarBrush_);
+                return;
+            }
+
+            std::uint32_t& cached = slot(scaledTextStyles_, style.index);
+            if (cached == kUnset) {
+                cached = StylePalette::getInstance().internTextStyle(textStyle.fontFamily,
+                    std::max(1, static_cast<int>(std::lround(fontPixels))), textStyle.color, textStyle.anchor).index;
+            }
+            basePainter_.drawText(mapX(x), mapY(y), text, TextStyleHandle{ cached });
+        }
+
+        void beginPaint() override {
+            basePainter_.beginPaint();
+        }
+
+        void endPaint() override {
+            basePainter_.endPaint();
+        }
+
+        int getWidth() const override {
+            return basePainter_.getWidth();
+        }
+
+        int getHeight() const override {
+            return basePainter_.getHeight();
+        }
+    };
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+
+namespace Painting {
+
+    // Append-only table whose elements never move. Appends are serialized by
+    // the caller; reads of an already published index need no lock, even while
+    // another thread appends, because chunks are allocated once and never freed.
+    template <typename T>
+    class StableTable {
+        static const size_t kChunkBits = 10;
+        static const size_t kChunkSize = size_t(1) << kChunkBits;
+        static const size_t kMaxChunks = 4096;
+
+        std::array<std::atomic<T*>, kMaxChunks> chunks_;
+        std::atomic<size_t> size_;
+
+    public:
+        StableTable() : size_(0) {
+            for (auto& chunk : chunks_) chunk.store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~StableTable() {
+            for (auto& chunk : chunks_) delete[] chunk.load(std::memory_order_relaxed);
+        }
+
+        StableTable(const StableTable&) = delete;
+        StableTable& operator=(const StableTable&) = delete;
+
+        void push_back(const T& value) {
+            size_t index = size_.load(std::memory_order_relaxed);
+            size_t chunk = index >> kChunkBits;
+            if (chunk >= kMaxChunks) {
+                throw std::length_error("Intern table is full");
+            }
+            T* storage = chunks_[chunk].load(std::memory_order_relaxed);
+            if (!storage) {
+                storage = new T[kChunkSize];
+                chunks_[chunk].store(storage, std::memory_order_release);
+            }
+            storage[index & (kChunkSize - 1)] = value;
+            size_.store(index + 1, std::memory_order_release);
+        }
+
+        const T& operator[](size_t index) const {
+            return chunks_[index >> kChunkBits].load(std::memory_order_acquire)[index & (kChunkSize - 1)];
+        }
+
+        size_t size() const {
+            return size_.load(std::memory_order_acquire);
+        }
+    };
+
+}
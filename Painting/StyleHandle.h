@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+
+namespace Painting {
+
+    // Small integer handles into the StylePalette. Kept as distinct types so a
+    // pen can never be passed where a brush is expected.
+    struct PenHandle {
+        std::uint32_t index;
+    };
+
+    struct BrushHandle {
+        std::uint32_t index;
+    };
+
+    struct TextStyleHandle {
+        std::uint32_t index;
+    };
+
+    inline bool operator==(PenHandle a, PenHandle b) { return a.index == b.index; }
+    inline bool operator==(BrushHandle a, BrushHandle b) { return a.index == b.index; }
+    inline bool operator==(TextStyleHandle a, TextStyleHandle b) { return a.index == b.index; }
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include "StyleHandle.h"
+#include "StableTable.h"
+#include "Color.h"
+#include "Pen.h"
+#include "Brush.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Painting {
+
+    enum class TextAnchor {
+        MIDDLE,
+        START
+    };
+
+    struct TextStyle {
+        std::string fontFamily;
+        int fontSize;
+        Color color;
+        TextAnchor anchor;
+    };
+
+    // A pen or brush as a hash key: its color, then everything else packed
+    // into one word
+    struct StyleKey {
+        std::uint64_t color;
+        std::uint64_t rest;
+
+        bool operator==(const StyleKey& other) const {
+            return color == other.color && rest == other.rest;
+        }
+    };
+
+    struct StyleKeyHash {
+        size_t operator()(const StyleKey& key) const {
+            return std::hash<std::uint64_t>()(key.color * 0x9E3779B97F4A7C15ull ^ key.rest);
+        }
+    };
+
+    // Process-wide table of every distinct pen, brush and text style.
+    // Interning takes a lock; lookups by handle do not, and stay valid while
+    // other threads intern, so painting can run on worker threads.
+    class StylePalette {
+    private:
+        StableTable<Pen> pens_;
+        StableTable<Brush> brushes_;
+        StableTable<TextStyle> textStyles_;
+
+        std::unordered_map<StyleKey, std::uint32_t, StyleKeyHash> penIndex_;
+        std::unordered_map<StyleKey, std::uint32_t, StyleKeyHash> brushIndex_;
+        std::unordered_map<std::string, std::uint32_t> textStyleIndex_;
+
+        std::mutex mutex_;
+
+        StylePalette() = default;
+        StylePalette(const StylePalette&) = delete;
+        StylePalette& operator=(const StylePalette&) = delete;
+
+        static StyleKey penKey(const Pen& pen) {
+            return StyleKey{ pen.getColor().key(),
+                (static_cast<std::uint64_t>(static_cast<std::uint32_t>(pen.getWidth())) << 8) |
+                static_cast<std::uint64_t>(pen.getType()) };
+        }
+
+        static StyleKey brushKey(const Brush& brush) {
+            float opacity = brush.getOpacity();
+            if (opacity < 0.0f) opacity = 0.0f;
+            if (opacity > 1.0f) opacity = 1.0f;
+            std::uint64_t quantized = static_cast<std::uint64_t>(opacity * 65535.0f + 0.5f);
+            return StyleKey{ brush.getColor().key(),
+                (quantized << 8) | static_cast<std::uint64_t>(brush.getStyle()) };
+        }
+
+    public:
+        static StylePalette& getInstance() {
+            static StylePalette instance;
+            return instance;
+        }
+
+        PenHandle internPen(const Pen& pen) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto inserted = penIndex_.emplace(penKey(pen), static_cast<std::uint32_t>(pens_.size()));
+            if (inserted.second) {
+                pens_.push_back(pen);
+            }
+            return PenHandle{ inserted.first->second };
+        }
+
+        BrushHandle internBrush(const Brush& brush) {
+            // A brush without paint is the same brush whatever color it was given
+            Brush key = brush.getStyle() == Brush::Style::NONE || brush.getColor().isNone()
+                ? Brush(Color::none(), Brush::Style::NONE)
+                : brush;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto inserted = brushIndex_.emplace(brushKey(key), static_cast<std::uint32_t>(brushes_.size()));
+            if (inserted.second) {
+                brushes_.push_back(key);
+            }
+            return BrushHandle{ inserted.first->second };
+        }
+
+        TextStyleHandle internTextStyle(const std::string& fontFamily, int fontSize, Color color,
+            TextAnchor anchor = TextAnchor::MIDDLE) {
+            std::string key = fontFamily + '\x1f' + std::to_string(fontSize) + '\x1f' +
+                std::to_string(color.key()) + '\x1f' + std::to_string(static_cast<int>(anchor));
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto inserted = textStyleIndex_.emplace(key, static_cast<std::uint32_t>(textStyles_.size()));
+            if (inserted.second) {
+                textStyles_.push_back(TextStyle{ fontFamily, fontSize, color, anchor });
+            }
+            return TextStyleHandle{ inserted.first->second };
+        }
+
+        const Pen& pen(PenHandle handle) const { return pens_[handle.index]; }
+        const Brush& brush(BrushHandle handle) const { return brushes_[handle.index]; }
+        const TextStyle& textStyle(TextStyleHandle handle) const { return textStyles_[handle.index]; }
+
+        size_t penCount() const { return pens_.size(); }
+        size_t brushCount() const { return brushes_.size(); }
+        size_t textStyleCount() const { return textStyles_.size(); }
+    };
+
+}
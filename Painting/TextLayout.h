@@ -0,0 +1,327 @@
+#pragma once
+#include "FontMetrics.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Painting {
+
+    // Result of laying a label out inside a box: the font size that made it fit
+    // and the text of each line, top to bottom.
+    struct TextBlock {
+        int fontSize;
+        int lineHeight;
+        std::vector<std::string> lines;
+    };
+
+    // Word-wrapping, fit-to-box text layout with a process-wide cache of line
+    // breaks keyed by (text, font, size, box). Blocks are immutable and shared,
+    // so callers may hold on to them across renders.
+    class TextLayout {
+    public:
+        static const int kMinFontSize = 6;
+
+    private:
+        struct Key {
+            std::string text;
+            std::string fontFamily;
+            int fontSize;
+            int boxWidth;
+            int boxHeight;
+
+            bool operator==(const Key& other) const {
+                return fontSize == other.fontSize && boxWidth == other.boxWidth &&
+                    boxHeight == other.boxHeight && text == other.text && fontFamily == other.fontFamily;
+            }
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const {
+                size_t h = std::hash<std::string>()(key.text);
+                h ^= std::hash<std::string>()(key.fontFamily) + 0x9e3779b9 + (h << 6) + (h >> 2);
+                h ^= static_cast<size_t>(key.fontSize) * 0x100000001b3ull + (h << 6) + (h >> 2);
+                h ^= static_cast<size_t>(key.boxWidth) * 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+                h ^= static_cast<size_t>(key.boxHeight) + (h << 6) + (h >> 2);
+                return h;
+            }
+        };
+
+        typedef std::pair<size_t, size_t> Span;
+
+        static const size_t kMaxEntries = 1 << 18;
+
+        std::unordered_map<Key, std::shared_ptr<const TextBlock>, KeyHash> cache_;
+        mutable std::mutex mutex_;
+        size_t hits_;
+        size_t misses_;
+        size_t bytes_;
+
+        TextLayout() : hits_(0), misses_(0), bytes_(0) {}
+        TextLayout(const TextLayout&) = delete;
+        TextLayout& operator=(const TextLayout&) = delete;
+
+        // A cache node with its key and block, and the text they hold
+        static size_t entryBytes(const Key& key, const TextBlock& block) {
+            size_t bytes = sizeof(Key) + 2 * sizeof(void*) + sizeof(std::shared_ptr<const TextBlock>) +
+                sizeof(TextBlock) + key.text.capacity() + key.fontFamily.capacity() +
+                block.lines.capacity() * sizeof(std::string);
+            for (const std::string& line : block.lines) bytes += line.capacity();
+            return bytes;
+        }
+
+        static int lineHeightFor(int fontSize) {
+            return (fontSize * 6 + 4) / 5;
+        }
+
+        static void splitWord(const std::string& text, size_t begin, size_t end,
+            const FontMetrics& metrics, long limit, std::vector<Span>& lines) {
+            size_t lineBegin = begin;
+            long units = 0;
+            for (size_t i = begin; i < end; ++i) {
+                unsigned char c = static_cast<unsigned char>(text[i]);
+                int advance = metrics.advance(c);
+                bool isLead = (c & 0xC0) != 0x80;
+                if (isLead && i > lineBegin && units + advance > limit) {
+                    lines.push_back(Span(lineBegin, i));
+                    lineBegin = i;
+                    units = 0;
+                }
+                units += advance;
+            }
+            lines.push_back(Span(lineBegin, end));
+        }
+
+        // A word, measured once so that wrapping at each candidate font size
+        // only compares integers. An empty paragraph is a token with no text.
+        struct Token {
+            size_t begin;
+            size_t end;
+            long units;
+            long gapUnits;
+            bool startsParagraph;
+        };
+
+        static std::vector<Token> tokenize(const std::string& text, const FontMetrics& metrics) {
+            std::vector<Token> tokens;
+            size_t paragraphBegin = 0;
+
+            while (paragraphBegin <= text.size()) {
+                size_t paragraphEnd = text.find('\n', paragraphBegin);
+                if (paragraphEnd == std::string::npos) paragraphEnd = text.size();
+
+                bool first = true;
+                size_t previousEnd = paragraphBegin;
+                size_t pos = paragraphBegin;
+                while (pos < paragraphEnd) {
+                    size_t wordBegin = pos;
+                    while (wordBegin < paragraphEnd && text[wordBegin] == ' ') ++wordBegin;
+                    if (wordBegin >= paragraphEnd) break;
+                    size_t wordEnd = wordBegin;
+                    while (wordEnd < paragraphEnd && text[wordEnd] != ' ') ++wordEnd;
+
+                    tokens.push_back(Token{ wordBegin, wordEnd, metrics.measure(text, wordBegin, wordEnd),
+                        first ? 0 : metrics.measure(text, previousEnd, wordBegin), first });
+                    first = false;
+                    previousEnd = wordEnd;
+                    pos = wordEnd;
+                }
+
+                if (first) {
+                    tokens.push_back(Token{ paragraphBegin, paragraphBegin, 0, 0, true });
+                }
+                paragraphBegin = paragraphEnd + 1;
+            }
+            return tokens;
+        }
+
+        // Greedy line breaking at a width limit given in 1/1000 em units.
+        static std::vector<Span> wrap(const std::string& text, const std::vector<Token>& tokens,
+            const FontMetrics& metrics, long limit) {
+            std::vector<Span> lines;
+            bool open = false;
+            Span line(0, 0);
+            long lineUnits = 0;
+
+            for (const Token& token : tokens) {
+                if (open && !token.startsParagraph && lineUnits + token.gapUnits + token.units <= limit) {
+                    line.second = token.end;
+                    lineUnits += token.gapUnits + token.units;
+                    continue;
+                }
+
+                if (open) {
+                    lines.push_back(line);
+                }
+
+                if (token.units > limit) {
+                    splitWord(text, token.begin, token.end, metrics, limit, lines);
+                    line = lines.back();
+                    lines.pop_back();
+                    lineUnits = metrics.measure(text, line.first, line.second);
+                }
+                else {
+                    line = Span(token.begin, token.end);
+                    lineUnits = token.units;
+                }
+                open = true;
+            }
+
+            if (open) {
+                lines.push_back(line);
+            }
+            return lines;
+        }
+
+        static long limitFor(int boxWidth, int fontSize) {
+            return boxWidth > 0 ? static_cast<long>(boxWidth) * 1000 / fontSize : 0x7FFFFFFFL;
+        }
+
+        static std::string truncateWithEllipsis(const std::string& line, const FontMetrics& metrics, long limit) {
+            static const std::string ellipsis = "...";
+            long units = metrics.measure(ellipsis);
+            size_t end = 0;
+            while (end < line.size()) {
+                size_t next = end + 1;
+                while (next < line.size() && (static_cast<unsigned char>(line[next]) & 0xC0) == 0x80) ++next;
+                long advance = metrics.measure(line, end, next);
+                if (units + advance > limit) break;
+                units += advance;
+                end = next;
+            }
+            return line.substr(0, end) + ellipsis;
+        }
+
+    public:
+        static TextLayout& getInstance() {
+            static TextLayout instance;
+            return instance;
+        }
+
+        // Lays text out without touching the cache. A non-positive box dimension
+        // disables wrapping (width) or fitting (height) in that direction.
+        static TextBlock compute(const std::string& text, const std::string& fontFamily,
+            int fontSize, int boxWidth, int boxHeight) {
+            const FontMetrics& metrics = FontMetrics::forFamily(fontFamily);
+            if (fontSize < kMinFontSize) fontSize = kMinFontSize;
+
+            std::vector<Token> tokens = tokenize(text, metrics);
+            auto fits = [&](int size, std::vector<Span>& spans) {
+                spans = wrap(text, tokens, metrics, limitFor(boxWidth, size));
+                return boxHeight <= 0 || static_cast<long>(spans.size()) * lineHeightFor(size) <= boxHeight;
+            };
+
+            // Line count only grows with the font size, so search for the
+            // largest size that fits instead of stepping down one at a time
+            std::vector<Span> spans;
+            int size = fontSize;
+            bool fitted = fits(size, spans);
+            if (!fitted) {
+                std::vector<Span> candidate;
+                int low = kMinFontSize, high = fontSize - 1;
+                int best = 0;
+                while (low <= high) {
+                    int mid = (low + high) / 2;
+                    if (fits(mid, candidate)) {
+                        best = mid;
+                        spans.swap(candidate);
+                        low = mid + 1;
+                    }
+                    else {
+                        high = mid - 1;
+                    }
+                }
+                if (best > 0) {
+                    size = best;
+                    fitted = true;
+                }
+                else {
+                    size = kMinFontSize;
+                    fits(size, spans);
+                }
+            }
+
+            TextBlock block;
+            block.fontSize = size;
+            block.lineHeight = lineHeightFor(block.fontSize);
+            block.lines.reserve(spans.size());
+            for (const Span& span : spans) {
+                block.lines.push_back(text.substr(span.first, span.second - span.first));
+            }
+
+            // Even the smallest size overflows: keep what fits and mark the cut
+            if (!fitted && boxHeight > 0) {
+                size_t maxLines = static_cast<size_t>(boxHeight / block.lineHeight);
+                if (maxLines == 0) maxLines = 1;
+                if (block.lines.size() > maxLines) {
+                    block.lines.resize(maxLines);
+                    block.lines.back() = truncateWithEllipsis(block.lines.back(), metrics, limitFor(boxWidth, size));
+                }
+            }
+            return block;
+        }
+
+        std::shared_ptr<const TextBlock> layout(const std::string& text, const std::string& fontFamily,
+            int fontSize, int boxWidth, int boxHeight) {
+            Key key{ text, fontFamily, fontSize, boxWidth, boxHeight };
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = cache_.find(key);
+                if (it != cache_.end()) {
+                    ++hits_;
+                    return it->second;
+                }
+                ++misses_;
+            }
+
+            auto block = std::make_shared<const TextBlock>(compute(text, fontFamily, fontSize, boxWidth, boxHeight));
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (cache_.size() >= kMaxEntries) {
+                cache_.clear();
+                bytes_ = 0;
+            }
+            size_t bytes = entryBytes(key, *block);
+            if (cache_.emplace(std::move(key), block).second) {
+                bytes_ += bytes;
+            }
+            return block;
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cache_.clear();
+            hits_ = 0;
+            misses_ = 0;
+            bytes_ = 0;
+        }
+
+        // Read under the lock, as render threads may be laying text out
+        size_t size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return cache_.size();
+        }
+
+        size_t hits() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return hits_;
+        }
+
+        size_t misses() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return misses_;
+        }
+
+        // Approximate memory held by the cached layouts, kept as they are
+        // added
+        size_t byteCount() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return bytes_;
+        }
+    };
+
+}
@@ -1,7 +1,5 @@
 #pragma once
 #include "IPainter.h"
-#include "Pen.h"
-#include "Brush.h"
 #include <vector>
 
 namespace Painting {
@@ -17,17 +15,17 @@ namespace Painting {
             : basePainter_(basePainter), offsetX_(offsetX), offsetY_(offsetY) {
         }
 
-        void drawLine(int x1, int y1, int x2, int y2, const Pen& pen) override {
+        void drawLine(int x1, int y1, int x2, int y2, PenHandle pen) override {
             basePainter_.drawLine(x1 + offsetX_, y1 + offsetY_, x2 + offsetX_, y2 + offsetY_, pen);
         }
 
         void drawEllipse(int centerX, int centerY, int radiusX, int radiusY,
-            const Pen& pen, const Brush& brush) override {
+            PenHandle pen, BrushHandle brush) override {
             basePainter_.drawEllipse(centerX + offsetX_, centerY + offsetY_, radiusX, radiusY, pen, brush);
         }
 
         void drawPolygon(const int* xPoints, const int* yPoints, int numPoints,
-            const Pen& pen, const Brush& brush) override {
+            PenHandle pen, BrushHandle brush) override {
 
             std::vector<int> transformedX(numPoints);
             std::vector<int> transformedY(numPoints);
@@ -38,10 +36,8 @@ namespace Painting {
             basePainter_.drawPolygon(transformedX.data(), transformedY.data(), numPoints, pen, brush);
         }
 
-        void drawText(int x, int y, const std::string& text,
-            const std::string& fontFamily, int fontSize,
-            const std::string& color) override {
-            basePainter_.drawText(x + offsetX_, y + offsetY_, text, fontFamily, fontSize, color);
+        void drawText(int x, int y, const std::string& text, TextStyleHandle style) override {
+            basePainter_.drawText(x + offsetX_, y + offsetY_, text, style);
         }
 
         void beginPaint() override {
@@ -62,4 +58,3 @@ namespace Painting {
     };
 
 }
-
@@ -1,32 +1,67 @@
 #pragma once
 #include "IDeserialize.h"
-#include "../Model/Shapes.h"
-#include "../Model/TextShape.h"
+#include "../Model/ShapeRecord.h"
+#include "../Model/Slide.h"
+#include <cstdint>
 #include <fstream>
 #include <sstream>
+#include <vector>
 
 namespace Serialization {
 
     class JsonDeserialize : public IDeserialize {
     public:
         std::unique_ptr<Model::Presentation> load(const std::string& filename) const override {
-            std::ifstream in(filename);
+            std::string content = readFile(filename);
+
+            auto presentation = std::make_unique<Model::Presentation>(parseTitle(content));
+            for (const std::string& slideJson : splitSlides(content)) {
+                presentation->addSlide(parseSlide(slideJson, presentation->arena()));
+            }
+
+            return presentation;
+        }
+
+        static std::string readFile(const std::string& filename) {
+            std::ifstream in(filename, std::ios::binary);
             if (!in) {
                 throw std::runtime_error("Cannot open file for reading: " + filename);
             }
 
-            std::string content((std::istreambuf_iterator<char>(in)),
+            return std::string((std::istreambuf_iterator<char>(in)),
                                std::istreambuf_iterator<char>());
+        }
 
-            std::string title = extractString(content, "\"title\"");
-            auto presentation = std::make_unique<Model::Presentation>(title);
+        // The pieces of load(), for callers that reparse only the slides
+        // whose text changed
+        std::string parseTitle(const std::string& content) const {
+            return extractString(content, "\"title\"");
+        }
 
+        std::vector<std::string> splitSlides(const std::string& content) const {
+            std::vector<std::string> slides;
             size_t slidesStart = content.find("\"slides\"");
             if (slidesStart != std::string::npos) {
-                parseSlides(content, slidesStart, *presentation);
+                splitObjects(content, slidesStart, slides);
             }
+            return slides;
+        }
 
-            return presentation;
+        std::unique_ptr<Model::Slide> parseSlide(const std::string& slideJson,
+            const std::shared_ptr<Model::Arena>& arena = nullptr) const {
+            auto slide = std::make_unique<Model::Slide>(arena);
+
+            size_t shapesStart = slideJson.find("\"shapes\"");
+            if (shapesStart != std::string::npos) {
+                std::vector<std::string> shapes;
+                splitObjects(slideJson, shapesStart, shapes);
+                slide->reserveShapes(shapes.size());
+                for (const std::string& shapeJson : shapes) {
+                    parseShape(shapeJson, *slide);
+                }
+            }
+
+            return slide;
         }
 
     private:
@@ -70,72 +105,43 @@ namespace Serialization {
             return oss.str();
         }
 
-        void parseSlides(const std::string& json, size_t startPos, Model::Presentation& presentation) const {
-
+        // The top-level objects of the first array after startPos
+        void splitObjects(const std::string& json, size_t startPos, std::vector<std::string>& objects) const {
             size_t bracketPos = json.find('[', startPos);
             if (bracketPos == std::string::npos) return;
 
             size_t pos = bracketPos + 1;
             int depth = 1;
-            size_t slideStart = pos;
+            size_t objectStart = pos;
 
             while (pos < json.length() && depth > 0) {
+                if (depth == 1 && json[pos] == '{') objectStart = pos;
+
                 if (json[pos] == '[' || json[pos] == '{') depth++;
                 else if (json[pos] == ']' || json[pos] == '}') depth--;
 
                 if (depth == 1 && json[pos] == '}') {
-
-                    std::string slideJson = json.substr(slideStart, pos - slideStart + 1);
-                    parseSlide(slideJson, presentation);
-                    slideStart = pos + 1;
-
-                    while (slideStart < json.length() && (json[slideStart] == ',' || json[slideStart] == ' ' || json[slideStart] == '\n')) {
-                        slideStart++;
-                    }
+                    objects.push_back(json.substr(objectStart, pos - objectStart + 1));
                 }
                 pos++;
             }
         }
 
-        void parseSlide(const std::string& slideJson, Model::Presentation& presentation) const {
-            auto slide = std::make_unique<Model::Slide>();
-
-            size_t shapesStart = slideJson.find("\"shapes\"");
-            if (shapesStart != std::string::npos) {
-                parseShapes(slideJson, shapesStart, *slide);
-            }
-
-            presentation.addSlide(std::move(slide));
-        }
-
-        void parseShapes(const std::string& json, size_t startPos, Model::Slide& slide) const {
-            size_t bracketPos = json.find('[', startPos);
-            if (bracketPos == std::string::npos) return;
-
-            size_t pos = bracketPos + 1;
-            int depth = 1;
-            size_t shapeStart = pos;
-
-            while (pos < json.length() && depth > 0) {
-                if (json[pos] == '[' || json[pos] == '{') depth++;
-                else if (json[pos] == ']' || json[pos] == '}') depth--;
-
-                if (depth == 1 && json[pos] == '}') {
-
-                    std::string shapeJson = json.substr(shapeStart, pos - shapeStart + 1);
-                    parseShape(shapeJson, slide);
-                    shapeStart = pos + 1;
-
-                    while (shapeStart < json.length() && (json[shapeStart] == ',' || json[shapeStart] == ' ' || json[shapeStart] == '\n')) {
-                        shapeStart++;
-                    }
+        // Adds the shape, or the group and its members, on top; returns its
+        // id, or 0 if nothing was added
+        std::uint64_t parseShape(const std::string& shapeJson, Model::Slide& slide) const {
+            std::string type = extractString(shapeJson, "\"type\"");
+            if (type == "Group") {
+                std::vector<std::string> members;
+                splitObjects(shapeJson, shapeJson.find("\"shapes\""), members);
+                std::vector<std::uint64_t> ids;
+                for (const std::string& memberJson : members) {
+                    std::uint64_t id = parseShape(memberJson, slide);
+                    if (id != 0) ids.push_back(id);
                 }
-                pos++;
+                return ids.empty() ? 0 : slide.groupShapes(ids);
             }
-        }
 
-        void parseShape(const std::string& shapeJson, Model::Slide& slide) const {
-            std::string type = extractString(shapeJson, "\"type\"");
             int x = extractInt(shapeJson, "\"x\"");
             int y = extractInt(shapeJson, "\"y\"");
             int width = extractInt(shapeJson, "\"width\"");
@@ -146,33 +152,19 @@ namespace Serialization {
             std::string text = extractString(shapeJson, "\"text\"");
 
             Model::BoundingBox bounds(x, y, width, height);
-            std::unique_ptr<Model::IShape> shape;
-
-            if (type == "Rectangle") {
-                shape = std::make_unique<Model::Rectangle>(bounds, color, fillColor, text);
-            }
-            else if (type == "Circle") {
-                shape = std::make_unique<Model::Circle>(bounds, color, fillColor, text);
-            }
-            else if (type == "Triangle") {
-                shape = std::make_unique<Model::Triangle>(bounds, color, fillColor, text);
-            }
-            else if (type == "Trapezoid") {
-                shape = std::make_unique<Model::Trapezoid>(bounds, color, fillColor, text);
-            }
-            else if (type == "Parallelogram") {
-                shape = std::make_unique<Model::Parallelogram>(bounds, color, fillColor, text);
-            }
-            else if (type == "Rhombus") {
-                shape = std::make_unique<Model::Rhombus>(bounds, color, fillColor, text);
-            }
-            else if (type == "Text") {
-                shape = std::make_unique<Model::TextShape>(bounds, text, color);
+            Model::ShapeKind kind;
+            if (!Model::ShapeRecord::kindFromType(type, kind)) {
+                return 0;
             }
 
-            if (shape) {
-                slide.addShape(std::move(shape));
+            if (kind == Model::ShapeKind::TEXT) {
+                std::string fontFamily = extractString(shapeJson, "\"fontFamily\"");
+                int fontSize = extractInt(shapeJson, "\"fontSize\"");
+                if (fontFamily.empty()) fontFamily = "Arial";
+                if (fontSize <= 0) fontSize = 14;
+                return slide.addShape(bounds, Model::ShapeRecord::makeText(text, color, fontFamily, fontSize));
             }
+            return slide.addShape(bounds, Model::ShapeRecord(kind, color, fillColor, text));
         }
 
         int extractInt(const std::string& json, const std::string& key) const {
@@ -1,5 +1,6 @@
 #pragma once
 #include "ISerialize.h"
+#include "../Model/ShapeRecord.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -13,7 +14,10 @@ namespace Serialization {
             if (!out) {
                 throw std::runtime_error("Cannot open file for writing: " + filename);
             }
+            write(presentation, out);
+        }
 
+        void write(const Model::Presentation& presentation, std::ostream& out) const {
             out << "{\n";
             out << "  \"title\": \"" << escapeJson(presentation.title()) << "\",\n";
             out << "  \"slides\": [\n";
@@ -24,13 +28,9 @@ namespace Serialization {
                 out << "    {\n";
                 out << "      \"shapes\": [\n";
 
-                const auto& shapes = slide->getShapes();
-                for (size_t j = 0; j < shapes.size(); ++j) {
-                    out << "        " << serializeShape(shapes[j].get());
-                    if (j < shapes.size() - 1) {
-                        out << ",";
-                    }
-                    out << "\n";
+                // Back to front, so loading restores the z-order
+                if (slide->shapeCount() > 0) {
+                    writeMembers(*slide, Model::Slide::npos, slide->bottomShape(), slide->topShape(), "        ", out);
                 }
 
                 out << "      ]\n";
@@ -61,28 +61,55 @@ namespace Serialization {
             return result;
         }
 
-        std::string serializeShape(const Model::IShape* shape) const {
-            if (!shape) return "null";
+        // The members of group, npos for the slide itself, whose shapes run
+        // from bottom to top in the z-order; a nested group is written as
+        // an object of type Group holding its own members
+        void writeMembers(const Model::Slide& slide, size_t group, size_t bottom, size_t top,
+            const std::string& indent, std::ostream& out) const {
+            for (size_t j = bottom; ; j = slide.shapeAbove(j)) {
+                size_t child = slide.childGroup(group, j);
+                out << indent;
+                if (child == Model::Slide::npos) {
+                    writeShape(slide.getShapes()[j], slide.shapeBounds(j), indent, out);
+                }
+                else {
+                    out << "{\n";
+                    out << indent << "  \"type\": \"Group\",\n";
+                    out << indent << "  \"shapes\": [\n";
+                    writeMembers(slide, child, j, slide.groupTop(child), indent + "    ", out);
+                    out << indent << "  ]\n";
+                    out << indent << "}";
+                    j = slide.groupTop(child);
+                }
+                if (j != top) {
+                    out << ",";
+                }
+                out << "\n";
+                if (j == top) break;
+            }
+        }
 
-            std::ostringstream oss;
-            Model::BoundingBox bounds = shape->getBoundingBox();
+        void writeShape(const Model::ShapeRecord& shape, const Model::BoundingBox& bounds,
+            const std::string& indent, std::ostream& out) const {
+            out << "{\n";
+            out << indent << "  \"type\": \"" << Model::ShapeRecord::typeName(shape.kind()) << "\",\n";
+            out << indent << "  \"x\": " << bounds.getX() << ",\n";
+            out << indent << "  \"y\": " << bounds.getY() << ",\n";
+            out << indent << "  \"width\": " << bounds.getWidth() << ",\n";
+            out << indent << "  \"height\": " << bounds.getHeight() << ",\n";
+            out << indent << "  \"color\": \"" << escapeJson(shape.color()) << "\",\n";
+            out << indent << "  \"fillColor\": \"" << escapeJson(shape.fillColor()) << "\"";
 
-            oss << "{\n";
-            oss << "          \"type\": \"" << shape->getType() << "\",\n";
-            oss << "          \"x\": " << bounds.getX() << ",\n";
-            oss << "          \"y\": " << bounds.getY() << ",\n";
-            oss << "          \"width\": " << bounds.getWidth() << ",\n";
-            oss << "          \"height\": " << bounds.getHeight() << ",\n";
-            oss << "          \"color\": \"" << escapeJson(shape->getColor()) << "\",\n";
-            oss << "          \"fillColor\": \"" << escapeJson(shape->getFillColor()) << "\"";
+            if (!shape.text().empty()) {
+                out << ",\n" << indent << "  \"text\": \"" << escapeJson(shape.text()) << "\"";
+            }
 
-            std::string text = shape->getText();
-            if (!text.empty()) {
-                oss << ",\n          \"text\": \"" << escapeJson(text) << "\"";
+            if (shape.kind() == Model::ShapeKind::TEXT) {
+                out << ",\n" << indent << "  \"fontFamily\": \"" << escapeJson(shape.fontFamily()) << "\"";
+                out << ",\n" << indent << "  \"fontSize\": " << shape.fontSize();
             }
 
-            oss << "\n        }";
-            return oss.str();
+            out << "\n" << indent << "}";
         }
     };
 
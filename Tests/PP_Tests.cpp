@@ -0,0 +1,135 @@
+#include "../Application/Application.h"
+#include "../Controller/TransformShapesCommand.h"
+#include "../Model/Presentation.h"
+#include "../Model/ShapeGeometry.h"
+#include "../Model/ShapeRecord.h"
+#include <climits>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Checks of edge cases that are awkward to reach from the command line. Each
+// failed check is printed; the exit code is the number of failures.
+namespace {
+    int failures = 0;
+
+    void check(bool condition, const char* what, int line) {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED line %d: %s\n", line, what);
+            ++failures;
+        }
+    }
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+    // Loads a one-slide deck holding the given boxes as rectangles
+    void loadDeck(const std::vector<Model::BoundingBox>& boxes) {
+        auto presentation = std::make_unique<Model::Presentation>("Limits");
+        auto slide = presentation->makeSlide();
+        for (const Model::BoundingBox& box : boxes) {
+            slide->addShape(box, Model::ShapeRecord(Model::ShapeKind::RECTANGLE, "black", "none", ""));
+        }
+        presentation->addSlide(std::move(slide));
+        Application::Application::getInstance().setPresentation(std::move(presentation));
+    }
+
+    Model::BoundingBox boundsOf(size_t index) {
+        return Model::Model::getInstance().getPresentation()->getSlide(0)->shapeBounds(index);
+    }
+
+    bool sameBox(const Model::BoundingBox& a, const Model::BoundingBox& b) {
+        return a.getX() == b.getX() && a.getY() == b.getY() && a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight();
+    }
+
+    // Runs a command line through its factory; false if the factory rejects it
+    template <typename Factory>
+    bool run(const std::vector<std::string>& args) {
+        Factory factory;
+        std::unique_ptr<Controller::ICommand> command;
+        try {
+            command = factory.createCommand(args);
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+        command->execute();
+        return command->isUndoable();
+    }
+
+    void testTranslateLimits() {
+        const Model::BoundingBox nearRight(INT_MAX - 100, 0, 50, 50);
+        loadDeck({ nearRight, Model::BoundingBox(0, 0, 10, 10) });
+
+        // The right edge would pass INT_MAX: rejected, nothing moves
+        CHECK(!run<Controller::TranslateShapesFactory>({ "translate_shapes", "-dx", "60" }));
+        CHECK(sameBox(boundsOf(0), nearRight));
+        CHECK(!run<Controller::TranslateShapesFactory>({ "translate_shapes", "-dx", "2147483647" }));
+        CHECK(!run<Controller::TranslateShapesFactory>({ "translate_shapes", "-dy", "2147483647" }));
+        CHECK(sameBox(boundsOf(1), Model::BoundingBox(0, 0, 10, 10)));
+
+        // Up to the edge is fine
+        CHECK(run<Controller::TranslateShapesFactory>({ "translate_shapes", "-dx", "50" }));
+        CHECK(boundsOf(0).getX() == INT_MAX - 50 && boundsOf(0).getRight() == INT_MAX);
+
+        // A region that leaves out the shape at the edge lets the others move
+        CHECK(run<Controller::TranslateShapesFactory>({ "translate_shapes", "-dx", "1000", "-region", "0", "0", "100", "20" }));
+        CHECK(boundsOf(1).getX() == 1050);
+        CHECK(boundsOf(0).getX() == INT_MAX - 50);
+    }
+
+    void testScaleLimits() {
+        const Model::BoundingBox box(100, 100, 200, 100);
+        loadDeck({ box });
+
+        CHECK(!run<Controller::ScaleShapesFactory>({ "scale_shapes", "-factor", "1e10" }));
+        CHECK(!run<Controller::ScaleShapesFactory>({ "scale_shapes", "-factor", "inf" }));
+        CHECK(!run<Controller::ScaleShapesFactory>({ "scale_shapes", "-fx", "2", "-fy", "inf" }));
+        CHECK(!run<Controller::ScaleShapesFactory>({ "scale_shapes", "-factor", "nan" }));
+        CHECK(!run<Controller::ScaleShapesFactory>({ "scale_shapes", "-factor", "0" }));
+        CHECK(!run<Controller::ScaleShapesFactory>({ "scale_shapes", "-factor", "2", "-origin", "-2147483648", "0" }));
+        CHECK(sameBox(boundsOf(0), box));
+
+        // The largest factor that keeps the right edge in range
+        CHECK(run<Controller::ScaleShapesFactory>({ "scale_shapes", "-fx", "7158278", "-fy", "1" }));
+        CHECK(boundsOf(0).getX() == 715827800 && boundsOf(0).getRight() == 2147483400);
+        CHECK(boundsOf(0).getHeight() == 100);
+
+        // Scaling down to nothing collapses sizes without going negative
+        CHECK(run<Controller::ScaleShapesFactory>({ "scale_shapes", "-factor", "1e-300" }));
+        CHECK(boundsOf(0).getWidth() == 0 && boundsOf(0).getHeight() == 0);
+    }
+
+    // Callers that skip canTranslate() and canScale() get results clamped
+    // to the int range rather than wrapped around
+    void testGeometrySaturates() {
+        Model::ShapeGeometry geometry;
+        geometry.push_back(Model::BoundingBox(INT_MAX - 10, INT_MIN + 10, 5, 5));
+
+        CHECK(!geometry.canTranslate(100, 0));
+        geometry.translate(100, -100);
+        CHECK(geometry.xs()[0] == INT_MAX && geometry.ys()[0] == INT_MIN);
+
+        geometry.translateAt(0, INT_MIN, INT_MAX);
+        CHECK(geometry.xs()[0] == -1 && geometry.ys()[0] == -1);
+
+        CHECK(!geometry.canScale(1e300, 1e300, 0, 0));
+        geometry.scale(1e300, 1e300, 0, 0);
+        CHECK(geometry.xs()[0] == INT_MIN && geometry.ys()[0] == INT_MIN);
+        CHECK(geometry.widths()[0] == INT_MAX && geometry.heights()[0] == INT_MAX);
+    }
+}
+
+int main() {
+    testTranslateLimits();
+    testScaleLimits();
+    testGeometrySaturates();
+
+    if (failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return failures;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}
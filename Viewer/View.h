@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <utility>
 
@@ -72,13 +74,58 @@ namespace View {
             std::cout << "      -coord <x> <y>                      - Position (default: 0,0)\n";
             std::cout << "      -size <width> <height>              - Size (default: 100x50)\n";
             std::cout << "      -color <color>                      - Text color (default: black)\n";
+            std::cout << "      -font <family>                      - Font family (default: Arial)\n";
+            std::cout << "      -font_size <size>                   - Largest font size; long text shrinks and wraps to fit (default: 14)\n";
             std::cout << "      -slide <index>                      - Target slide (default: 0)\n";
             std::cout << "      -front                              - Place on top layer\n";
             std::cout << "    Example:\n";
-            std::cout << "      add_text -text \"Hello\" -coord 50 50 -size 200 50 -color blue\n\n";
+            std::cout << "      add_text -text \"Hello\" -coord 50 50 -size 200 50 -color blue\n";
+            std::cout << "  remove_shape <id>                       - Remove the shape with this id (ids are listed by show)\n";
+            std::cout << "  move_shape <id> -dx <dx> -dy <dy>       - Move one shape\n";
+            std::cout << "  group <id> <id> [<id> ...]              - Group shapes or groups of one slide into a new group\n";
+            std::cout << "  ungroup <id>                            - Dissolve a group, keeping its shapes\n";
+            std::cout << "  clone_group <id> [-dx <dx>] [-dy <dy>]  - Copy a group onto the top of its slide\n";
+            std::cout << "    A group id works wherever a shape id does: the group is moved, restacked or\n";
+            std::cout << "    removed as one. A grouped shape or group restacks among its group's members.\n";
+            std::cout << "  bring_to_front <id>                     - Draw the shape over all others\n";
+            std::cout << "  send_to_back <id>                       - Draw the shape under all others\n";
+            std::cout << "  raise <id>                              - Move the shape one layer up\n";
+            std::cout << "  lower <id>                              - Move the shape one layer down\n";
+            std::cout << "  translate_shapes -dx <dx> -dy <dy> [options] - Move shapes on every slide, or a selection\n";
+            std::cout << "  scale_shapes -factor <f> [options]      - Scale shapes' positions and sizes\n";
+            std::cout << "    Options:\n";
+            std::cout << "      -slide <index>                      - Only this slide (default: all slides)\n";
+            std::cout << "      -region <x> <y> <width> <height>    - Only shapes overlapping this area\n";
+            std::cout << "      -fx <f> / -fy <f>                   - Separate horizontal and vertical factors (scale_shapes)\n";
+            std::cout << "      -origin <x> <y>                     - Fixed point of the scaling (default: 0,0)\n";
+            std::cout << "  pick -slide <index> <x> <y>             - Topmost shape under a point\n";
+            std::cout << "  select -slide <index> -region <x> <y> <width> <height> [-inside]\n";
+            std::cout << "                                          - Shapes overlapping an area, or with -inside wholly in it\n\n";
 
             std::cout << "RENDERING:\n";
-            std::cout << "  render <output.svg> [-slide <index>]   - Render to SVG (respects Z-order)\n";
+            std::cout << "  render <output.svg> [options]           - Render to SVG (respects Z-order)\n";
+            std::cout << "    Options:\n";
+            std::cout << "      -slide <index>                      - Render a single slide\n";
+            std::cout << "      -minify                             - Compact output without whitespace or default attributes\n";
+            std::cout << "      -threads <count>                    - Worker threads (default: one per core)\n";
+            std::cout << "  render <output.html> -pages <n> [options] - Render as HTML pages of <n> slides each\n";
+            std::cout << "  render -split <dir> [options]           - Render each slide to <dir>/slide_NNNN.svg with a manifest.json\n";
+            std::cout << "  export_html <output.html> [options]     - Export an HTML slideshow with one SVG per slide\n";
+            std::cout << "    Options:\n";
+            std::cout << "      -eager <count>                      - Slides inlined up front; the rest load on scroll (default: 3)\n";
+            std::cout << "      -minify                             - Compact SVG output\n";
+            std::cout << "  export_pdf <output.pdf>                 - Export a PDF with one page per slide\n";
+            std::cout << "  render_thumbnails <output.svg> [options] - Render all slides as a grid of thumbnails\n";
+            std::cout << "    Options:\n";
+            std::cout << "      -cols <count>                       - Thumbnails per row (default: 10)\n";
+            std::cout << "      -scale <factor>                     - Thumbnail scale, at most 1 (default: 0.1)\n";
+            std::cout << "      -minify                             - Compact SVG output\n";
+            std::cout << "  watch -path <file.json> -out <dir> [options] - Re-render changed slides to <dir> on every save\n";
+            std::cout << "    Options:\n";
+            std::cout << "      -debounce <ms>                      - Quiet time before a save is picked up (default: 50)\n";
+            std::cout << "      -cycles <count>                     - Stop after this many saves (default: until the file is deleted)\n";
+            std::cout << "      -minify                             - Compact SVG output\n";
+            std::cout << "      -threads <count>                    - Worker threads (default: one per core)\n";
             std::cout << "  show                                    - Display in console (sorted by Z-order)\n\n";
 
             std::cout << "HISTORY:\n";
@@ -86,6 +133,7 @@ namespace View {
             std::cout << "  redo                                    - Redo undone operation\n\n";
 
             std::cout << "OTHER:\n";
+            std::cout << "  stats                                   - Show memory use by category\n";
             std::cout << "  help                                    - Show this help\n";
             std::cout << "  exit                                    - Exit program\n\n";
 
@@ -94,6 +142,40 @@ namespace View {
             std::cout << "      Files are saved/loaded in JSON format.\n\n";
         }
 
+        // "512 B", "3.4 KB", "12.0 MB"
+        static std::string formatBytes(long long bytes) {
+            static const char* const units[] = { "B", "KB", "MB", "GB" };
+            double value = static_cast<double>(bytes);
+            size_t unit = 0;
+            while (unit + 1 < 4 && (value >= 1024 || value <= -1024)) {
+                value /= 1024;
+                ++unit;
+            }
+            std::ostringstream oss;
+            if (unit == 0) oss << bytes << " B";
+            else oss << std::fixed << std::setprecision(1) << value << " " << units[unit];
+            return oss.str();
+        }
+
+        // Rows of (label, bytes), then their total
+        void showMemoryStats(const std::vector<std::pair<std::string, long long>>& rows) const {
+            long long total = 0;
+            for (size_t i = 0; i < rows.size(); ++i) {
+                std::cout << "  " << std::left << std::setw(24) << rows[i].first << std::right << std::setw(12)
+                    << formatBytes(rows[i].second) << "\n";
+                total += rows[i].second;
+            }
+            std::cout << "  " << std::left << std::setw(24) << "Total" << std::right << std::setw(12)
+                << formatBytes(total) << "\n";
+        }
+
+        // Shapes found by a hit test, as (z-order position, description)
+        void showShapeList(const std::vector<std::pair<size_t, std::string>>& shapes) const {
+            for (size_t i = 0; i < shapes.size(); ++i) {
+                std::cout << "  [" << shapes[i].first << "] " << shapes[i].second << "\n";
+            }
+        }
+
         void showPresentation(const std::string& title,
             const std::vector<std::pair<std::string, std::vector<std::string>>>& slides) const {
             std::cout << "\n=== Presentation: " << title << " ===\n";
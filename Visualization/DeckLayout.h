@@ -0,0 +1,130 @@
+#pragma once
+#include "../Model/BoundingBox.h"
+#include "../Model/Presentation.h"
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace Visualization {
+
+    // Where each slide of a range goes on the page: the layout pass of
+    // rendering. The slides are stacked under the presentation title; a slide
+    // with shapes gets a full frame, an empty one only a placeholder line.
+    //
+    // Slide tops are kept as a prefix sum over the range, so computing the
+    // layout of slides [k, k+m) costs O(m) and any frame is O(1) to look up.
+    class DeckLayout {
+    public:
+        static const int kPageWidth = 800;
+        static const int kMargin = 60;
+        static const int kFirstSlideTop = 90;
+        static const int kSlideTitleHeight = 30;
+        static const int kFrameHeight = 200;
+        static const int kPlaceholderHeight = 30;
+        static const int kSlideSpacing = 20;
+        static const int kFramePadding = 20;
+
+        // Coordinates are ints; a range whose slides would reach past this
+        // is refused rather than wrapped. Half the range leaves painters room
+        // for margins.
+        static const int kMaxCanvasHeight = INT_MAX / 2;
+        static const int kMaxSlideHeight = kSlideTitleHeight + kFrameHeight + kSlideSpacing;
+
+        // Placement of one slide
+        struct SlideFrame {
+            size_t slideIndex;
+            int titleY;
+            Model::BoundingBox frame;
+            Model::BoundingBox content;
+            bool empty;
+            bool first;
+        };
+
+    private:
+        const Model::Presentation* presentation_;
+        size_t startSlide_;
+        size_t endSlide_;
+        std::vector<int> tops_;
+        std::vector<bool> empty_;
+
+        DeckLayout(const Model::Presentation& presentation, size_t startSlide, size_t endSlide)
+            : presentation_(&presentation), startSlide_(startSlide), endSlide_(endSlide) {
+        }
+
+    public:
+        static DeckLayout compute(const Model::Presentation& presentation, size_t startSlide, size_t endSlide) {
+            if (startSlide > endSlide || endSlide > presentation.slideCount()) {
+                throw std::out_of_range("Slide range out of range");
+            }
+
+            DeckLayout layout(presentation, startSlide, endSlide);
+            layout.tops_.reserve(endSlide - startSlide + 1);
+            layout.empty_.reserve(endSlide - startSlide);
+            int top = kFirstSlideTop;
+            presentation.forEachSlide(startSlide, endSlide, [&layout, &top](const Model::Slide& slide) {
+                if (top > kMaxCanvasHeight - kMaxSlideHeight) {
+                    throw std::length_error("Too many slides to lay out on one page");
+                }
+                layout.tops_.push_back(top);
+                bool empty = slide.getShapes().empty();
+                layout.empty_.push_back(empty);
+                top += kSlideTitleHeight + (empty ? kPlaceholderHeight : kFrameHeight) + kSlideSpacing;
+            });
+            layout.tops_.push_back(top);
+            return layout;
+        }
+
+        static DeckLayout compute(const Model::Presentation& presentation) {
+            return compute(presentation, 0, presentation.slideCount());
+        }
+
+        const Model::Presentation& presentation() const { return *presentation_; }
+        size_t startSlide() const { return startSlide_; }
+        size_t endSlide() const { return endSlide_; }
+        size_t slideCount() const { return endSlide_ - startSlide_; }
+
+        bool contains(size_t slideIndex) const {
+            return slideIndex >= startSlide_ && slideIndex < endSlide_;
+        }
+
+        SlideFrame frame(size_t slideIndex) const {
+            if (!contains(slideIndex)) {
+                throw std::out_of_range("Slide is not part of this layout");
+            }
+
+            int top = tops_[slideIndex - startSlide_];
+            int frameY = top + kSlideTitleHeight;
+            int frameWidth = kPageWidth - 2 * kMargin;
+
+            return SlideFrame{
+                slideIndex,
+                top,
+                Model::BoundingBox(kMargin, frameY, frameWidth, kFrameHeight),
+                Model::BoundingBox(kMargin + kFramePadding, frameY + kFramePadding,
+                    frameWidth - 2 * kFramePadding, kFrameHeight - 2 * kFramePadding),
+                empty_[slideIndex - startSlide_],
+                slideIndex == startSlide_
+            };
+        }
+
+        // Bottom of the last slide, spacing included
+        int contentHeight() const {
+            return tops_.back();
+        }
+
+        int canvasWidth() const {
+            return kPageWidth;
+        }
+
+        // Room for every slide of the range at full height, never less than a
+        // page
+        int canvasHeight() const {
+            std::int64_t height = std::max<std::int64_t>(600, 100 + static_cast<std::int64_t>(slideCount()) * 250);
+            return static_cast<int>(std::min<std::int64_t>(height, kMaxCanvasHeight));
+        }
+    };
+
+}
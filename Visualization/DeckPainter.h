@@ -0,0 +1,95 @@
+#pragma once
+#include "DeckLayout.h"
+#include "../Painting/IPainter.h"
+#include "../Painting/StylePalette.h"
+#include "../Painting/TransformedPainter.h"
+#include <string>
+#include <vector>
+
+namespace Visualization {
+
+    // Paint pass of rendering: draws the page header and any run of slides
+    // of a DeckLayout onto any painter. Slides are independent of each other,
+    // so runs may be painted separately, even concurrently, and spliced in
+    // slide order.
+    //
+    // Groups of shapes lying wholly off the layout's canvas are skipped,
+    // each in one test of its cached bounds. Callers that draw a layout
+    // show at most its canvas, so nothing visible is lost; the margin
+    // allows for strokes and labels reaching past a shape's bounds.
+    class DeckPainter {
+    public:
+        static const int kCullMargin = 50;
+
+    private:
+        Painting::TextStyleHandle titleStyle_;
+        Painting::TextStyleHandle slideTitleStyle_;
+        Painting::TextStyleHandle placeholderStyle_;
+        Painting::PenHandle titleSeparatorPen_;
+        Painting::PenHandle separatorPen_;
+        Painting::PenHandle bgPen_;
+        Painting::BrushHandle bgBrush_;
+
+    public:
+        // Interns the page furniture styles once, before any painting starts
+        DeckPainter() {
+            auto& palette = Painting::StylePalette::getInstance();
+            titleStyle_ = palette.internTextStyle("Arial", 24, "black", Painting::TextAnchor::START);
+            slideTitleStyle_ = palette.internTextStyle("Arial", 18, "blue", Painting::TextAnchor::START);
+            placeholderStyle_ = palette.internTextStyle("Arial", 12, "gray", Painting::TextAnchor::START);
+            titleSeparatorPen_ = palette.internPen(Painting::Pen("gray", 2, Painting::Pen::Type::SOLID));
+            separatorPen_ = palette.internPen(Painting::Pen("lightgray", 1, Painting::Pen::Type::DASHED));
+            bgPen_ = palette.internPen(Painting::Pen("lightgray", 1, Painting::Pen::Type::SOLID));
+            bgBrush_ = palette.internBrush(Painting::Brush("white", Painting::Brush::Style::SOLID));
+        }
+
+        void paintHeader(Painting::IPainter& painter, const DeckLayout& layout) const {
+            const int right = layout.canvasWidth() - DeckLayout::kMargin;
+            painter.drawText(DeckLayout::kMargin, 40, layout.presentation().title(), titleStyle_);
+            painter.drawLine(DeckLayout::kMargin, 60, right, 60, titleSeparatorPen_);
+        }
+
+        void paintSlide(Painting::IPainter& painter, const DeckLayout& layout, size_t slideIndex) const {
+            const DeckLayout::SlideFrame frame = layout.frame(slideIndex);
+            const int right = layout.canvasWidth() - DeckLayout::kMargin;
+
+            if (!frame.first) {
+                int separatorY = frame.titleY - DeckLayout::kSlideSpacing / 2;
+                painter.drawLine(DeckLayout::kMargin, separatorY, right, separatorY, separatorPen_);
+            }
+
+            std::string slideTitle = "Slide " + std::to_string(static_cast<long long>(slideIndex));
+            painter.drawText(DeckLayout::kMargin, frame.titleY, slideTitle, slideTitleStyle_);
+
+            const Model::BoundingBox& box = frame.frame;
+            int bgXPoints[4] = { box.getX(), box.getRight(), box.getRight(), box.getX() };
+            int bgYPoints[4] = { box.getY(), box.getY(), box.getBottom(), box.getBottom() };
+            painter.drawPolygon(bgXPoints, bgYPoints, 4, bgPen_, bgBrush_);
+
+            if (frame.empty) {
+                painter.drawText(frame.content.getX(), box.getCenterY(), "(No shapes on this slide)", placeholderStyle_);
+                return;
+            }
+
+            const Model::Slide* slide = layout.presentation().getSlide(slideIndex);
+            Painting::TransformedPainter transformedPainter(painter, frame.content.getX(), frame.content.getY());
+            const Model::BoundingBox viewport(-frame.content.getX() - kCullMargin, -frame.content.getY() - kCullMargin,
+                layout.canvasWidth() + 2 * kCullMargin, layout.canvasHeight() + 2 * kCullMargin);
+            slide->drawShapes(transformedPainter, viewport);
+        }
+
+        // Slides [startSlide, endSlide) of the layout; O(endSlide - startSlide)
+        void paintSlides(Painting::IPainter& painter, const DeckLayout& layout, size_t startSlide, size_t endSlide) const {
+            for (size_t i = startSlide; i < endSlide; ++i) {
+                paintSlide(painter, layout, i);
+            }
+        }
+
+        // Header and every slide of the layout
+        void paint(Painting::IPainter& painter, const DeckLayout& layout) const {
+            paintHeader(painter, layout);
+            paintSlides(painter, layout, layout.startSlide(), layout.endSlide());
+        }
+    };
+
+}
@@ -1,11 +1,8 @@
 #pragma once
 #include "IVisualization.h"
+#include "DeckLayout.h"
+#include "DeckPainter.h"
 #include "../Painting/SVGCanvas.h"
-#include "../Painting/IPainter.h"
-#include "../Painting/SVGPainter.h"
-#include "../Painting/Pen.h"
-#include "../Painting/Brush.h"
-#include "../Painting/TransformedPainter.h"
 #include <sstream>
 
 namespace Visualization {
@@ -17,75 +14,11 @@ namespace Visualization {
                 return generateEmptySvg();
             }
 
-            int slideHeight = 250;
-            int spacing = 20;
-            int titleHeight = 80;
-            int canvasHeight = titleHeight + static_cast<int>(presentation.slideCount() * (slideHeight + spacing));
-            if (canvasHeight < 600) canvasHeight = 600;
-            int canvasWidth = 800;
-
-            Painting::SVGCanvas canvas(canvasWidth, canvasHeight);
-            Painting::SVGPainter& painter = canvas.getPainter();
+            const DeckLayout layout = DeckLayout::compute(presentation);
+            Painting::SVGCanvas canvas(layout.canvasWidth(), layout.canvasHeight());
 
             canvas.beginDrawing();
-
-            const int leftMargin = 60;
-
-            painter.drawTextLeft(leftMargin, 40, presentation.title(), "Arial", 24, "black");
-
-            Painting::Pen titleSeparatorPen("gray", 2, Painting::Pen::Type::SOLID);
-            painter.drawLine(leftMargin, 60, canvasWidth - leftMargin, 60, titleSeparatorPen);
-
-            int yOffset = titleHeight + 10;
-            for (size_t i = 0; i < presentation.slideCount(); ++i) {
-                const Model::Slide* slide = presentation.getSlide(i);
-
-                if (i > 0) {
-                    Painting::Pen separatorPen("lightgray", 1, Painting::Pen::Type::DASHED);
-                    painter.drawLine(leftMargin, yOffset - spacing / 2, canvasWidth - leftMargin, yOffset - spacing / 2, separatorPen);
-                }
-
-                    std::string slideTitle = "Slide " + std::to_string(static_cast<long long>(i));
-                    painter.drawTextLeft(leftMargin, yOffset, slideTitle, "Arial", 18, "blue");
-                yOffset += 30;
-
-                int slideX = leftMargin;
-                int slideY = yOffset;
-                int slideWidth = canvasWidth - 2 * leftMargin;
-                int slideHeightArea = slideHeight - 30;
-                Painting::Pen bgPen("lightgray", 1, Painting::Pen::Type::SOLID);
-                Painting::Brush bgBrush("white", Painting::Brush::Style::SOLID);
-                int bgXPoints[4] = { slideX, slideX + slideWidth, slideX + slideWidth, slideX };
-                int bgYPoints[4] = { slideY, slideY, slideY + slideHeightArea, slideY + slideHeightArea };
-                painter.drawPolygon(bgXPoints, bgYPoints, 4, bgPen, bgBrush);
-
-                int padding = 20;
-                int contentX = slideX + padding;
-                int contentY = slideY + padding;
-                int contentWidth = slideWidth - 2 * padding;
-                int contentHeight = slideHeightArea - 2 * padding;
-
-                const auto& shapes = slide->getShapes();
-                if (shapes.empty()) {
-
-                    painter.drawTextLeft(
-                        slideX + padding, slideY + slideHeightArea / 2,
-                        "(No shapes on this slide)", "Arial", 12, "gray");
-                }
-                else {
-
-                    Painting::TransformedPainter transformedPainter(painter, contentX, contentY);
-
-                    for (const auto& shape : shapes) {
-                        if (shape) {
-                            shape->draw(transformedPainter);
-                        }
-                    }
-                }
-
-                yOffset += slideHeight;
-            }
-
+            DeckPainter().paint(canvas.getPainter(), layout);
             canvas.endDrawing();
 
             return canvas.getOutput();
@@ -0,0 +1,92 @@
+#pragma once
+#include "DeckLayout.h"
+#include "DeckPainter.h"
+#include "../Model/Presentation.h"
+#include "../Painting/IPainter.h"
+#include "../Painting/ScalingPainter.h"
+#include "../Painting/StylePalette.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace Visualization {
+
+    // Contact sheet of every slide's frame, scaled down and laid out in a
+    // grid of a fixed number of columns. Cell positions follow from the slide
+    // index alone, and shapes are drawn through a ScalingPainter so small
+    // detail falls back to cheap stand-ins. Groups wholly off the sheet are
+    // skipped as in DeckPainter.
+    class ThumbnailSheet {
+    public:
+        static const int kGap = 10;
+        static const int kCaptionHeight = 14;
+
+    private:
+        const Model::Presentation& presentation_;
+        size_t columns_;
+        double scale_;
+        int cellWidth_;
+        int cellHeight_;
+
+    public:
+        ThumbnailSheet(const Model::Presentation& presentation, size_t columns, double scale)
+            : presentation_(presentation), columns_(std::max<size_t>(1, columns)), scale_(scale) {
+            const int frameWidth = DeckLayout::kPageWidth - 2 * DeckLayout::kMargin;
+            cellWidth_ = std::max(1, static_cast<int>(std::lround(frameWidth * scale_)));
+            cellHeight_ = std::max(1, static_cast<int>(std::lround(DeckLayout::kFrameHeight * scale_)));
+        }
+
+        size_t rows() const {
+            return (presentation_.slideCount() + columns_ - 1) / columns_;
+        }
+
+        int canvasWidth() const {
+            size_t columns = std::min(columns_, std::max<size_t>(1, presentation_.slideCount()));
+            return kGap + static_cast<int>(columns) * (cellWidth_ + kGap);
+        }
+
+        int canvasHeight() const {
+            return kGap + static_cast<int>(rows()) * (cellHeight_ + kCaptionHeight + kGap);
+        }
+
+        // Top-left corner of the frame of a slide's cell
+        int cellX(size_t slideIndex) const {
+            return kGap + static_cast<int>(slideIndex % columns_) * (cellWidth_ + kGap);
+        }
+
+        int cellY(size_t slideIndex) const {
+            return kGap + static_cast<int>(slideIndex / columns_) * (cellHeight_ + kCaptionHeight + kGap);
+        }
+
+        void paint(Painting::IPainter& painter) const {
+            auto& palette = Painting::StylePalette::getInstance();
+            Painting::PenHandle framePen = palette.internPen(Painting::Pen("lightgray", 1, Painting::Pen::Type::SOLID));
+            Painting::BrushHandle frameBrush = palette.internBrush(Painting::Brush("white", Painting::Brush::Style::SOLID));
+            Painting::TextStyleHandle captionStyle = palette.internTextStyle("Arial", 10, "gray", Painting::TextAnchor::START);
+
+            Painting::ScalingPainter scaled(painter, scale_);
+            const int padding = static_cast<int>(std::lround(DeckLayout::kFramePadding * scale_));
+
+            for (size_t i = 0; i < presentation_.slideCount(); ++i) {
+                int x = cellX(i);
+                int y = cellY(i);
+                int xs[4] = { x, x + cellWidth_, x + cellWidth_, x };
+                int ys[4] = { y, y, y + cellHeight_, y + cellHeight_ };
+                painter.drawPolygon(xs, ys, 4, framePen, frameBrush);
+                painter.drawText(x, y + cellHeight_ + kCaptionHeight / 2 + 1,
+                    std::to_string(static_cast<long long>(i)), captionStyle);
+
+                scaled.setOffset(x + padding, y + padding);
+                const int margin = DeckPainter::kCullMargin;
+                const Model::BoundingBox viewport(
+                    static_cast<int>(std::floor(-(x + padding) / scale_)) - margin,
+                    static_cast<int>(std::floor(-(y + padding) / scale_)) - margin,
+                    static_cast<int>(std::ceil(canvasWidth() / scale_)) + 2 * margin,
+                    static_cast<int>(std::ceil(canvasHeight() / scale_)) + 2 * margin);
+                presentation_.getSlide(i)->drawShapes(scaled, viewport);
+            }
+        }
+    };
+
+}